@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace common
+{
+/**
+ * The name of an attribute key. An SDK may give the key an id when it first
+ * sees it, and cache data for it in the key.
+ */
+class AttributeKeyBase
+{
+public:
+  AttributeKeyBase(const AttributeKeyBase &) = delete;
+  AttributeKeyBase &operator=(const AttributeKeyBase &) = delete;
+
+  nostd::string_view name() const noexcept { return name_; }
+
+  /**
+   * A pointer an SDK may set once to data it keeps for the key. Several SDKs
+   * may be loaded in a process, so an SDK must check that the data it reads
+   * is its own. The API never reads it.
+   */
+  std::atomic<const void *> &sdk_data() const noexcept { return sdk_data_; }
+
+protected:
+  explicit AttributeKeyBase(nostd::string_view name) noexcept : name_(name) {}
+
+private:
+  nostd::string_view name_;
+  mutable std::atomic<const void *> sdk_data_{nullptr};
+};
+
+/**
+ * An attribute key whose values have the type T. Setting an attribute through
+ * such a key lets the SDK record it by an id it gave the key, without hashing
+ * or copying the name on every call.
+ *
+ * Keys are meant to be constants with static storage duration, such as
+ *
+ *   static const AttributeKey<int64_t> kHttpStatusCode{"http.status_code"};
+ *
+ * The name isn't copied, so it must outlive the key, and the key must outlive
+ * the spans it is set on.
+ */
+template <class T>
+class AttributeKey final : public AttributeKeyBase
+{
+  static_assert(std::is_same<T, bool>::value || std::is_same<T, int64_t>::value ||
+                    std::is_same<T, uint64_t>::value || std::is_same<T, double>::value ||
+                    std::is_same<T, nostd::string_view>::value,
+                "attribute keys hold a bool, int64_t, uint64_t, double or nostd::string_view");
+
+public:
+  using value_type = T;
+
+  explicit AttributeKey(nostd::string_view name) noexcept : AttributeKeyBase(name) {}
+};
+}  // namespace common
+OPENTELEMETRY_END_NAMESPACE
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
 #include "opentelemetry/context/context_value.h"
 #include "opentelemetry/nostd/shared_ptr.h"
 #include "opentelemetry/nostd/string_view.h"
@@ -7,161 +12,407 @@
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace context
 {
+class RuntimeContext;
+
+// A key for context values. Keys compare by name, so keys created in different
+// libraries refer to the same entries. Names up to kInlineSize bytes are stored
+// inline and don't allocate.
+class ContextKey
+{
+public:
+  // The length of the longest name that is stored inline
+  static constexpr size_t kInlineSize = 23;
+
+  explicit ContextKey(nostd::string_view name) noexcept { Assign(name); }
+
+  ContextKey(const ContextKey &other) noexcept { Assign(other.name()); }
+
+  ContextKey(ContextKey &&other) noexcept : size_(other.size_)
+  {
+    if (size_ <= kInlineSize)
+    {
+      memcpy(inline_name_, other.inline_name_, size_);
+    }
+    else
+    {
+      heap_name_  = other.heap_name_;
+      other.size_ = 0;
+    }
+  }
+
+  ContextKey &operator=(const ContextKey &other) noexcept
+  {
+    if (this != &other)
+    {
+      Release();
+      Assign(other.name());
+    }
+    return *this;
+  }
+
+  ~ContextKey() noexcept { Release(); }
+
+  nostd::string_view name() const noexcept
+  {
+    return nostd::string_view(size_ <= kInlineSize ? inline_name_ : heap_name_, size_);
+  }
+
+  bool operator==(const ContextKey &other) const noexcept { return *this == other.name(); }
+
+  bool operator!=(const ContextKey &other) const noexcept { return !(*this == other); }
+
+  bool operator==(nostd::string_view name) const noexcept
+  {
+    return size_ == name.size() && memcmp(this->name().data(), name.data(), size_) == 0;
+  }
+
+private:
+  void Assign(nostd::string_view name) noexcept
+  {
+    size_      = name.size();
+    char *data = size_ <= kInlineSize ? inline_name_ : (heap_name_ = new char[size_]);
+    memcpy(data, name.data(), size_);
+  }
+
+  void Release() noexcept
+  {
+    if (size_ > kInlineSize)
+    {
+      delete[] heap_name_;
+    }
+  }
+
+  size_t size_;
+
+  union
+  {
+    char inline_name_[kInlineSize];
+    char *heap_name_;
+  };
+};
+
+// A slot for a value that is read on hot paths, such as the active span's
+// context. Every context has room for a fixed number of slots, so reading a
+// slot is an indexed load rather than a search of the entries. Slots hold a
+// copy of a small, trivially copyable value, so the value stays valid for as
+// long as any context holding it; code that registers a slot is expected to
+// provide typed accessors for it. Slots should be registered once and kept,
+// typically in a function-local static.
+class ContextSlot
+{
+public:
+  // The number of slots every context has room for
+  static constexpr size_t kMaxSlots = 4;
+
+  // The size of the largest value a slot can hold
+  static constexpr size_t kMaxValueSize = 32;
+
+  // Registers a new slot. Once all slots are in use, an invalid slot is
+  // returned; setting its value has no effect and it never holds a value.
+  static ContextSlot Register() noexcept
+  {
+    static std::atomic<size_t> next_index{0};
+    size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return ContextSlot(index < kMaxSlots ? index : kMaxSlots);
+  }
+
+  bool IsValid() const noexcept { return index_ < kMaxSlots; }
+
+private:
+  friend class Context;
+
+  explicit ContextSlot(size_t index) noexcept : index_(index) {}
+
+  size_t index_;
+};
 
-// The context class provides a context identifier. Is built as a linked list
-// of DataList nodes and each context holds a shared_ptr to a place within
-// the list that determines which keys and values it has access to. All that
-// come before and none that come after.
+// The context class provides a context identifier. It is immutable: setting a
+// value returns a new context and leaves the original unchanged.
+//
+// The most recently set entries are stored inline, so creating, copying and
+// reading small contexts doesn't allocate. Once the inline storage is full,
+// setting another value moves the current entries into a shared, immutable
+// parent context that the new context refers to. Lookups check the inline
+// entries first and then the chain of parents.
+//
+// Besides keyed entries, a context has a fixed number of slots; see
+// ContextSlot.
+//
+// Copies of a context compare equal; separately created contexts don't, even
+// if they hold the same values.
 class Context
 {
 
 public:
-  Context() = default;
-  // Creates a context object from a map of keys and identifiers, this will
-  // hold a shared_ptr to the head of the DataList linked list
+  // The number of entries stored inline
+  static constexpr size_t kInlineEntries = 4;
+
+  Context() noexcept {}
+
+  Context(const Context &other) noexcept : parent_(other.parent_), id_(other.id_)
+  {
+    CopyEntries(other);
+    CopySlots(other);
+  }
+
+  Context(Context &&other) noexcept : parent_(std::move(other.parent_)), id_(other.id_)
+  {
+    CopySlots(other);
+    MoveEntries(other);
+  }
+
+  Context &operator=(const Context &other) noexcept
+  {
+    if (this != &other)
+    {
+      Truncate(0);
+      CopyEntries(other);
+      CopySlots(other);
+      parent_ = other.parent_;
+      id_     = other.id_;
+    }
+    return *this;
+  }
+
+  Context &operator=(Context &&other) noexcept
+  {
+    if (this != &other)
+    {
+      Truncate(0);
+      CopySlots(other);
+      MoveEntries(other);
+      parent_ = std::move(other.parent_);
+      id_     = other.id_;
+    }
+    return *this;
+  }
+
+  ~Context() noexcept { Truncate(0); }
+
+  // Creates a context object from a map of keys and values
   template <class T>
   Context(const T &keys_and_values)
   {
-    head_ = nostd::shared_ptr<DataList>{new DataList(keys_and_values)};
+    for (auto &iter : keys_and_values)
+    {
+      Set(iter.first, iter.second);
+    }
+    id_ = NewId();
   }
 
-  // Creates a context object from a key and value, this will
-  // hold a shared_ptr to the head of the DataList linked list
+  // Creates a context object from a key and value
   Context(nostd::string_view key, ContextValue value)
   {
-    head_ = nostd::shared_ptr<DataList>{new DataList(key, value)};
+    Set(key, value);
+    id_ = NewId();
   }
 
   // Accepts a new iterable and then returns a new context that
-  // contains the new key and value data. It attaches the
-  // exisiting list to the end of the new list.
+  // contains the new key and value data in addition to the data of this
+  // context.
   template <class T>
   Context SetValues(T &values) noexcept
   {
-    Context context                   = Context(values);
-    nostd::shared_ptr<DataList> &last = context.head_;
-    while (last->next_ != nullptr)
+    Context context = *this;
+    for (auto &iter : values)
     {
-      last = last->next_;
+      context.Set(iter.first, iter.second);
     }
-    last->next_ = head_;
+    context.id_ = NewId();
     return context;
   }
 
-  // Accepts a new iterable and then returns a new context that
-  // contains the new key and value data. It attaches the
-  // exisiting list to the end of the new list.
+  // Returns a new context that contains the new key and value data in
+  // addition to the data of this context.
   Context SetValue(nostd::string_view key, ContextValue value) noexcept
   {
-    Context context      = Context(key, value);
-    context.head_->next_ = head_;
+    Context context = *this;
+    context.Set(key, value);
+    context.id_ = NewId();
     return context;
   }
 
-  // Returns the value associated with the passed in key.
-  context::ContextValue GetValue(const nostd::string_view key) noexcept
+  // Returns a new context that contains the new key and value data in
+  // addition to the data of this context.
+  Context SetValue(const ContextKey &key, ContextValue value) noexcept
   {
-    for (DataList *data = head_.get(); data != nullptr; data = data->next_.get())
+    return SetValue(key.name(), value);
+  }
+
+  // Returns a new context in which the slot holds a copy of the passed in
+  // value, in addition to the data of this context. The value must be
+  // trivially copyable and at most ContextSlot::kMaxValueSize bytes.
+  Context SetSlotValue(const ContextSlot &slot, const void *value, size_t size) noexcept
+  {
+    Context context = *this;
+    if (slot.IsValid() && size <= ContextSlot::kMaxValueSize)
     {
-      if (key.size() == data->key_length_)
-      {
-        if (memcmp(key.data(), data->key_, data->key_length_) == 0)
-        {
-          return data->value_;
-        }
-      }
+      memcpy(context.slots_[slot.index_], value, size);
+      context.slots_set_ |= 1u << slot.index_;
     }
-    return (int64_t)0;
+    context.id_ = NewId();
+    return context;
   }
 
-  // Checks for key and returns true if found
-  bool HasKey(const nostd::string_view key) noexcept
+  // Copies the value held by the slot to the passed in buffer. Returns false
+  // and leaves the buffer unchanged if the slot was not set.
+  bool GetSlotValue(const ContextSlot &slot, void *value, size_t size) const noexcept
   {
-    for (DataList *data = head_.get(); data != nullptr; data = data->next_.get())
+    if (!slot.IsValid() || (slots_set_ & (1u << slot.index_)) == 0 ||
+        size > ContextSlot::kMaxValueSize)
     {
-      if (key.size() == data->key_length_)
-      {
-        if (memcmp(key.data(), data->key_, data->key_length_) == 0)
-        {
-          return true;
-        }
-      }
+      return false;
     }
-    return false;
+    memcpy(value, slots_[slot.index_], size);
+    return true;
   }
 
-  bool operator==(const Context &other) { return (head_ == other.head_); }
+  // Returns the value associated with the passed in key.
+  context::ContextValue GetValue(const nostd::string_view key) const noexcept
+  {
+    const Entry *entry = Find(key);
+    return entry != nullptr ? entry->value_ : ContextValue((int64_t)0);
+  }
 
-private:
-  // A linked list to contain the keys and values of this context node
-  class DataList
+  // Returns the value associated with the passed in key.
+  context::ContextValue GetValue(const ContextKey &key) const noexcept
   {
-  public:
-    nostd::shared_ptr<DataList> next_;
+    return GetValue(key.name());
+  }
+
+  // Checks for key and returns true if found
+  bool HasKey(const nostd::string_view key) const noexcept { return Find(key) != nullptr; }
+
+  // Checks for key and returns true if found
+  bool HasKey(const ContextKey &key) const noexcept { return Find(key.name()) != nullptr; }
+
+  bool operator==(const Context &other) const noexcept { return id_ == other.id_; }
 
-    char *key_;
+private:
+  friend class RuntimeContext;
+
+  struct Entry
+  {
+    Entry(nostd::string_view key, const ContextValue &value) : key_(key), value_(value) {}
 
-    size_t key_length_;
+    ContextKey key_;
 
     ContextValue value_;
+  };
+
+  Entry *entries() noexcept { return reinterpret_cast<Entry *>(storage_); }
 
-    DataList() { next_ = nullptr; }
+  const Entry *entries() const noexcept { return reinterpret_cast<const Entry *>(storage_); }
 
-    // Builds a data list off of a key and value iterable and returns the head
-    template <class T>
-    DataList(const T &keys_and_vals) : key_{nullptr}
+  // Returns a new identity. Identities are handed out to each thread in blocks
+  // so that creating a context doesn't touch shared state.
+  static uint64_t NewId() noexcept
+  {
+    static const uint64_t kBlockSize = 1 << 16;
+    static std::atomic<uint64_t> next_block{1};
+    static thread_local uint64_t next = 0;
+    static thread_local uint64_t end  = 0;
+    if (next == end)
     {
-      bool first = true;
-      auto *node = this;
-      for (auto &iter : keys_and_vals)
-      {
-        if (first)
-        {
-          *node = DataList(iter.first, iter.second);
-          first = false;
-        }
-        else
-        {
-          node->next_ = nostd::shared_ptr<DataList>(new DataList(iter.first, iter.second));
-          node        = node->next_.get();
-        }
-      }
+      next = next_block.fetch_add(1, std::memory_order_relaxed) * kBlockSize;
+      end  = next + kBlockSize;
     }
+    return next++;
+  }
 
-    // Builds a data list with just a key and value, so it will just be the head
-    // and returns that head.
-    DataList(nostd::string_view key, ContextValue value)
+  // Copies the entries of another context into empty storage.
+  void CopyEntries(const Context &other) noexcept
+  {
+    for (size_t i = 0; i < other.size_; ++i)
     {
-      key_        = new char[key.size()];
-      key_length_ = key.size();
-      memcpy(key_, key.data(), key.size() * sizeof(char));
-      value_ = value;
-      next_  = nostd::shared_ptr<DataList>{nullptr};
+      new (entries() + i) Entry(other.entries()[i]);
     }
+    size_ = other.size_;
+  }
+
+  void CopySlots(const Context &other) noexcept
+  {
+    memcpy(slots_, other.slots_, sizeof(slots_));
+    slots_set_ = other.slots_set_;
+  }
 
-    DataList &operator=(DataList &&other)
+  // Moves the entries of another context into empty storage, leaving the
+  // other context empty.
+  void MoveEntries(Context &other) noexcept
+  {
+    for (size_t i = 0; i < other.size_; ++i)
     {
-      key_length_ = other.key_length_;
-      value_      = std::move(other.value_);
-      next_       = std::move(other.next_);
+      new (entries() + i) Entry(std::move(other.entries()[i]));
+    }
+    size_ = other.size_;
+    other.Truncate(0);
+    other.id_ = 0;
+  }
 
-      key_       = other.key_;
-      other.key_ = nullptr;
+  // Destroys the entries from the given size on.
+  void Truncate(size_t size) noexcept
+  {
+    for (size_t i = size; i < size_; ++i)
+    {
+      entries()[i].~Entry();
+    }
+    size_ = size;
+  }
 
-      return *this;
+  // Sets a value in place. Must only be called on a context that has not been
+  // shared yet.
+  void Set(nostd::string_view key, const ContextValue &value) noexcept
+  {
+    for (size_t i = 0; i < size_; ++i)
+    {
+      if (entries()[i].key_ == key)
+      {
+        entries()[i].value_ = value;
+        return;
+      }
     }
+    if (size_ == kInlineEntries)
+    {
+      Context *parent = new Context;
+      parent->parent_ = std::move(parent_);
+      parent->MoveEntries(*this);
+      parent_ = nostd::shared_ptr<const Context>(parent);
+    }
+    new (entries() + size_) Entry(key, value);
+    ++size_;
+  }
 
-    ~DataList()
+  const Entry *Find(nostd::string_view key) const noexcept
+  {
+    for (const Context *context = this; context != nullptr; context = context->parent_.get())
     {
-      if (key_ != nullptr)
+      for (size_t i = context->size_; i > 0; --i)
       {
-        delete[] key_;
+        if (context->entries()[i - 1].key_ == key)
+        {
+          return &context->entries()[i - 1];
+        }
       }
     }
-  };
+    return nullptr;
+  }
+
+  // The most recently set entries
+  std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage_[kInlineEntries];
+
+  size_t size_ = 0;
+
+  // The entries that did not fit inline
+  nostd::shared_ptr<const Context> parent_;
+
+  alignas(8) unsigned char slots_[ContextSlot::kMaxSlots][ContextSlot::kMaxValueSize];
+
+  // A bit for each slot that holds a value
+  uint8_t slots_set_ = 0;
 
-  // Head of the list which holds the keys and values of this context
-  nostd::shared_ptr<DataList> head_;
+  // The identity of this context, shared by its copies. Empty contexts have
+  // identity 0.
+  uint64_t id_ = 0;
 };
 }  // namespace context
 OPENTELEMETRY_END_NAMESPACE
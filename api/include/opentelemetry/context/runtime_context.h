@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include "opentelemetry/context/context.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -8,42 +10,80 @@ namespace context
 // Provides a wrapper for propagating the context object globally. In order
 // to use either the threadlocal_context.h file must be included or another
 // implementation which must be derived from the RuntimeContext can be
-// provided.
+// provided. The SDK includes threadlocal_context.h, so applications that link
+// the SDK must not include it again.
 class RuntimeContext
 {
 public:
+  // A token refers to an attached context and detaches it when it is
+  // destroyed, unless it was detached before. Tokens can be moved but not
+  // copied, so that a context is detached at most once.
   class Token
   {
   public:
-    bool operator==(const Context &other) noexcept { return context_ == other; }
+    bool operator==(const Context &other) noexcept { return context_id_ == other.id_; }
+
+    Token(Token &&other) noexcept : context_id_(other.context_id_), is_attached_(other.is_attached_)
+    {
+      other.is_attached_ = false;
+    }
+
+    Token(const Token &) = delete;
 
-    ~Token() noexcept { Detach(*this); }
+    Token &operator=(const Token &) = delete;
+
+    ~Token() noexcept
+    {
+      if (is_attached_)
+      {
+        Detach(*this);
+      }
+    }
 
   private:
     friend class RuntimeContext;
 
-    // A constructor that sets the token's Context object to the
-    // one that was passed in.
-    Token(Context context) noexcept : context_(context){};
+    // A constructor that sets the token to refer to the Context object that
+    // was passed in. Only the identity of the context is kept, so creating a
+    // token doesn't copy the values of the context.
+    Token(const Context &context) noexcept : context_id_(context.id_){};
 
     Token() noexcept = default;
 
-    Context context_;
+    uint64_t context_id_ = 0;
+
+    bool is_attached_ = true;
   };
 
   // Return the current context.
   static Context GetCurrent() noexcept { return context_handler_->InternalGetCurrent(); }
 
+  // Copies the value of a slot in the current context to the passed in
+  // buffer. Unlike GetCurrent().GetSlotValue(...), this doesn't copy the
+  // current context.
+  static bool GetCurrentSlotValue(const ContextSlot &slot, void *value, size_t size) noexcept
+  {
+    return context_handler_->InternalGetCurrentSlotValue(slot, value, size);
+  }
+
   // Sets the current 'Context' object. Returns a token
   // that can be used to reset to the previous Context.
   static Token Attach(Context context) noexcept
   {
-    return context_handler_->InternalAttach(context);
+    return context_handler_->InternalAttach(std::move(context));
   }
 
   // Resets the context to a previous value stored in the
   // passed in token. Returns true if successful, false otherwise
-  static bool Detach(Token &token) noexcept { return context_handler_->InternalDetach(token); }
+  static bool Detach(Token &token) noexcept
+  {
+    if (!token.is_attached_ || !context_handler_->InternalDetach(token))
+    {
+      return false;
+    }
+    token.is_attached_ = false;
+    return true;
+  }
 
   static RuntimeContext *context_handler_;
 
@@ -89,10 +129,19 @@ class RuntimeContext
 
 protected:
   // Provides a token with the passed in context
-  Token CreateToken(Context context) noexcept { return Token(context); }
+  Token CreateToken(const Context &context) noexcept { return Token(context); }
 
   virtual Context InternalGetCurrent() noexcept = 0;
 
+  // Implementations that can read the current context in place should
+  // override this to avoid the copy.
+  virtual bool InternalGetCurrentSlotValue(const ContextSlot &slot,
+                                           void *value,
+                                           size_t size) noexcept
+  {
+    return InternalGetCurrent().GetSlotValue(slot, value, size);
+  }
+
   virtual Token InternalAttach(Context context) noexcept = 0;
 
   virtual bool InternalDetach(Token &token) noexcept = 0;
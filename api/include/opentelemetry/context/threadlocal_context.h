@@ -1,5 +1,9 @@
 #pragma once
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
 #include "opentelemetry/context/context.h"
 #include "opentelemetry/context/runtime_context.h"
 
@@ -19,6 +23,14 @@ class ThreadLocalContext : public RuntimeContext
   // Return the current context.
   Context InternalGetCurrent() noexcept override { return stack_.Top(); }
 
+  // Returns the value of a slot in the current context, without copying it.
+  bool InternalGetCurrentSlotValue(const ContextSlot &slot,
+                                   void *value,
+                                   size_t size) noexcept override
+  {
+    return stack_.Top().GetSlotValue(slot, value, size);
+  }
+
   // Resets the context to a previous value stored in the
   // passed in token. Returns true if successful, false otherwise
   bool InternalDetach(Token &token) noexcept override
@@ -35,80 +47,106 @@ class ThreadLocalContext : public RuntimeContext
   // that can be used to reset to the previous Context.
   Token InternalAttach(Context context) noexcept override
   {
-    stack_.Push(context);
-    Token old_context = CreateToken(context);
-    return old_context;
+    Token token = CreateToken(context);
+    stack_.Push(std::move(context));
+    return token;
   }
 
 private:
-  // A nested class to store the attached contexts in a stack.
+  // A nested class to store the attached contexts in a stack. The contexts of
+  // typical nesting depths are stored inline; deeper stacks move to the heap,
+  // doubling their capacity as needed. Contexts are moved in and destroyed in
+  // place, so pushing and popping don't touch their reference counts.
   class Stack
   {
     friend class ThreadLocalContext;
 
-    Stack() noexcept : size_(0), capacity_(0), base_(nullptr){};
+    // The number of contexts stored inline
+    static constexpr size_t kInlineCapacity = 8;
 
-    // Pops the top Context off the stack and returns it.
-    Context Pop() noexcept
+    Stack() noexcept
+        : size_(0), capacity_(kInlineCapacity), base_(reinterpret_cast<Context *>(inline_)){};
+
+    Stack(const Stack &) = delete;
+
+    Stack &operator=(const Stack &) = delete;
+
+    // Destroys the top Context of the stack.
+    void Pop() noexcept
     {
-      if (size_ <= 0)
+      if (size_ == 0)
       {
-        return Context();
+        return;
       }
-      int index = size_ - 1;
       size_--;
-      return base_[index];
+      base_[size_].~Context();
     }
 
-    // Returns the Context at the top of the stack.
-    Context Top() const noexcept
+    // Returns the Context at the top of the stack, or an empty Context if the
+    // stack is empty.
+    const Context &Top() const noexcept
     {
-      if (size_ <= 0)
+      static const Context empty_context;
+      if (size_ == 0)
       {
-        return Context();
+        return empty_context;
       }
       return base_[size_ - 1];
     }
 
-    // Pushes the passed in context pointer to the top of the stack
-    // and resizes if necessary.
-    void Push(Context context) noexcept
+    // Moves the passed in context to the top of the stack and grows the
+    // storage if necessary.
+    void Push(Context &&context) noexcept
     {
-      size_++;
-      if (size_ > capacity_)
+      if (size_ == capacity_)
       {
-        Resize(size_ * 2);
+        Resize(capacity_ * 2);
       }
-      base_[size_ - 1] = context;
+      new (base_ + size_) Context(std::move(context));
+      size_++;
     }
 
-    // Reallocates the storage array to the pass in new capacity size.
-    void Resize(int new_capacity) noexcept
+    // Moves the contexts to new storage with the passed in capacity.
+    void Resize(size_t new_capacity) noexcept
     {
-      int old_size = size_ - 1;
-      if (new_capacity == 0)
+      Context *temp = static_cast<Context *>(::operator new(new_capacity * sizeof(Context)));
+      for (size_t i = 0; i < size_; ++i)
       {
-        new_capacity = 2;
+        new (temp + i) Context(std::move(base_[i]));
+        base_[i].~Context();
       }
-      Context *temp = new Context[new_capacity];
-      if (base_ != nullptr)
+      Release();
+      base_     = temp;
+      capacity_ = new_capacity;
+    }
+
+    // Frees the storage if it is on the heap.
+    void Release() noexcept
+    {
+      if (base_ != reinterpret_cast<Context *>(inline_))
       {
-        std::copy(base_, base_ + old_size, temp);
-        delete[] base_;
+        ::operator delete(base_);
       }
-      base_ = temp;
     }
 
-    ~Stack() noexcept { delete[] base_; }
+    ~Stack() noexcept
+    {
+      while (size_ > 0)
+      {
+        Pop();
+      }
+      Release();
+    }
 
     size_t size_;
     size_t capacity_;
     Context *base_;
+    std::aligned_storage<sizeof(Context), alignof(Context)>::type inline_[kInlineCapacity];
   };
 
   static thread_local Stack stack_;
 };
-thread_local ThreadLocalContext::Stack ThreadLocalContext::stack_ = ThreadLocalContext::Stack();
+thread_local ThreadLocalContext::Stack ThreadLocalContext::stack_;
 
 // Registers the ThreadLocalContext as the context handler for the RuntimeContext
 RuntimeContext *RuntimeContext::context_handler_ = new ThreadLocalContext();
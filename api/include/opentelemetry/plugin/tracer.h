@@ -48,6 +48,8 @@ class Span final : public trace::Span
 
   bool IsRecording() const noexcept override { return span_->IsRecording(); }
 
+  trace::SpanContext GetContext() const noexcept override { return span_->GetContext(); }
+
   trace::Tracer &tracer() const noexcept override { return *tracer_; }
 
 private:
@@ -22,7 +22,15 @@ namespace trace
 class NoopSpan final : public Span
 {
 public:
-  explicit NoopSpan(const std::shared_ptr<Tracer> &tracer) noexcept : tracer_{tracer} {}
+  explicit NoopSpan(const std::shared_ptr<Tracer> &tracer) noexcept
+      : tracer_{tracer}, span_context_{false, false}
+  {}
+
+  // Creates a span that isn't recorded but still propagates its context to
+  // its children.
+  NoopSpan(const std::shared_ptr<Tracer> &tracer, const SpanContext &span_context) noexcept
+      : tracer_{tracer}, span_context_{span_context}
+  {}
 
   void SetAttribute(nostd::string_view /*key*/,
                     const common::AttributeValue & /*value*/) noexcept override
@@ -46,10 +54,13 @@ class NoopSpan final : public Span
 
   bool IsRecording() const noexcept override { return false; }
 
+  SpanContext GetContext() const noexcept override { return span_context_; }
+
   Tracer &tracer() const noexcept override { return *tracer_; }
 
 private:
   std::shared_ptr<Tracer> tracer_;
+  SpanContext span_context_;
 };
 
 /**
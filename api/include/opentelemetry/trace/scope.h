@@ -0,0 +1,72 @@
+#pragma once
+
+#include <type_traits>
+
+#include "opentelemetry/context/runtime_context.h"
+#include "opentelemetry/trace/span.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace trace
+{
+/**
+ * Controls the active span of the current thread. Creating a scope for a span
+ * makes it the active span, and destroying the scope restores the previously
+ * active span. Scopes must be destroyed in the reverse order of their creation.
+ *
+ * The context of the active span is copied into a slot of the current
+ * context, so looking it up doesn't search the context's entries or copy the
+ * context, and contexts that were copied while the span was active stay valid
+ * after the span is destroyed.
+ */
+class Scope final
+{
+public:
+  explicit Scope(const Span &span) noexcept
+      : token_(context::RuntimeContext::Attach(WithSpanContext(span.GetContext())))
+  {}
+
+  /**
+   * @return the context of the active span of the current thread, or an
+   * invalid context if no span is active
+   */
+  static SpanContext GetCurrentSpanContext() noexcept
+  {
+    SpanContext span_context(false, false);
+    context::RuntimeContext::GetCurrentSlotValue(SpanContextSlot(), &span_context,
+                                                 sizeof(span_context));
+    return span_context;
+  }
+
+  /**
+   * @return the context of the span held by the passed in context, or an
+   * invalid context if it holds none
+   */
+  static SpanContext GetSpanContext(const context::Context &context) noexcept
+  {
+    SpanContext span_context(false, false);
+    context.GetSlotValue(SpanContextSlot(), &span_context, sizeof(span_context));
+    return span_context;
+  }
+
+private:
+  static_assert(std::is_trivially_copyable<SpanContext>::value &&
+                    sizeof(SpanContext) <= context::ContextSlot::kMaxValueSize,
+                "span contexts must fit in a context slot");
+
+  static const context::ContextSlot &SpanContextSlot() noexcept
+  {
+    static const context::ContextSlot slot = context::ContextSlot::Register();
+    return slot;
+  }
+
+  static context::Context WithSpanContext(const SpanContext &span_context) noexcept
+  {
+    return context::RuntimeContext::GetCurrent().SetSlotValue(SpanContextSlot(), &span_context,
+                                                              sizeof(span_context));
+  }
+
+  context::RuntimeContext::Token token_;
+};
+}  // namespace trace
+OPENTELEMETRY_END_NAMESPACE
@@ -2,12 +2,14 @@
 
 #include <cstdint>
 
+#include "opentelemetry/common/attribute_key.h"
 #include "opentelemetry/common/attribute_value.h"
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/span.h"
 #include "opentelemetry/nostd/string_view.h"
 #include "opentelemetry/trace/canonical_code.h"
 #include "opentelemetry/trace/key_value_iterable_view.h"
+#include "opentelemetry/trace/span_context.h"
 #include "opentelemetry/version.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -79,6 +81,24 @@ class Span
   virtual void SetAttribute(nostd::string_view key,
                             const common::AttributeValue &value) noexcept = 0;
 
+  // Sets an attribute on the Span through a registered key. Implementations may
+  // record it by the id of the key, and by default set it by name.
+  virtual void SetAttribute(const common::AttributeKeyBase &key,
+                            const common::AttributeValue &value) noexcept
+  {
+    this->SetAttribute(key.name(), value);
+  }
+
+  // Sets an attribute on the Span through a registered key, with a value of the
+  // type of the key.
+  template <class T>
+  void SetAttribute(const common::AttributeKey<T> &key,
+                    const typename common::AttributeKey<T>::value_type &value) noexcept
+  {
+    this->SetAttribute(static_cast<const common::AttributeKeyBase &>(key),
+                       common::AttributeValue(value));
+  }
+
   // Adds an event to the Span.
   virtual void AddEvent(nostd::string_view name) noexcept = 0;
 
@@ -145,11 +165,13 @@ class Span
    */
   virtual void End(const EndSpanOptions &options = {}) noexcept = 0;
 
-  // TODO
-  // SpanContext context() const noexcept = 0;
+  // Returns the SpanContext of this Span. Spans started while this Span is
+  // active use it as their parent.
+  virtual SpanContext GetContext() const noexcept = 0;
 
   // Returns true if this Span is recording tracing events (e.g. SetAttribute,
-  // AddEvent).
+  // AddEvent). Spans that aren't recorded ignore them, so attributes and events
+  // that are expensive to compute can be skipped when this returns false.
   virtual bool IsRecording() const noexcept = 0;
 
   virtual Tracer &tracer() const noexcept = 0;
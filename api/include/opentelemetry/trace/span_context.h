@@ -43,6 +43,31 @@ class SpanContext final
       : trace_flags_(trace_api::TraceFlags((uint8_t)sampled_flag)),
         remote_parent_(has_remote_parent){};
 
+  /* Creates a SpanContext for a span with the given identifiers.
+   * @param trace_id the id of the trace the span belongs to
+   * @param span_id the id of the span
+   * @param trace_flags the trace flags of the span
+   * @param has_remote_parent whether this context has a remote parent
+   */
+  SpanContext(TraceId trace_id,
+              SpanId span_id,
+              TraceFlags trace_flags,
+              bool has_remote_parent) noexcept
+      : trace_id_(trace_id),
+        span_id_(span_id),
+        trace_flags_(trace_flags),
+        remote_parent_(has_remote_parent)
+  {}
+
+  // @returns the trace_id associated with this span_context
+  const trace_api::TraceId &trace_id() const noexcept { return trace_id_; }
+
+  // @returns the span_id associated with this span_context
+  const trace_api::SpanId &span_id() const noexcept { return span_id_; }
+
+  // @returns whether this context identifies a span
+  bool IsValid() const noexcept { return trace_id_.IsValid() && span_id_.IsValid(); }
+
   // @returns the trace_flags associated with this span_context
   const trace_api::TraceFlags &trace_flags() const noexcept { return trace_flags_; }
 
@@ -53,6 +78,8 @@ class SpanContext final
   bool HasRemoteParent() const noexcept { return remote_parent_; }
 
 private:
+  const trace_api::TraceId trace_id_;
+  const trace_api::SpanId span_id_;
   const trace_api::TraceFlags trace_flags_;
   const bool remote_parent_ = false;
 };
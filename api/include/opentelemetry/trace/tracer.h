@@ -2,6 +2,7 @@
 
 #include "opentelemetry/nostd/string_view.h"
 #include "opentelemetry/nostd/unique_ptr.h"
+#include "opentelemetry/trace/scope.h"
 #include "opentelemetry/trace/span.h"
 #include "opentelemetry/version.h"
 
@@ -26,7 +27,9 @@ class Tracer
    * Optionally sets attributes at Span creation from the given key/value pairs.
    *
    * Attributes will be processed in order, previous attributes with the same
-   * key will be overwritten.
+   * key will be overwritten. As the sampler may look at them, they are built
+   * before the span is sampled; attributes that only matter for recorded spans
+   * are better set after checking the span's IsRecording().
    */
   virtual nostd::unique_ptr<Span> StartSpan(nostd::string_view name,
                                             const KeyValueIterable &attributes,
@@ -57,6 +60,19 @@ class Tracer
                            options);
   }
 
+  /**
+   * Makes a span the active span of the current thread until the returned
+   * scope is destroyed. Spans started while it is active are its children.
+   * @param span the span to activate; the scope keeps a copy of its context
+   */
+  Scope WithActiveSpan(const Span &span) noexcept { return Scope(span); }
+
+  /**
+   * @return the context of the active span of the current thread, or an
+   * invalid context if no span is active
+   */
+  SpanContext GetCurrentSpanContext() noexcept { return Scope::GetCurrentSpanContext(); }
+
   /**
    * Force any buffered spans to flush.
    * @param timeout to complete the flush
@@ -0,0 +1,29 @@
+#include "opentelemetry/common/attribute_key.h"
+#include "opentelemetry/trace/noop.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using opentelemetry::common::AttributeKey;
+namespace nostd = opentelemetry::nostd;
+
+TEST(AttributeKey, Name)
+{
+  AttributeKey<int64_t> key{"test.attribute_key.name"};
+
+  EXPECT_EQ("test.attribute_key.name", key.name());
+  EXPECT_EQ(nullptr, key.sdk_data().load());
+}
+
+TEST(AttributeKey, SetOnNoopSpan)
+{
+  static const AttributeKey<int64_t> kCount{"test.attribute_key.count"};
+  static const AttributeKey<nostd::string_view> kName{"test.attribute_key.name"};
+
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer(new opentelemetry::trace::NoopTracer);
+  auto span = tracer->StartSpan("span");
+  span->SetAttribute(kCount, 3);
+  span->SetAttribute(kName, "name");
+  span->End();
+}
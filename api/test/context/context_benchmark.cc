@@ -0,0 +1,68 @@
+#include "opentelemetry/context/context.h"
+#include "opentelemetry/context/threadlocal_context.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+using opentelemetry::context::Context;
+using opentelemetry::context::ContextKey;
+using opentelemetry::context::ContextValue;
+using opentelemetry::context::RuntimeContext;
+using opentelemetry::trace::SpanContext;
+
+// Simulates the context handling of a request: a value is set on the current
+// context, the new context is attached, the value is read a few times by the
+// layers handling the request, and the context is detached.
+void BM_AttachGetDetachStringKey(benchmark::State &state)
+{
+  ContextValue span_context = opentelemetry::nostd::shared_ptr<SpanContext>(
+      new SpanContext(true, false));
+  while (state.KeepRunning())
+  {
+    auto token =
+        RuntimeContext::Attach(RuntimeContext::GetCurrent().SetValue("span", span_context));
+    for (int i = 0; i < 4; ++i)
+    {
+      benchmark::DoNotOptimize(RuntimeContext::GetValue("span"));
+    }
+    // The token detaches the context when it goes out of scope.
+  }
+}
+BENCHMARK(BM_AttachGetDetachStringKey);
+
+void BM_AttachGetDetachContextKey(benchmark::State &state)
+{
+  static const ContextKey key("span");
+  ContextValue span_context = opentelemetry::nostd::shared_ptr<SpanContext>(
+      new SpanContext(true, false));
+  while (state.KeepRunning())
+  {
+    auto token = RuntimeContext::Attach(RuntimeContext::GetCurrent().SetValue(key, span_context));
+    for (int i = 0; i < 4; ++i)
+    {
+      benchmark::DoNotOptimize(RuntimeContext::GetCurrent().GetValue(key));
+    }
+    // The token detaches the context when it goes out of scope.
+  }
+}
+BENCHMARK(BM_AttachGetDetachContextKey);
+
+// Sets and reads values on a context with the given number of entries.
+void BM_ContextSetGetValue(benchmark::State &state)
+{
+  static const ContextKey key("key");
+  Context context;
+  for (int64_t i = 0; i < state.range(0); ++i)
+  {
+    context = context.SetValue(ContextKey("other" + std::to_string(i)), i);
+  }
+  while (state.KeepRunning())
+  {
+    Context child = context.SetValue(key, (int64_t)1);
+    benchmark::DoNotOptimize(child.GetValue(key));
+  }
+}
+BENCHMARK(BM_ContextSetGetValue)->Arg(0)->Arg(2)->Arg(8);
+}  // namespace
+BENCHMARK_MAIN();
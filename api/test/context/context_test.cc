@@ -1,6 +1,8 @@
 #include "opentelemetry/context/context.h"
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -137,3 +139,109 @@ TEST(ContextTest, ContextDiffCompare)
   context::Context foo_test                             = context::Context(map_foo);
   EXPECT_FALSE(context_test == foo_test);
 }
+
+// Tests that keys with the same name compare equal and find the same value.
+TEST(ContextTest, ContextKeyCompareByName)
+{
+  context::ContextKey key("test_key");
+  context::ContextKey same_key(std::string("test_key"));
+  context::ContextKey other_key("foo_key");
+  EXPECT_TRUE(key == same_key);
+  EXPECT_TRUE(key != other_key);
+  EXPECT_EQ(key.name(), "test_key");
+
+  context::Context test_context = context::Context().SetValue(key, (int64_t)123);
+  EXPECT_EQ(nostd::get<int64_t>(test_context.GetValue(same_key)), 123);
+  EXPECT_EQ(nostd::get<int64_t>(test_context.GetValue("test_key")), 123);
+  EXPECT_TRUE(test_context.HasKey(same_key));
+  EXPECT_FALSE(test_context.HasKey(other_key));
+}
+
+// Tests that keys too long to be stored inline are found and survive copies.
+TEST(ContextTest, ContextKeyLongName)
+{
+  std::string name(2 * context::ContextKey::kInlineSize, 'k');
+  context::ContextKey key(name);
+  context::ContextKey copy = key;
+  EXPECT_EQ(copy.name(), name);
+
+  context::Context test_context = context::Context().SetValue(name, (int64_t)123);
+  context::Context copied       = test_context;
+  test_context                  = context::Context();
+  EXPECT_EQ(nostd::get<int64_t>(copied.GetValue(copy)), 123);
+  EXPECT_FALSE(copied.HasKey(name.substr(1)));
+}
+
+// Tests that contexts with more entries than are stored inline keep all of
+// them, and that the contexts they were derived from are unchanged.
+TEST(ContextTest, ContextBeyondInlineEntries)
+{
+  const int64_t num_entries = 3 * context::Context::kInlineEntries + 1;
+  std::vector<context::Context> contexts{context::Context()};
+  for (int64_t i = 0; i < num_entries; ++i)
+  {
+    contexts.push_back(contexts.back().SetValue("key" + std::to_string(i), i));
+  }
+
+  for (int64_t i = 0; i <= num_entries; ++i)
+  {
+    for (int64_t j = 0; j < num_entries; ++j)
+    {
+      std::string key = "key" + std::to_string(j);
+      ASSERT_EQ(contexts[i].HasKey(key), j < i);
+      if (j < i)
+      {
+        EXPECT_EQ(nostd::get<int64_t>(contexts[i].GetValue(key)), j);
+      }
+    }
+  }
+
+  context::Context overwritten = contexts.back().SetValue("key0", (int64_t)-1);
+  EXPECT_EQ(nostd::get<int64_t>(overwritten.GetValue("key0")), -1);
+  EXPECT_EQ(nostd::get<int64_t>(contexts.back().GetValue("key0")), 0);
+}
+
+// Tests that a context derived from another context does not compare equal
+// to it.
+TEST(ContextTest, ContextDerivedCompare)
+{
+  context::Context context_test = context::Context("test_key", (int64_t)123);
+  context::Context foo_test     = context_test.SetValue("test_key", (int64_t)123);
+  EXPECT_FALSE(context_test == foo_test);
+  EXPECT_TRUE(context::Context() == context::Context());
+}
+
+// Tests that slot values are kept by derived contexts and don't affect the
+// context they were derived from.
+TEST(ContextTest, ContextSlots)
+{
+  context::ContextSlot slot       = context::ContextSlot::Register();
+  context::ContextSlot other_slot = context::ContextSlot::Register();
+  ASSERT_TRUE(slot.IsValid());
+  int64_t value = 123;
+  int64_t read  = 0;
+
+  context::Context empty_context;
+  context::Context slot_context = empty_context.SetSlotValue(slot, &value, sizeof(value));
+  EXPECT_FALSE(empty_context.GetSlotValue(slot, &read, sizeof(read)));
+  EXPECT_TRUE(slot_context.GetSlotValue(slot, &read, sizeof(read)));
+  EXPECT_EQ(read, 123);
+  EXPECT_FALSE(slot_context.GetSlotValue(other_slot, &read, sizeof(read)));
+  EXPECT_FALSE(slot_context == empty_context);
+
+  // Slots hold a copy of the value.
+  value = 456;
+  read  = 0;
+  EXPECT_TRUE(slot_context.GetSlotValue(slot, &read, sizeof(read)));
+  EXPECT_EQ(read, 123);
+
+  // Slots survive setting more entries than are stored inline.
+  context::Context derived_context = slot_context;
+  for (size_t i = 0; i <= context::Context::kInlineEntries; ++i)
+  {
+    derived_context = derived_context.SetValue("key" + std::to_string(i), (int64_t)i);
+  }
+  read = 0;
+  EXPECT_TRUE(derived_context.GetSlotValue(slot, &read, sizeof(read)));
+  EXPECT_EQ(read, 123);
+}
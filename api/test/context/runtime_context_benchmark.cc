@@ -0,0 +1,42 @@
+#include "opentelemetry/context/context.h"
+#include "opentelemetry/context/threadlocal_context.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+using opentelemetry::context::Context;
+using opentelemetry::context::ContextKey;
+using opentelemetry::context::RuntimeContext;
+
+// Attaches a chain of nested contexts and detaches them in reverse order.
+void BM_NestedAttachDetach(benchmark::State &state)
+{
+  static const ContextKey key("depth");
+  const int64_t depth = state.range(0);
+  std::vector<Context> contexts;
+  for (int64_t i = 0; i < depth; ++i)
+  {
+    contexts.push_back(Context().SetValue(key, i));
+  }
+  std::vector<RuntimeContext::Token> tokens;
+  tokens.reserve(depth);
+  while (state.KeepRunning())
+  {
+    for (auto &context : contexts)
+    {
+      tokens.push_back(RuntimeContext::Attach(context));
+    }
+    benchmark::DoNotOptimize(RuntimeContext::GetCurrent());
+    for (auto it = tokens.rbegin(); it != tokens.rend(); ++it)
+    {
+      RuntimeContext::Detach(*it);
+    }
+    tokens.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_NestedAttachDetach)->RangeMultiplier(2)->Range(1, 32);
+}  // namespace
+BENCHMARK_MAIN();
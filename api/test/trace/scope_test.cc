@@ -0,0 +1,95 @@
+#include "opentelemetry/trace/scope.h"
+#include "opentelemetry/context/threadlocal_context.h"
+#include "opentelemetry/trace/noop.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using opentelemetry::trace::NoopTracer;
+using opentelemetry::trace::Scope;
+using opentelemetry::trace::Tracer;
+
+using opentelemetry::trace::NoopSpan;
+using opentelemetry::trace::Span;
+using opentelemetry::trace::SpanContext;
+using opentelemetry::trace::SpanId;
+using opentelemetry::trace::TraceFlags;
+using opentelemetry::trace::TraceId;
+
+namespace
+{
+std::unique_ptr<Span> MakeSpan(const std::shared_ptr<Tracer> &tracer, uint8_t id)
+{
+  uint8_t trace_id[TraceId::kSize] = {1};
+  uint8_t span_id[SpanId::kSize]   = {id};
+  return std::unique_ptr<Span>(
+      new NoopSpan(tracer, SpanContext(TraceId(trace_id), SpanId(span_id), TraceFlags(), false)));
+}
+
+bool IsCurrentSpan(const Span &span)
+{
+  auto current = Scope::GetCurrentSpanContext();
+  auto context = span.GetContext();
+  return current.IsValid() && current.trace_id() == context.trace_id() &&
+         current.span_id() == context.span_id();
+}
+}  // namespace
+
+TEST(ScopeTest, NestedActiveSpans)
+{
+  std::shared_ptr<Tracer> tracer{new NoopTracer{}};
+  EXPECT_FALSE(tracer->GetCurrentSpanContext().IsValid());
+
+  auto outer = MakeSpan(tracer, 1);
+  {
+    auto outer_scope = tracer->WithActiveSpan(*outer);
+    EXPECT_TRUE(IsCurrentSpan(*outer));
+
+    auto inner = MakeSpan(tracer, 2);
+    {
+      auto inner_scope = tracer->WithActiveSpan(*inner);
+      EXPECT_TRUE(IsCurrentSpan(*inner));
+      auto span_context =
+          Scope::GetSpanContext(opentelemetry::context::RuntimeContext::GetCurrent());
+      EXPECT_EQ(span_context.span_id(), inner->GetContext().span_id());
+    }
+    EXPECT_TRUE(IsCurrentSpan(*outer));
+  }
+  EXPECT_FALSE(tracer->GetCurrentSpanContext().IsValid());
+}
+
+TEST(ScopeTest, KeepsContextValues)
+{
+  auto token = opentelemetry::context::RuntimeContext::Attach(
+      opentelemetry::context::Context("key", (int64_t)1));
+
+  std::shared_ptr<Tracer> tracer{new NoopTracer{}};
+  auto span = MakeSpan(tracer, 1);
+  {
+    auto scope = tracer->WithActiveSpan(*span);
+    EXPECT_TRUE(IsCurrentSpan(*span));
+    EXPECT_TRUE(opentelemetry::context::RuntimeContext::GetCurrent().HasKey("key"));
+  }
+  EXPECT_FALSE(tracer->GetCurrentSpanContext().IsValid());
+}
+
+// Tests that contexts copied while a span was active outlive the span.
+TEST(ScopeTest, CopiedContextOutlivesSpan)
+{
+  std::shared_ptr<Tracer> tracer{new NoopTracer{}};
+  auto span    = MakeSpan(tracer, 1);
+  auto span_id = span->GetContext().span_id();
+
+  opentelemetry::context::Context copied;
+  {
+    auto scope = tracer->WithActiveSpan(*span);
+    copied     = opentelemetry::context::RuntimeContext::GetCurrent();
+  }
+  span->End();
+  span.reset();
+
+  EXPECT_EQ(Scope::GetSpanContext(copied).span_id(), span_id);
+  auto token = opentelemetry::context::RuntimeContext::Attach(copied);
+  EXPECT_EQ(tracer->GetCurrentSpanContext().span_id(), span_id);
+}
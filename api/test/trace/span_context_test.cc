@@ -36,3 +36,22 @@ TEST(SpanContextTest, TraceFlags)
 
   ASSERT_EQ(s2.trace_flags().flags(), 0);
 }
+
+TEST(SpanContextTest, Ids)
+{
+  constexpr uint8_t trace_id_buf[] = {1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8};
+  constexpr uint8_t span_id_buf[]  = {1, 2, 3, 4, 5, 6, 7, 8};
+  opentelemetry::trace::TraceId trace_id{trace_id_buf};
+  opentelemetry::trace::SpanId span_id{span_id_buf};
+
+  SpanContext s1(trace_id, span_id, opentelemetry::trace::TraceFlags(1), false);
+
+  ASSERT_TRUE(s1.IsValid());
+  ASSERT_EQ(s1.trace_id(), trace_id);
+  ASSERT_EQ(s1.span_id(), span_id);
+  ASSERT_TRUE(s1.IsSampled());
+
+  SpanContext s2(true, false);
+
+  ASSERT_FALSE(s2.IsValid());
+}
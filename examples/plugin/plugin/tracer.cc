@@ -48,6 +48,8 @@ public:
 
   bool IsRecording() const noexcept override { return true; }
 
+  trace::SpanContext GetContext() const noexcept override { return {false, false}; }
+
   Tracer &tracer() const noexcept override { return *tracer_; }
 
 private:
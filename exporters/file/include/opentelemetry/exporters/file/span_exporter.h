@@ -0,0 +1,92 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/exporter.h"
+#include "opentelemetry/version.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace file
+{
+/**
+ * The FileSpanExporter captures spans to local files in a compact binary
+ * format, for recording large volumes of spans during load tests. Use a
+ * SpanFileReader to read the files back.
+ *
+ * Spans are written to a sequence of files named <prefix>.<sequence number>.
+ * Each file is pre-allocated and memory-mapped, so exporting a span amounts to
+ * encoding it with sdk::trace::SpanDataSerializer and copying it into the
+ * mapping. When a file is full, it is truncated to the written size and the
+ * exporter continues with the next one; when there are more than max_files
+ * files, the oldest one is deleted. A new exporter continues the sequence of
+ * existing files with the same prefix.
+ *
+ * File layout:
+ *   u64  magic "OTSPANS1"
+ *   u64  end of the written data, as an offset from the start of the file
+ *   then per span: u32 size, encoded span
+ *
+ * This exporter is only available on POSIX platforms.
+ */
+class FileSpanExporter final : public sdk::trace::SpanExporter
+{
+public:
+  /**
+   * @param prefix the path prefix of the files to write
+   * @param file_size the size of each file in bytes
+   * @param max_files the maximum number of files to keep, or 0 to keep all
+   */
+  explicit FileSpanExporter(const std::string &prefix,
+                            size_t file_size = 64 * 1024 * 1024,
+                            size_t max_files = 0) noexcept;
+
+  ~FileSpanExporter() override;
+
+  std::unique_ptr<sdk::trace::Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Writes the spans to the current file.
+   * @return kFailure if any span couldn't be written
+   */
+  sdk::trace::ExportResult Export(
+      const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept override;
+
+  /**
+   * Finishes the current file.
+   */
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the number of spans that couldn't be written, because they were
+   * larger than a file or because a file couldn't be created
+   */
+  uint64_t GetDroppedSpanCount() const noexcept { return dropped_spans_.load(); }
+
+private:
+  bool OpenFile() noexcept;
+
+  void CloseFile() noexcept;
+
+  bool Write(nostd::string_view record) noexcept;
+
+  const std::string prefix_;
+  const size_t file_size_;
+  const size_t max_files_;
+
+  uint64_t sequence_ = 0;
+  int fd_            = -1;
+  char *mapping_     = nullptr;
+  size_t offset_     = 0;
+
+  /* Reused buffer for encoding spans */
+  std::string buffer_;
+  std::atomic<uint64_t> dropped_spans_{0};
+  bool is_shutdown_ = false;
+};
+}  // namespace file
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/trace/recordable.h"
+#include "opentelemetry/version.h"
+
+#include <string>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace file
+{
+/**
+ * Reads the spans in a file written by the FileSpanExporter. The file is
+ * memory-mapped, and the spans are decoded into recordables of any exporter,
+ * so a capture can be converted or forwarded after the fact.
+ */
+class SpanFileReader
+{
+public:
+  /**
+   * @param path the path of the file to read
+   */
+  explicit SpanFileReader(const std::string &path) noexcept;
+
+  ~SpanFileReader();
+
+  /**
+   * @return true if the file was opened and has a valid header
+   */
+  bool IsOpen() const noexcept { return mapping_ != nullptr; }
+
+  /**
+   * Obtains the next encoded span. The view remains valid for the lifetime of
+   * the reader.
+   * @param record set to the next span
+   * @return false at the end of the file or if the file is truncated
+   */
+  bool Next(nostd::string_view &record) noexcept;
+
+  /**
+   * Decodes the next span into a recordable.
+   * @return false at the end of the file or if the next span is malformed
+   */
+  bool Next(sdk::trace::Recordable &recordable) noexcept;
+
+  /**
+   * Lists the files written by FileSpanExporters with the given prefix,
+   * oldest first.
+   */
+  static std::vector<std::string> ListFiles(const std::string &prefix);
+
+  /**
+   * @return the sequence number of a file written with the given prefix, or -1
+   * if the path doesn't belong to the prefix
+   */
+  static long long GetSequenceNumber(const std::string &prefix, const std::string &path) noexcept;
+
+private:
+  int fd_        = -1;
+  char *mapping_ = nullptr;
+  size_t size_   = 0;
+  size_t end_    = 0;
+  size_t offset_ = 0;
+};
+}  // namespace file
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
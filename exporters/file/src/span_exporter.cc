@@ -0,0 +1,169 @@
+#include "opentelemetry/exporters/file/span_exporter.h"
+
+#include "opentelemetry/exporters/file/span_file_reader.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+#include "span_file_format.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace file
+{
+FileSpanExporter::FileSpanExporter(const std::string &prefix,
+                                   size_t file_size,
+                                   size_t max_files) noexcept
+    : prefix_(prefix), file_size_(file_size), max_files_(max_files)
+{
+  auto files = SpanFileReader::ListFiles(prefix_);
+  if (!files.empty())
+  {
+    sequence_ = SpanFileReader::GetSequenceNumber(prefix_, files.back()) + 1;
+  }
+}
+
+FileSpanExporter::~FileSpanExporter()
+{
+  CloseFile();
+}
+
+std::unique_ptr<sdk::trace::Recordable> FileSpanExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<sdk::trace::Recordable>(new sdk::trace::SpanData);
+}
+
+sdk::trace::ExportResult FileSpanExporter::Export(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept
+{
+  if (is_shutdown_)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  uint64_t dropped = 0;
+  for (auto &recordable : spans)
+  {
+    auto span = static_cast<const sdk::trace::SpanData *>(recordable.get());
+    if (span == nullptr)
+    {
+      continue;
+    }
+    buffer_.clear();
+    sdk::trace::SpanDataSerializer::Serialize(*span, buffer_);
+    if (!Write(buffer_))
+    {
+      ++dropped;
+    }
+  }
+
+  if (mapping_ != nullptr)
+  {
+    // Publish the batch to readers of the file that is still being written.
+    uint64_t end = offset_;
+    memcpy(mapping_ + kSpanFileEndOffset, &end, sizeof(end));
+  }
+
+  if (dropped > 0)
+  {
+    dropped_spans_ += dropped;
+    return sdk::trace::ExportResult::kFailure;
+  }
+  return sdk::trace::ExportResult::kSuccess;
+}
+
+bool FileSpanExporter::Write(nostd::string_view record) noexcept
+{
+  uint32_t size = static_cast<uint32_t>(record.size());
+  size_t needed = sizeof(size) + record.size();
+  if (kSpanFileHeaderSize + needed > file_size_)
+  {
+    return false;
+  }
+
+  if (mapping_ != nullptr && offset_ + needed > file_size_)
+  {
+    CloseFile();
+  }
+  if (mapping_ == nullptr && !OpenFile())
+  {
+    return false;
+  }
+
+  memcpy(mapping_ + offset_, &size, sizeof(size));
+  memcpy(mapping_ + offset_ + sizeof(size), record.data(), record.size());
+  offset_ += needed;
+  return true;
+}
+
+bool FileSpanExporter::OpenFile() noexcept
+{
+  std::string path = prefix_ + "." + std::to_string(sequence_++);
+  fd_              = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0)
+  {
+    return false;
+  }
+
+  void *mapping = MAP_FAILED;
+  if (posix_fallocate(fd_, 0, static_cast<off_t>(file_size_)) == 0)
+  {
+    mapping = mmap(nullptr, file_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  }
+  if (mapping == MAP_FAILED)
+  {
+    close(fd_);
+    fd_ = -1;
+    unlink(path.c_str());
+    return false;
+  }
+
+  mapping_     = static_cast<char *>(mapping);
+  offset_      = kSpanFileHeaderSize;
+  uint64_t end = offset_;
+  memcpy(mapping_, &kSpanFileMagic, sizeof(kSpanFileMagic));
+  memcpy(mapping_ + kSpanFileEndOffset, &end, sizeof(end));
+
+  if (max_files_ > 0)
+  {
+    auto files = SpanFileReader::ListFiles(prefix_);
+    for (size_t i = 0; i + max_files_ < files.size(); ++i)
+    {
+      unlink(files[i].c_str());
+    }
+  }
+  return true;
+}
+
+void FileSpanExporter::CloseFile() noexcept
+{
+  if (mapping_ == nullptr)
+  {
+    return;
+  }
+  uint64_t end = offset_;
+  memcpy(mapping_ + kSpanFileEndOffset, &end, sizeof(end));
+  munmap(mapping_, file_size_);
+  mapping_ = nullptr;
+  // Give back the pre-allocated space that wasn't used.
+  if (ftruncate(fd_, static_cast<off_t>(offset_)) != 0)
+  {
+    // The file keeps its zero-filled tail, which readers skip.
+  }
+  close(fd_);
+  fd_ = -1;
+}
+
+void FileSpanExporter::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  is_shutdown_ = true;
+  CloseFile();
+}
+}  // namespace file
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
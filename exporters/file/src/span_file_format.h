@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace file
+{
+/* The constants of the file layout described in FileSpanExporter */
+constexpr uint64_t kSpanFileMagic    = 0x31534e415053544f;  // "OTSPANS1"
+constexpr size_t kSpanFileEndOffset  = sizeof(uint64_t);
+constexpr size_t kSpanFileHeaderSize = 2 * sizeof(uint64_t);
+}  // namespace file
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
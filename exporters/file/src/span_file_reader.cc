@@ -0,0 +1,145 @@
+#include "opentelemetry/exporters/file/span_file_reader.h"
+
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+#include "span_file_format.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace file
+{
+SpanFileReader::SpanFileReader(const std::string &path) noexcept
+{
+  fd_ = open(path.c_str(), O_RDONLY);
+  if (fd_ < 0)
+  {
+    return;
+  }
+
+  struct stat st;
+  if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < kSpanFileHeaderSize)
+  {
+    return;
+  }
+  size_ = static_cast<size_t>(st.st_size);
+
+  void *mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED)
+  {
+    return;
+  }
+
+  uint64_t magic;
+  uint64_t end;
+  memcpy(&magic, mapping, sizeof(magic));
+  memcpy(&end, static_cast<char *>(mapping) + kSpanFileEndOffset, sizeof(end));
+  if (magic != kSpanFileMagic || end < kSpanFileHeaderSize)
+  {
+    munmap(mapping, size_);
+    return;
+  }
+
+  mapping_ = static_cast<char *>(mapping);
+  end_     = std::min(static_cast<size_t>(end), size_);
+  offset_  = kSpanFileHeaderSize;
+  madvise(mapping_, size_, MADV_SEQUENTIAL);
+}
+
+SpanFileReader::~SpanFileReader()
+{
+  if (mapping_ != nullptr)
+  {
+    munmap(mapping_, size_);
+  }
+  if (fd_ >= 0)
+  {
+    close(fd_);
+  }
+}
+
+bool SpanFileReader::Next(nostd::string_view &record) noexcept
+{
+  uint32_t size;
+  if (mapping_ == nullptr || end_ - offset_ < sizeof(size))
+  {
+    return false;
+  }
+  memcpy(&size, mapping_ + offset_, sizeof(size));
+  if (end_ - offset_ - sizeof(size) < size)
+  {
+    return false;
+  }
+  record = nostd::string_view{mapping_ + offset_ + sizeof(size), size};
+  offset_ += sizeof(size) + size;
+  return true;
+}
+
+bool SpanFileReader::Next(sdk::trace::Recordable &recordable) noexcept
+{
+  nostd::string_view record;
+  return Next(record) && sdk::trace::SpanDataSerializer::Deserialize(record, recordable);
+}
+
+std::vector<std::string> SpanFileReader::ListFiles(const std::string &prefix)
+{
+  auto slash            = prefix.rfind('/');
+  std::string directory = slash == std::string::npos ? "." : prefix.substr(0, slash + 1);
+
+  std::vector<std::pair<long long, std::string>> files;
+  DIR *dir = opendir(directory.c_str());
+  if (dir == nullptr)
+  {
+    return {};
+  }
+  while (auto entry = readdir(dir))
+  {
+    std::string path = slash == std::string::npos ? entry->d_name : directory + entry->d_name;
+    long long sequence = GetSequenceNumber(prefix, path);
+    if (sequence >= 0)
+    {
+      files.emplace_back(sequence, path);
+    }
+  }
+  closedir(dir);
+
+  std::sort(files.begin(), files.end());
+  std::vector<std::string> result;
+  for (auto &file : files)
+  {
+    result.push_back(std::move(file.second));
+  }
+  return result;
+}
+
+long long SpanFileReader::GetSequenceNumber(const std::string &prefix,
+                                            const std::string &path) noexcept
+{
+  if (path.size() <= prefix.size() + 1 || path.compare(0, prefix.size(), prefix) != 0 ||
+      path[prefix.size()] != '.')
+  {
+    return -1;
+  }
+  long long sequence = 0;
+  for (size_t i = prefix.size() + 1; i < path.size(); ++i)
+  {
+    if (path[i] < '0' || path[i] > '9' || sequence > (1LL << 50))
+    {
+      return -1;
+    }
+    sequence = sequence * 10 + (path[i] - '0');
+  }
+  return sequence;
+}
+}  // namespace file
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,168 @@
+#include "opentelemetry/exporters/file/span_exporter.h"
+#include "opentelemetry/exporters/file/span_file_reader.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace opentelemetry::exporter::file;
+using opentelemetry::sdk::trace::ExportResult;
+using opentelemetry::sdk::trace::Recordable;
+using opentelemetry::sdk::trace::SpanData;
+using opentelemetry::sdk::trace::SpanExporter;
+namespace nostd = opentelemetry::nostd;
+
+class FileSpanExporterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    char path[] = "/tmp/file_span_exporter_test.XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+    prefix_    = directory_ + "/spans";
+  }
+
+  void TearDown() override
+  {
+    for (auto &file : SpanFileReader::ListFiles(prefix_))
+    {
+      unlink(file.c_str());
+    }
+    rmdir(directory_.c_str());
+  }
+
+  ExportResult ExportSpans(SpanExporter &exporter, const std::string &prefix, int num_spans)
+  {
+    std::vector<std::unique_ptr<Recordable>> batch;
+    for (int i = 0; i < num_spans; ++i)
+    {
+      batch.push_back(exporter.MakeRecordable());
+      batch.back()->SetName(prefix + std::to_string(i));
+      batch.back()->SetAttribute("index", i);
+    }
+    return exporter.Export(nostd::span<std::unique_ptr<Recordable>>(batch.data(), batch.size()));
+  }
+
+  std::vector<std::string> ReadNames()
+  {
+    std::vector<std::string> names;
+    for (auto &file : SpanFileReader::ListFiles(prefix_))
+    {
+      SpanFileReader reader(file);
+      EXPECT_TRUE(reader.IsOpen()) << file;
+      SpanData span;
+      while (reader.Next(span))
+      {
+        names.push_back(std::string(span.GetName()));
+        span = SpanData();
+      }
+    }
+    return names;
+  }
+
+  std::string directory_;
+  std::string prefix_;
+};
+
+TEST_F(FileSpanExporterTest, WritesSpans)
+{
+  FileSpanExporter exporter(prefix_);
+  EXPECT_EQ(ExportSpans(exporter, "span", 3), ExportResult::kSuccess);
+  exporter.Shutdown();
+
+  auto files = SpanFileReader::ListFiles(prefix_);
+  ASSERT_EQ(files.size(), 1);
+  EXPECT_EQ(files[0], prefix_ + ".0");
+
+  SpanFileReader reader(files[0]);
+  SpanData span;
+  ASSERT_TRUE(reader.Next(span));
+  EXPECT_EQ(span.GetName(), "span0");
+  EXPECT_EQ(nostd::get<int64_t>(span.GetAttributes().at("index")), 0);
+  EXPECT_EQ(ReadNames(), (std::vector<std::string>{"span0", "span1", "span2"}));
+}
+
+TEST_F(FileSpanExporterTest, ReadsFileBeingWritten)
+{
+  FileSpanExporter exporter(prefix_);
+  ExportSpans(exporter, "span", 2);
+
+  // The file is still pre-allocated; only exported batches are visible.
+  EXPECT_EQ(ReadNames(), (std::vector<std::string>{"span0", "span1"}));
+}
+
+TEST_F(FileSpanExporterTest, RotatesFiles)
+{
+  FileSpanExporter exporter(prefix_, 1024);
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(ExportSpans(exporter, "batch" + std::to_string(i) + "-", 10),
+              ExportResult::kSuccess);
+  }
+  exporter.Shutdown();
+
+  EXPECT_GT(SpanFileReader::ListFiles(prefix_).size(), 1);
+  auto names = ReadNames();
+  ASSERT_EQ(names.size(), 100);
+  EXPECT_EQ(names.front(), "batch0-0");
+  EXPECT_EQ(names.back(), "batch9-9");
+}
+
+TEST_F(FileSpanExporterTest, KeepsAtMostMaxFiles)
+{
+  FileSpanExporter exporter(prefix_, 1024, 2);
+  for (int i = 0; i < 10; ++i)
+  {
+    ExportSpans(exporter, "batch" + std::to_string(i) + "-", 10);
+  }
+  exporter.Shutdown();
+
+  auto files = SpanFileReader::ListFiles(prefix_);
+  EXPECT_EQ(files.size(), 2);
+  EXPECT_EQ(ReadNames().back(), "batch9-9");
+}
+
+TEST_F(FileSpanExporterTest, ContinuesSequence)
+{
+  {
+    FileSpanExporter exporter(prefix_);
+    ExportSpans(exporter, "a", 1);
+  }
+  {
+    FileSpanExporter exporter(prefix_);
+    ExportSpans(exporter, "b", 1);
+  }
+
+  EXPECT_EQ(SpanFileReader::ListFiles(prefix_),
+            (std::vector<std::string>{prefix_ + ".0", prefix_ + ".1"}));
+  EXPECT_EQ(ReadNames(), (std::vector<std::string>{"a0", "b0"}));
+}
+
+TEST_F(FileSpanExporterTest, DropsOversizedSpans)
+{
+  FileSpanExporter exporter(prefix_, 64);
+  EXPECT_EQ(ExportSpans(exporter, "a-span-whose-record-does-not-fit-into-a-file", 1),
+            ExportResult::kFailure);
+  EXPECT_EQ(exporter.GetDroppedSpanCount(), 1);
+}
+
+TEST(SpanFileReader, GetSequenceNumber)
+{
+  EXPECT_EQ(SpanFileReader::GetSequenceNumber("/tmp/spans", "/tmp/spans.42"), 42);
+  EXPECT_EQ(SpanFileReader::GetSequenceNumber("/tmp/spans", "/tmp/spans."), -1);
+  EXPECT_EQ(SpanFileReader::GetSequenceNumber("/tmp/spans", "/tmp/spans.4x"), -1);
+  EXPECT_EQ(SpanFileReader::GetSequenceNumber("/tmp/spans", "/tmp/other.1"), -1);
+}
+
+TEST(SpanFileReader, RejectsMissingFile)
+{
+  SpanFileReader reader("/nonexistent/spans.0");
+  EXPECT_FALSE(reader.IsOpen());
+  nostd::string_view record;
+  EXPECT_FALSE(reader.Next(record));
+}
@@ -0,0 +1,101 @@
+// Converts span capture files written by the FileSpanExporter to text or JSON.
+//
+// Usage: span_file_converter [--json] <file or prefix>...
+//
+// The spans are printed by the OStreamSpanExporter, as text or as JSON lines.
+
+#include "opentelemetry/exporters/file/span_file_reader.h"
+#include "opentelemetry/exporters/ostream/span_exporter.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace file     = opentelemetry::exporter::file;
+namespace nostd    = opentelemetry::nostd;
+namespace sdktrace = opentelemetry::sdk::trace;
+using opentelemetry::exporter::OStreamFormat;
+using opentelemetry::exporter::trace::OStreamSpanExporter;
+
+namespace
+{
+bool Convert(const std::string &path, OStreamSpanExporter &exporter)
+{
+  file::SpanFileReader reader(path);
+  if (!reader.IsOpen())
+  {
+    return false;
+  }
+
+  // Convert in batches, so that the exporter writes to the stream in large chunks.
+  const size_t batch_size = 1024;
+  std::vector<std::unique_ptr<sdktrace::Recordable>> batch;
+  bool has_more = true;
+  while (has_more)
+  {
+    batch.clear();
+    while (batch.size() < batch_size)
+    {
+      auto recordable = exporter.MakeRecordable();
+      if (!reader.Next(*recordable))
+      {
+        has_more = false;
+        break;
+      }
+      batch.push_back(std::move(recordable));
+    }
+    exporter.Export(
+        nostd::span<std::unique_ptr<sdktrace::Recordable>>(batch.data(), batch.size()));
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  bool json = false;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--json")
+    {
+      json = true;
+    }
+    else
+    {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty())
+  {
+    std::cerr << "Usage: " << argv[0] << " [--json] <file or prefix>..." << std::endl;
+    return 2;
+  }
+
+  OStreamSpanExporter exporter(std::cout,
+                               json ? OStreamFormat::kJsonLines : OStreamFormat::kText);
+  int result = 0;
+  for (auto &path : paths)
+  {
+    if (Convert(path, exporter))
+    {
+      continue;
+    }
+    auto files = file::SpanFileReader::ListFiles(path);
+    if (files.empty())
+    {
+      std::cerr << "Failed to read " << path << std::endl;
+      result = 1;
+    }
+    for (auto &file : files)
+    {
+      if (!Convert(file, exporter))
+      {
+        std::cerr << "Failed to read " << file << std::endl;
+        result = 1;
+      }
+    }
+  }
+  return result;
+}
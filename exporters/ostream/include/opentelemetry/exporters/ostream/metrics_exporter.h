@@ -1,6 +1,8 @@
 #pragma once
 
 #include <iostream>
+#include <type_traits>
+#include "opentelemetry/exporters/ostream/ostream_format.h"
 #include "opentelemetry/sdk/metrics/aggregator/exact_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/gauge_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
@@ -16,7 +18,10 @@ namespace metrics
 {
 
 /**
- * The OStreamMetricsExporter exports record data through an ostream
+ * The OStreamMetricsExporter exports record data through an ostream.
+ *
+ * Each batch of records is formatted into a reusable buffer and written to the
+ * stream with a single write.
  */
 class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
 {
@@ -25,47 +30,100 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
    * Create an OStreamMetricsExporter. This constructor takes in a reference to an ostream that the
    * export() function will send span data into.
    * The default ostream is set to stdout
+   * @param format the output format, human-readable text by default
    */
-  explicit OStreamMetricsExporter(std::ostream &sout = std::cout) noexcept;
+  explicit OStreamMetricsExporter(std::ostream &sout  = std::cout,
+                                  OStreamFormat format = OStreamFormat::kText) noexcept;
 
   sdkmetrics::ExportResult Export(const std::vector<sdkmetrics::Record> &records) noexcept override;
 
 private:
   std::ostream &sout_;
+  const OStreamFormat format_;
+
+  /* Reused buffer for formatting batches */
+  detail::FormatBuffer buffer_;
+
+  template <typename T>
+  void FormatNumber(T value, std::true_type /* is_integral */)
+  {
+    buffer_.AppendInt(static_cast<int64_t>(value));
+  }
+
+  template <typename T>
+  void FormatNumber(T value, std::false_type /* is_integral */)
+  {
+    if (format_ == OStreamFormat::kJsonLines)
+    {
+      buffer_.AppendJsonDouble(value);
+    }
+    else
+    {
+      buffer_.AppendDouble(value);
+    }
+  }
+
+  template <typename T>
+  void FormatNumber(T value)
+  {
+    FormatNumber(value, std::is_integral<T>());
+  }
+
+  template <typename T>
+  void FormatNumbers(const std::vector<T> &values, nostd::string_view separator)
+  {
+    buffer_.Append('[');
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (i != 0)
+      {
+        buffer_.Append(separator);
+      }
+      FormatNumber(values[i]);
+    }
+    buffer_.Append(']');
+  }
 
   /**
-   * Send specific data from the given AggregatorVariant based on what AggregatorKind
-   * it is holding. Each Aggregator holds data differently, so each have their own
-   * custom printing.
+   * Format the data of an Aggregator based on its AggregatorKind. Each
+   * Aggregator holds data differently, so each has its own custom formatting.
+   * Text fields start on a new line; JSON fields are preceded by a comma.
    */
   template <typename T>
-  void PrintAggregatorVariant(sdkmetrics::AggregatorVariant value)
+  void FormatAggregator(const std::shared_ptr<sdkmetrics::Aggregator<T>> &agg)
   {
-    auto agg     = nostd::get<std::shared_ptr<sdkmetrics::Aggregator<T>>>(value);
-    auto aggKind = agg->get_aggregator_kind();
-
     if (!agg)
       return;
-    switch (aggKind)
+
+    bool json = format_ == OStreamFormat::kJsonLines;
+    switch (agg->get_aggregator_kind())
     {
       case sdkmetrics::AggregatorKind::Counter:
       {
-        sout_ << "\n  sum         : " << agg->get_checkpoint()[0];
+        buffer_.Append(json ? ",\"sum\":" : "\n  sum         : ");
+        FormatNumber(agg->get_checkpoint()[0]);
       }
       break;
       case sdkmetrics::AggregatorKind::MinMaxSumCount:
       {
         auto mmsc = agg->get_checkpoint();
-        sout_ << "\n  min         : " << mmsc[0] << "\n  max         : " << mmsc[1]
-              << "\n  sum         : " << mmsc[2] << "\n  count       : " << mmsc[3];
+        buffer_.Append(json ? ",\"min\":" : "\n  min         : ");
+        FormatNumber(mmsc[0]);
+        buffer_.Append(json ? ",\"max\":" : "\n  max         : ");
+        FormatNumber(mmsc[1]);
+        buffer_.Append(json ? ",\"sum\":" : "\n  sum         : ");
+        FormatNumber(mmsc[2]);
+        buffer_.Append(json ? ",\"count\":" : "\n  count       : ");
+        FormatNumber(mmsc[3]);
       }
       break;
       case sdkmetrics::AggregatorKind::Gauge:
       {
         auto timestamp = agg->get_checkpoint_timestamp();
-
-        sout_ << "\n  last value  : " << agg->get_checkpoint()[0]
-              << "\n  timestamp   : " << std::to_string(timestamp.time_since_epoch().count());
+        buffer_.Append(json ? ",\"last_value\":" : "\n  last value  : ");
+        FormatNumber(agg->get_checkpoint()[0]);
+        buffer_.Append(json ? ",\"timestamp\":" : "\n  timestamp   : ");
+        buffer_.AppendInt(timestamp.time_since_epoch().count());
       }
       break;
       case sdkmetrics::AggregatorKind::Exact:
@@ -73,90 +131,42 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
         // TODO: Find better way to print quantiles
         if (agg->get_quant_estimation())
         {
-          sout_ << "\n  quantiles   : "
-                << "[0: " << agg->get_quantiles(0) << ", "
-                << ".25: " << agg->get_quantiles(.25) << ", "
-                << ".50: " << agg->get_quantiles(.50) << ", "
-                << ".75: " << agg->get_quantiles(.75) << ", "
-                << "1: " << agg->get_quantiles(1) << ']';
-        }
-        else
-        {
-          auto vec = agg->get_checkpoint();
-          int size = vec.size();
-          int i    = 1;
-
-          sout_ << "\n  values      : " << '[';
-
-          for (auto val : vec)
+          static const double kQuantiles[]          = {0, .25, .50, .75, 1};
+          static const char *const kTextQuantiles[] = {"0", ".25", ".50", ".75", "1"};
+          static const char *const kJsonQuantiles[] = {"0", "0.25", "0.5", "0.75", "1"};
+          buffer_.Append(json ? ",\"quantiles\":{" : "\n  quantiles   : [");
+          for (size_t i = 0; i < sizeof(kQuantiles) / sizeof(kQuantiles[0]); ++i)
           {
-            sout_ << val;
-            if (i != size)
-              sout_ << ", ";
-            i++;
+            if (i != 0)
+            {
+              buffer_.Append(json ? "," : ", ");
+            }
+            if (json)
+            {
+              buffer_.Append('"').Append(kJsonQuantiles[i]).Append("\":");
+            }
+            else
+            {
+              buffer_.Append(kTextQuantiles[i]).Append(": ");
+            }
+            FormatNumber(agg->get_quantiles(kQuantiles[i]));
           }
-          sout_ << ']';
-        }
-      }
-      break;
-      case sdkmetrics::AggregatorKind::Histogram:
-      {
-        auto boundaries = agg->get_boundaries();
-        auto counts     = agg->get_counts();
-
-        int boundaries_size = boundaries.size();
-        int counts_size     = counts.size();
-
-        sout_ << "\n  buckets     : " << '[';
-
-        for (int i = 0; i < boundaries_size; i++)
-        {
-          sout_ << boundaries[i];
-
-          if (i != boundaries_size - 1)
-            sout_ << ", ";
+          buffer_.Append(json ? '}' : ']');
         }
-        sout_ << ']';
-
-        sout_ << "\n  counts      : " << '[';
-        for (int i = 0; i < counts_size; i++)
+        else
         {
-          sout_ << counts[i];
-
-          if (i != counts_size - 1)
-            sout_ << ", ";
+          buffer_.Append(json ? ",\"values\":" : "\n  values      : ");
+          FormatNumbers(agg->get_checkpoint(), json ? "," : ", ");
         }
-        sout_ << ']';
       }
       break;
+      case sdkmetrics::AggregatorKind::Histogram:
       case sdkmetrics::AggregatorKind::Sketch:
       {
-        auto boundaries = agg->get_boundaries();
-        auto counts     = agg->get_counts();
-
-        int boundaries_size = boundaries.size();
-        int counts_size     = counts.size();
-
-        sout_ << "\n  buckets     : " << '[';
-
-        for (int i = 0; i < boundaries_size; i++)
-        {
-          sout_ << boundaries[i];
-
-          if (i != boundaries_size - 1)
-            sout_ << ", ";
-        }
-        sout_ << ']';
-
-        sout_ << "\n  counts      : " << '[';
-        for (int i = 0; i < counts_size; i++)
-        {
-          sout_ << counts[i];
-
-          if (i != counts_size - 1)
-            sout_ << ", ";
-        }
-        sout_ << ']';
+        buffer_.Append(json ? ",\"buckets\":" : "\n  buckets     : ");
+        FormatNumbers(agg->get_boundaries(), json ? "," : ", ");
+        buffer_.Append(json ? ",\"counts\":" : "\n  counts      : ");
+        FormatNumbers(agg->get_counts(), json ? "," : ", ");
       }
       break;
     }
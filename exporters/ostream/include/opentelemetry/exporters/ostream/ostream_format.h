@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/common/json.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+/**
+ * The output formats of the ostream exporters.
+ */
+enum class OStreamFormat
+{
+  /* A human-readable, multi-line block per span or record */
+  kText,
+  /* One JSON object per line */
+  kJsonLines
+};
+
+namespace detail
+{
+/**
+ * A reusable character buffer that the ostream exporters format a whole batch
+ * into before writing it to the stream at once. Numbers are formatted directly
+ * into the buffer; after the first few batches, formatting doesn't allocate.
+ */
+class FormatBuffer
+{
+public:
+  void Clear() noexcept { data_.clear(); }
+
+  bool Empty() const noexcept { return data_.empty(); }
+
+  nostd::string_view View() const noexcept { return data_; }
+
+  /**
+   * Writes the contents to a stream with a single call.
+   */
+  void WriteTo(std::ostream &sout) const
+  {
+    sout.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+  }
+
+  FormatBuffer &Append(nostd::string_view value)
+  {
+    data_.append(value.data(), value.size());
+    return *this;
+  }
+
+  FormatBuffer &Append(char value)
+  {
+    data_.push_back(value);
+    return *this;
+  }
+
+  FormatBuffer &AppendInt(int64_t value)
+  {
+    // Negate as unsigned so that the minimum value doesn't overflow.
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0)
+    {
+      data_.push_back('-');
+      magnitude = 0 - magnitude;
+    }
+    return AppendUint(magnitude);
+  }
+
+  FormatBuffer &AppendUint(uint64_t value)
+  {
+    char digits[20];
+    char *end   = digits + sizeof(digits);
+    char *begin = end;
+    do
+    {
+      *--begin = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value != 0);
+    data_.append(begin, end);
+    return *this;
+  }
+
+  /**
+   * Appends a floating point number like printf's %g.
+   * @param precision the number of significant digits. The default matches
+   * the default formatting of std::ostream.
+   */
+  FormatBuffer &AppendDouble(double value, int precision = 6)
+  {
+    char digits[32];
+    int size = snprintf(digits, sizeof(digits), "%.*g", precision, value);
+    if (size > 0)
+    {
+      data_.append(digits, static_cast<size_t>(size) < sizeof(digits) ? size : sizeof(digits) - 1);
+    }
+    return *this;
+  }
+
+  /**
+   * Appends a floating point number as a JSON number that reads back to the
+   * same value, or null for NaN and infinity.
+   */
+  FormatBuffer &AppendJsonDouble(double value)
+  {
+    sdk::common::AppendJsonDouble(data_, value);
+    return *this;
+  }
+
+  /**
+   * Appends a quoted and escaped JSON string.
+   */
+  FormatBuffer &AppendJsonString(nostd::string_view value)
+  {
+    sdk::common::AppendJsonString(data_, value);
+    return *this;
+  }
+
+private:
+  std::string data_;
+};
+}  // namespace detail
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -6,42 +6,53 @@ namespace exporter
 namespace metrics
 {
 
-OStreamMetricsExporter::OStreamMetricsExporter(std::ostream &sout) noexcept : sout_(sout) {}
+OStreamMetricsExporter::OStreamMetricsExporter(std::ostream &sout, OStreamFormat format) noexcept
+    : sout_(sout), format_(format)
+{}
 
 sdkmetrics::ExportResult OStreamMetricsExporter::Export(
     const std::vector<sdk::metrics::Record> &records) noexcept
 {
-  for (auto record : records)
+  buffer_.Clear();
+  for (auto &record : records)
   {
-    sout_ << "{"
-          << "\n  name        : " << record.GetName()
-          << "\n  description : " << record.GetDescription()
-          << "\n  labels      : " << record.GetLabels();
-
-    auto aggregator = record.GetAggregator();
+    if (format_ == OStreamFormat::kJsonLines)
+    {
+      buffer_.Append("{\"name\":").AppendJsonString(record.GetName());
+      buffer_.Append(",\"description\":").AppendJsonString(record.GetDescription());
+      buffer_.Append(",\"labels\":").AppendJsonString(record.GetLabels());
+    }
+    else
+    {
+      buffer_.Append("{\n  name        : ").Append(record.GetName());
+      buffer_.Append("\n  description : ").Append(record.GetDescription());
+      buffer_.Append("\n  labels      : ").Append(record.GetLabels());
+    }
 
     /**
-     * Unpack the AggregatorVariant from the record so we can pass the data type to
-     * PrintAggregatorVariant to unpack the Aggregator from the variant.
+     * Unpack the Aggregator from the AggregatorVariant of the record so we can
+     * format it according to its data type.
      */
+    auto &aggregator = record.GetAggregator();
     if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<int>>>(aggregator))
     {
-      PrintAggregatorVariant<int>(aggregator);
+      FormatAggregator(nostd::get<std::shared_ptr<sdkmetrics::Aggregator<int>>>(aggregator));
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<short>>>(aggregator))
     {
-      PrintAggregatorVariant<short>(aggregator);
+      FormatAggregator(nostd::get<std::shared_ptr<sdkmetrics::Aggregator<short>>>(aggregator));
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<double>>>(aggregator))
     {
-      PrintAggregatorVariant<double>(aggregator);
+      FormatAggregator(nostd::get<std::shared_ptr<sdkmetrics::Aggregator<double>>>(aggregator));
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<float>>>(aggregator))
     {
-      PrintAggregatorVariant<float>(aggregator);
+      FormatAggregator(nostd::get<std::shared_ptr<sdkmetrics::Aggregator<float>>>(aggregator));
     }
-    sout_ << "\n}\n";
+    buffer_.Append(format_ == OStreamFormat::kJsonLines ? "}\n" : "\n}\n");
   }
+  buffer_.WriteTo(sout_);
   return sdkmetrics::ExportResult::kSuccess;
 }
 
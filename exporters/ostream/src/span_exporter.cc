@@ -10,7 +10,98 @@ namespace exporter
 {
 namespace trace
 {
-OStreamSpanExporter::OStreamSpanExporter(std::ostream &sout) noexcept : sout_(sout) {}
+namespace
+{
+// Mapping status number to the string from api/include/opentelemetry/trace/canonical_code.h
+const char *const kStatusNames[] = {"OK",
+                                    "CANCELLED",
+                                    "UNKNOWN",
+                                    "INVALID_ARGUMENT",
+                                    "DEADLINE_EXCEEDED",
+                                    "NOT_FOUND",
+                                    "ALREADY_EXISTS",
+                                    "PERMISSION_DENIED",
+                                    "RESOURCE_EXHAUSTED",
+                                    "FAILED_PRECONDITION",
+                                    "ABORTED",
+                                    "OUT_OF_RANGE",
+                                    "UNIMPLEMENTED",
+                                    "INTERNAL",
+                                    "UNAVAILABLE",
+                                    "DATA_LOSS",
+                                    "UNAUTHENTICATED"};
+
+nostd::string_view GetStatusName(opentelemetry::trace::CanonicalCode code) noexcept
+{
+  auto index = static_cast<size_t>(code);
+  return index < sizeof(kStatusNames) / sizeof(kStatusNames[0]) ? kStatusNames[index] : "";
+}
+
+/**
+ * Formats an attribute value. Arrays are enclosed in brackets and their
+ * elements are separated by commas.
+ */
+struct ValueFormatter
+{
+  detail::FormatBuffer &buffer;
+  bool json;
+
+  void operator()(bool value)
+  {
+    if (json)
+    {
+      buffer.Append(value ? "true" : "false");
+    }
+    else
+    {
+      buffer.Append(value ? '1' : '0');
+    }
+  }
+  void operator()(int64_t value) { buffer.AppendInt(value); }
+  void operator()(uint64_t value) { buffer.AppendUint(value); }
+  void operator()(double value)
+  {
+    if (json)
+    {
+      buffer.AppendJsonDouble(value);
+    }
+    else
+    {
+      buffer.AppendDouble(value);
+    }
+  }
+  void operator()(const std::string &value)
+  {
+    if (json)
+    {
+      buffer.AppendJsonString(value);
+    }
+    else
+    {
+      buffer.Append(value);
+    }
+  }
+
+  template <typename T>
+  void operator()(const std::vector<T> &values)
+  {
+    buffer.Append('[');
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (i != 0)
+      {
+        buffer.Append(',');
+      }
+      (*this)(static_cast<T>(values[i]));
+    }
+    buffer.Append(']');
+  }
+};
+}  // namespace
+
+OStreamSpanExporter::OStreamSpanExporter(std::ostream &sout, OStreamFormat format) noexcept
+    : sout_(sout), format_(format)
+{}
 
 std::unique_ptr<sdktrace::Recordable> OStreamSpanExporter::MakeRecordable() noexcept
 {
@@ -25,38 +116,116 @@ sdktrace::ExportResult OStreamSpanExporter::Export(
     return sdktrace::ExportResult::kFailure;
   }
 
+  buffer_.Clear();
   for (auto &recordable : spans)
   {
-    auto span = std::unique_ptr<sdktrace::SpanData>(
-        static_cast<sdktrace::SpanData *>(recordable.release()));
+    auto span = static_cast<const sdktrace::SpanData *>(recordable.get());
+    if (span == nullptr)
+    {
+      continue;
+    }
+    if (format_ == OStreamFormat::kJsonLines)
+    {
+      FormatJson(*span);
+    }
+    else
+    {
+      FormatText(*span);
+    }
+  }
+  buffer_.WriteTo(sout_);
 
-    if (span != nullptr)
+  return sdktrace::ExportResult::kSuccess;
+}
+
+void OStreamSpanExporter::FormatText(const sdktrace::SpanData &span)
+{
+  char trace_id[32];
+  char span_id[16];
+  char parent_span_id[16];
+  span.GetTraceId().ToLowerBase16(trace_id);
+  span.GetSpanId().ToLowerBase16(span_id);
+  span.GetParentSpanId().ToLowerBase16(parent_span_id);
+
+  buffer_.Append("{\n  name          : ").Append(span.GetName());
+  buffer_.Append("\n  trace_id      : ").Append(nostd::string_view(trace_id, sizeof(trace_id)));
+  buffer_.Append("\n  span_id       : ").Append(nostd::string_view(span_id, sizeof(span_id)));
+  buffer_.Append("\n  parent_span_id: ")
+      .Append(nostd::string_view(parent_span_id, sizeof(parent_span_id)));
+  buffer_.Append("\n  start         : ").AppendInt(span.GetStartTime().time_since_epoch().count());
+  buffer_.Append("\n  duration      : ").AppendInt(span.GetDuration().count());
+  buffer_.Append("\n  description   : ").Append(span.GetDescription());
+  buffer_.Append("\n  status        : ").Append(GetStatusName(span.GetStatus()));
+  buffer_.Append("\n  attributes    : ");
+  bool first = true;
+  for (auto &attribute : span.GetAttributes())
+  {
+    if (!first)
     {
+      buffer_.Append(", ");
+    }
+    first = false;
+    buffer_.Append(attribute.first).Append(": ");
+    FormatValue(attribute.second);
+  }
+  buffer_.Append("\n}\n");
+}
+
+void OStreamSpanExporter::FormatJson(const sdktrace::SpanData &span)
+{
+  char trace_id[32];
+  char span_id[16];
+  char parent_span_id[16];
+  span.GetTraceId().ToLowerBase16(trace_id);
+  span.GetSpanId().ToLowerBase16(span_id);
+  span.GetParentSpanId().ToLowerBase16(parent_span_id);
 
-      char trace_id[32]       = {0};
-      char span_id[16]        = {0};
-      char parent_span_id[16] = {0};
-
-      span->GetTraceId().ToLowerBase16(trace_id);
-      span->GetSpanId().ToLowerBase16(span_id);
-      span->GetParentSpanId().ToLowerBase16(parent_span_id);
-
-      sout_ << "{"
-            << "\n  name          : " << span->GetName()
-            << "\n  trace_id      : " << std::string(trace_id, 32)
-            << "\n  span_id       : " << std::string(span_id, 16)
-            << "\n  parent_span_id: " << std::string(parent_span_id, 16)
-            << "\n  start         : " << span->GetStartTime().time_since_epoch().count()
-            << "\n  duration      : " << span->GetDuration().count()
-            << "\n  description   : " << span->GetDescription()
-            << "\n  status        : " << statusMap[int(span->GetStatus())]
-            << "\n  attributes    : ";
-      printAttributes(span->GetAttributes());
-      sout_ << "\n}\n";
+  buffer_.Append("{\"name\":").AppendJsonString(span.GetName());
+  buffer_.Append(",\"trace_id\":\"").Append(nostd::string_view(trace_id, sizeof(trace_id)));
+  buffer_.Append("\",\"span_id\":\"").Append(nostd::string_view(span_id, sizeof(span_id)));
+  buffer_.Append("\",\"parent_span_id\":\"")
+      .Append(nostd::string_view(parent_span_id, sizeof(parent_span_id)));
+  buffer_.Append("\",\"start\":").AppendInt(span.GetStartTime().time_since_epoch().count());
+  buffer_.Append(",\"duration\":").AppendInt(span.GetDuration().count());
+  buffer_.Append(",\"description\":").AppendJsonString(span.GetDescription());
+  buffer_.Append(",\"status\":\"").Append(GetStatusName(span.GetStatus()));
+  buffer_.Append("\",\"attributes\":{");
+  bool first = true;
+  for (auto &attribute : span.GetAttributes())
+  {
+    if (!first)
+    {
+      buffer_.Append(',');
     }
+    first = false;
+    buffer_.AppendJsonString(attribute.first).Append(':');
+    FormatJsonValue(attribute.second);
   }
+  buffer_.Append("},\"events\":[");
+  first = true;
+  for (auto &event : span.GetEvents())
+  {
+    if (!first)
+    {
+      buffer_.Append(',');
+    }
+    first = false;
+    buffer_.Append("{\"name\":").AppendJsonString(event.GetName());
+    buffer_.Append(",\"timestamp\":")
+        .AppendInt(event.GetTimestamp().time_since_epoch().count())
+        .Append('}');
+  }
+  buffer_.Append("]}\n");
+}
 
-  return sdktrace::ExportResult::kSuccess;
+void OStreamSpanExporter::FormatValue(const sdktrace::SpanDataAttributeValue &value)
+{
+  nostd::visit(ValueFormatter{buffer_, false}, value);
+}
+
+void OStreamSpanExporter::FormatJsonValue(const sdktrace::SpanDataAttributeValue &value)
+{
+  nostd::visit(ValueFormatter{buffer_, true}, value);
 }
 
 void OStreamSpanExporter::Shutdown(std::chrono::microseconds timeout) noexcept
@@ -288,3 +288,37 @@ TEST(OStreamMetricsExporter, PrintSketch)
 
   ASSERT_EQ(stdoutOutput.str(), expectedOutput);
 }
+
+TEST(OStreamMetricsExporter, PrintJsonLines)
+{
+  std::stringstream output;
+  opentelemetry::exporter::metrics::OStreamMetricsExporter exporter(
+      output, opentelemetry::exporter::OStreamFormat::kJsonLines);
+
+  auto counter = std::shared_ptr<opentelemetry::sdk::metrics::Aggregator<double>>(
+      new opentelemetry::sdk::metrics::CounterAggregator<double>(
+          metrics_api::InstrumentKind::Counter));
+  counter->update(5.5);
+  counter->checkpoint();
+
+  auto mmsc = std::shared_ptr<opentelemetry::sdk::metrics::Aggregator<int>>(
+      new opentelemetry::sdk::metrics::MinMaxSumCountAggregator<int>(
+          metrics_api::InstrumentKind::Counter));
+  mmsc->update(1);
+  mmsc->update(2);
+  mmsc->checkpoint();
+
+  std::vector<sdkmetrics::Record> records;
+  records.push_back(sdkmetrics::Record("name", "description", "{\"key\":\"value\"}", counter));
+  records.push_back(sdkmetrics::Record("name2", "description2", "labels", mmsc));
+
+  exporter.Export(records);
+
+  std::string expectedOutput =
+      "{\"name\":\"name\",\"description\":\"description\","
+      "\"labels\":\"{\\\"key\\\":\\\"value\\\"}\",\"sum\":5.5}\n"
+      "{\"name\":\"name2\",\"description\":\"description2\",\"labels\":\"labels\","
+      "\"min\":1,\"max\":2,\"sum\":3,\"count\":2}\n";
+
+  ASSERT_EQ(output.str(), expectedOutput);
+}
@@ -267,3 +267,100 @@ TEST(OStreamSpanExporter, PrintChangedSpanClog)
       "}\n";
   ASSERT_EQ(stdclogOutput.str(), expectedOutput);
 }
+
+// An unbuffered stream buffer that counts how often it is written to
+class CountingStreamBuf : public std::streambuf
+{
+public:
+  std::string str() const { return data_; }
+
+  int writes = 0;
+
+protected:
+  std::streamsize xsputn(const char *s, std::streamsize n) override
+  {
+    ++writes;
+    data_.append(s, static_cast<size_t>(n));
+    return n;
+  }
+
+  int_type overflow(int_type c) override
+  {
+    ++writes;
+    data_.push_back(static_cast<char>(c));
+    return c;
+  }
+
+private:
+  std::string data_;
+};
+
+// Testing that a whole batch is written to the stream at once
+TEST(OStreamSpanExporter, WritesBatchOnce)
+{
+  CountingStreamBuf buf;
+  std::ostream sout(&buf);
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter(sout);
+
+  std::unique_ptr<sdktrace::Recordable> batch[3];
+  for (auto &recordable : batch)
+  {
+    recordable = exporter.MakeRecordable();
+    recordable->SetName("Test Span");
+    recordable->SetAttribute("attr1", 1.5);
+  }
+  exporter.Export(nostd::span<std::unique_ptr<sdktrace::Recordable>>(batch, 3));
+
+  EXPECT_EQ(buf.writes, 1);
+  EXPECT_NE(buf.str().find("attributes    : attr1: 1.5\n}\n{\n"), std::string::npos);
+}
+
+// Testing the JSON lines output format
+TEST(OStreamSpanExporter, PrintJsonLines)
+{
+  std::stringstream output;
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter(
+      output, opentelemetry::exporter::OStreamFormat::kJsonLines);
+
+  std::unique_ptr<sdktrace::Recordable> batch[2];
+  for (auto &recordable : batch)
+  {
+    recordable = exporter.MakeRecordable();
+  }
+
+  constexpr uint8_t trace_id_buf[] = {1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8};
+  constexpr uint8_t span_id_buf[]  = {1, 2, 3, 4, 5, 6, 7, 8};
+  batch[0]->SetIds(opentelemetry::trace::TraceId(trace_id_buf),
+                   opentelemetry::trace::SpanId(span_id_buf),
+                   opentelemetry::trace::SpanId(span_id_buf));
+  batch[0]->SetName("Test \"Span\"");
+  batch[0]->SetDuration(std::chrono::nanoseconds(100));
+  batch[0]->SetStatus(opentelemetry::trace::CanonicalCode::UNIMPLEMENTED, "Test\nDescription");
+  bool array1[] = {true, false};
+  batch[0]->SetAttribute("attr1", opentelemetry::nostd::span<const bool>{array1});
+  static_cast<sdktrace::Recordable &>(*batch[0])
+      .AddEvent("event", opentelemetry::core::SystemTimestamp(std::chrono::nanoseconds(5)));
+
+  exporter.Export(nostd::span<std::unique_ptr<sdktrace::Recordable>>(batch, 2));
+
+  std::string expectedOutput =
+      "{\"name\":\"Test \\\"Span\\\"\","
+      "\"trace_id\":\"01020304050607080102030405060708\","
+      "\"span_id\":\"0102030405060708\","
+      "\"parent_span_id\":\"0102030405060708\","
+      "\"start\":0,\"duration\":100,"
+      "\"description\":\"Test\\nDescription\","
+      "\"status\":\"UNIMPLEMENTED\","
+      "\"attributes\":{\"attr1\":[true,false]},"
+      "\"events\":[{\"name\":\"event\",\"timestamp\":5}]}\n"
+      "{\"name\":\"\","
+      "\"trace_id\":\"00000000000000000000000000000000\","
+      "\"span_id\":\"0000000000000000\","
+      "\"parent_span_id\":\"0000000000000000\","
+      "\"start\":0,\"duration\":0,"
+      "\"description\":\"\","
+      "\"status\":\"OK\","
+      "\"attributes\":{},"
+      "\"events\":[]}\n";
+  ASSERT_EQ(output.str(), expectedOutput);
+}
@@ -36,6 +36,8 @@ class Recordable final : public sdk::trace::Recordable
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override;
 
+  void SetDroppedCounts(uint32_t dropped_attributes, uint32_t dropped_events) noexcept override;
+
 private:
   proto::trace::v1::Span span_;
 };
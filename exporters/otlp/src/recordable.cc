@@ -164,6 +164,12 @@ void Recordable::SetDuration(std::chrono::nanoseconds duration) noexcept
   const uint64_t unix_end_time = span_.start_time_unix_nano() + duration.count();
   span_.set_end_time_unix_nano(unix_end_time);
 }
+
+void Recordable::SetDroppedCounts(uint32_t dropped_attributes, uint32_t dropped_events) noexcept
+{
+  span_.set_dropped_attributes_count(dropped_attributes);
+  span_.set_dropped_events_count(dropped_events);
+}
 }  // namespace otlp
 }  // namespace exporter
 OPENTELEMETRY_END_NAMESPACE
@@ -78,6 +78,15 @@ TEST(Recordable, SetStatus)
   EXPECT_EQ(rec.span().status().message(), description);
 }
 
+TEST(Recordable, SetDroppedCounts)
+{
+  Recordable rec;
+  rec.SetDroppedCounts(3, 5);
+
+  EXPECT_EQ(rec.span().dropped_attributes_count(), 3);
+  EXPECT_EQ(rec.span().dropped_events_count(), 5);
+}
+
 TEST(Recordable, AddEventDefault)
 {
   Recordable rec;
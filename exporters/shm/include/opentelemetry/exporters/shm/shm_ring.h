@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+struct ShmRingHeader;
+
+/**
+ * A lock-free ring buffer of variable-sized records in a POSIX shared memory
+ * object, with multiple concurrent producers and a single consumer, possibly
+ * in different processes.
+ *
+ * Like sdk::common::CircularBuffer, producers reserve space by advancing a
+ * shared head counter with compare-and-swap and the consumer advances a tail
+ * counter. Each record starts with a header word that the producer publishes
+ * once the payload is in place, so the consumer never observes a partially
+ * written record. Records never wrap; a producer that reaches the end of the
+ * buffer reserves the remainder as padding and continues at the start.
+ *
+ * If a producer dies between reserving and publishing a record, the consumer
+ * stalls at that record until the shared memory object is unlinked and
+ * recreated.
+ */
+class ShmRing
+{
+public:
+  /**
+   * Opens the shared memory object with the given name, creating and
+   * initializing it if it does not exist yet.
+   * @param name the name of the shared memory object, e.g. "/otel-spans"
+   * @param capacity the size of the data area in bytes when creating the
+   * object. It is rounded up to a power of two and must not exceed 1 GiB. It is
+   * ignored when an existing object is opened.
+   * @return the ring, or nullptr if the object could not be opened or the
+   * capacity is too large
+   */
+  static std::unique_ptr<ShmRing> Open(const std::string &name, size_t capacity) noexcept;
+
+  /**
+   * Removes the shared memory object with the given name. Processes that
+   * already mapped it keep using it.
+   */
+  static bool Unlink(const std::string &name) noexcept;
+
+  ~ShmRing();
+
+  /**
+   * Appends a record. This method can be called concurrently.
+   * @param record the record to append; it must not be empty
+   * @return true if the record was appended; false if there was not enough
+   * space, in which case the record is counted as dropped.
+   */
+  bool TryWrite(nostd::string_view record) noexcept;
+
+  /**
+   * Obtains the oldest published record. The returned view remains valid until
+   * the next call to Pop.
+   *
+   * Note: This method must only be called from the consumer.
+   * @param record set to the oldest record
+   * @return true if a record is available
+   */
+  bool Peek(nostd::string_view &record) noexcept;
+
+  /**
+   * Releases the record returned by the last successful call to Peek.
+   *
+   * Note: This method must only be called from the consumer.
+   */
+  void Pop() noexcept;
+
+  /**
+   * @return the size of the data area in bytes
+   */
+  size_t capacity() const noexcept { return capacity_; }
+
+  /**
+   * @return the number of records that producers dropped because the ring
+   * was full
+   */
+  uint64_t dropped_count() const noexcept;
+
+private:
+  ShmRing(int fd, void *mapping, size_t mapping_size) noexcept;
+
+  int fd_;
+  void *mapping_;
+  size_t mapping_size_;
+  ShmRingHeader *header_;
+  char *data_;
+  size_t capacity_;
+  uint64_t pending_span_ = 0;
+};
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "opentelemetry/exporters/shm/shm_ring.h"
+#include "opentelemetry/sdk/trace/exporter.h"
+#include "opentelemetry/version.h"
+
+#include <memory>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+/**
+ * The ShmSpanExporter hands spans to a sidecar process through a ShmRing in
+ * shared memory. Each span is written as one record in the format of
+ * sdk::trace::SpanDataSerializer; protocol encoding and network I/O are left
+ * to the sidecar, which drains the ring with a ShmSpanReader.
+ *
+ * Exporting never blocks: spans that don't fit into the ring are dropped.
+ *
+ * This exporter is only available on POSIX platforms.
+ */
+class ShmSpanExporter final : public sdk::trace::SpanExporter
+{
+public:
+  /**
+   * @param name the name of the shared memory object, e.g. "/otel-spans". It
+   * is created if the sidecar hasn't created it yet.
+   * @param capacity the size of the ring in bytes if it is created
+   */
+  explicit ShmSpanExporter(const std::string &name, size_t capacity = 16 * 1024 * 1024) noexcept;
+
+  std::unique_ptr<sdk::trace::Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Writes the spans to the ring.
+   * @return kFailure if the ring couldn't be opened or any span was dropped
+   */
+  sdk::trace::ExportResult Export(
+      const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept override;
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+private:
+  std::unique_ptr<ShmRing> ring_;
+
+  /* Reused buffer for encoding spans */
+  std::string buffer_;
+  bool is_shutdown_ = false;
+};
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
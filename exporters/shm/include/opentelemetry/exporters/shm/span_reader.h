@@ -0,0 +1,63 @@
+#pragma once
+
+#include "opentelemetry/exporters/shm/shm_ring.h"
+#include "opentelemetry/sdk/trace/exporter.h"
+#include "opentelemetry/version.h"
+
+#include <memory>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+/**
+ * The ShmSpanReader is the sidecar side of the ShmSpanExporter. It drains the
+ * spans that applications wrote to the ring and forwards them through any
+ * SpanExporter.
+ *
+ * There must only be one reader per shared memory object.
+ */
+class ShmSpanReader
+{
+public:
+  /**
+   * @param name the name of the shared memory object. It is created if no
+   * application has created it yet.
+   * @param capacity the size of the ring in bytes if it is created
+   */
+  explicit ShmSpanReader(const std::string &name, size_t capacity = 16 * 1024 * 1024) noexcept;
+
+  /**
+   * @return true if the shared memory object was opened
+   */
+  bool IsOpen() const noexcept { return ring_ != nullptr; }
+
+  /**
+   * Reads up to max_batch_size spans from the ring and exports them as a single
+   * batch. Spans are removed from the ring regardless of the export result.
+   * @param exporter the exporter to forward spans to
+   * @param max_batch_size the maximum number of spans to forward
+   * @return the number of spans read from the ring
+   */
+  size_t Drain(sdk::trace::SpanExporter &exporter, size_t max_batch_size = 512) noexcept;
+
+  /**
+   * @return the number of spans that applications dropped because the ring
+   * was full
+   */
+  uint64_t GetDroppedSpanCount() const noexcept;
+
+  /**
+   * @return the number of records that could not be decoded
+   */
+  uint64_t GetInvalidSpanCount() const noexcept { return invalid_spans_; }
+
+private:
+  std::unique_ptr<ShmRing> ring_;
+  uint64_t invalid_spans_ = 0;
+};
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,292 @@
+#include "opentelemetry/exporters/shm/shm_ring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+namespace
+{
+constexpr uint64_t kMagic   = 0x31474e49524d4853;  // "SHMRING1"
+constexpr size_t kAlignment = 8;
+
+/* Flags in the header word of a record */
+constexpr uint32_t kCommitted = 1u << 31;
+constexpr uint32_t kPadding   = 1u << 30;
+constexpr uint32_t kSizeMask  = kPadding - 1;
+
+/* The padding record at the end of the data area stores its size in the size
+ * bits, which bounds the capacity. */
+constexpr size_t kMaxCapacity = kPadding;
+
+/* How long to wait for a concurrent creator to initialize the object */
+constexpr auto kInitializationTimeout = std::chrono::seconds(1);
+
+size_t Align(size_t size) noexcept
+{
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+size_t RoundUpToPowerOfTwo(size_t size) noexcept
+{
+  size_t result = 4096;
+  while (result < size)
+  {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+/**
+ * The layout of the start of the shared memory object. The data area follows
+ * it. The counters are on separate cache lines so that producers and the
+ * consumer don't contend on them.
+ */
+struct ShmRingHeader
+{
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+
+  /* Bytes reserved by producers since creation */
+  alignas(64) std::atomic<uint64_t> head;
+
+  /* Bytes released by the consumer since creation */
+  alignas(64) std::atomic<uint64_t> tail;
+
+  alignas(64) std::atomic<uint64_t> dropped;
+};
+
+static_assert(sizeof(ShmRingHeader) % kAlignment == 0, "data area must be aligned");
+
+/**
+ * The header word of a record; the payload follows it.
+ */
+struct RecordHeader
+{
+  std::atomic<uint32_t> size_and_flags;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(RecordHeader) == kAlignment, "records must be aligned");
+
+std::unique_ptr<ShmRing> ShmRing::Open(const std::string &name, size_t capacity) noexcept
+{
+  if (capacity > kMaxCapacity)
+  {
+    return nullptr;
+  }
+
+  size_t data_size    = RoundUpToPowerOfTwo(capacity);
+  size_t mapping_size = sizeof(ShmRingHeader) + data_size;
+  bool created        = true;
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST)
+  {
+    created = false;
+    fd      = shm_open(name.c_str(), O_RDWR, 0600);
+  }
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+
+  if (created)
+  {
+    if (ftruncate(fd, static_cast<off_t>(mapping_size)) != 0)
+    {
+      close(fd);
+      shm_unlink(name.c_str());
+      return nullptr;
+    }
+  }
+  else
+  {
+    // The creator may not have sized the object yet.
+    auto deadline = std::chrono::steady_clock::now() + kInitializationTimeout;
+    struct stat st;
+    while (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) <= sizeof(ShmRingHeader))
+    {
+      if (std::chrono::steady_clock::now() > deadline)
+      {
+        close(fd);
+        return nullptr;
+      }
+      std::this_thread::yield();
+    }
+    mapping_size = static_cast<size_t>(st.st_size);
+  }
+
+  void *mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  auto header = static_cast<ShmRingHeader *>(mapping);
+  if (created)
+  {
+    // A new object is zero-filled, so only the capacity needs to be set before
+    // the object is marked as initialized.
+    header->capacity = data_size;
+    header->magic.store(kMagic, std::memory_order_release);
+  }
+  else
+  {
+    auto deadline = std::chrono::steady_clock::now() + kInitializationTimeout;
+    while (header->magic.load(std::memory_order_acquire) != kMagic)
+    {
+      if (std::chrono::steady_clock::now() > deadline)
+      {
+        munmap(mapping, mapping_size);
+        close(fd);
+        return nullptr;
+      }
+      std::this_thread::yield();
+    }
+    if (sizeof(ShmRingHeader) + header->capacity != mapping_size)
+    {
+      munmap(mapping, mapping_size);
+      close(fd);
+      return nullptr;
+    }
+  }
+
+  return std::unique_ptr<ShmRing>(new ShmRing(fd, mapping, mapping_size));
+}
+
+bool ShmRing::Unlink(const std::string &name) noexcept
+{
+  return shm_unlink(name.c_str()) == 0;
+}
+
+ShmRing::ShmRing(int fd, void *mapping, size_t mapping_size) noexcept
+    : fd_(fd),
+      mapping_(mapping),
+      mapping_size_(mapping_size),
+      header_(static_cast<ShmRingHeader *>(mapping)),
+      data_(static_cast<char *>(mapping) + sizeof(ShmRingHeader)),
+      capacity_(static_cast<size_t>(header_->capacity))
+{}
+
+ShmRing::~ShmRing()
+{
+  munmap(mapping_, mapping_size_);
+  close(fd_);
+}
+
+bool ShmRing::TryWrite(nostd::string_view record) noexcept
+{
+  uint64_t span = Align(sizeof(RecordHeader) + record.size());
+  if (record.size() == 0 || record.size() > kSizeMask || span > capacity_)
+  {
+    header_->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  uint64_t offset;
+  uint64_t needed;
+  while (true)
+  {
+    // Acquire the tail so that the consumer's release of the space happens
+    // before it is overwritten.
+    uint64_t tail   = header_->tail.load(std::memory_order_acquire);
+    offset          = head & (capacity_ - 1);
+    uint64_t to_end = capacity_ - offset;
+    needed          = span <= to_end ? span : to_end + span;
+    if (head + needed - tail > capacity_)
+    {
+      header_->dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (header_->head.compare_exchange_weak(head, head + needed, std::memory_order_relaxed,
+                                            std::memory_order_relaxed))
+    {
+      break;
+    }
+  }
+
+  if (needed != span)
+  {
+    // The record doesn't fit before the end of the data area; skip the rest.
+    auto padding = reinterpret_cast<RecordHeader *>(data_ + offset);
+    padding->size_and_flags.store(
+        static_cast<uint32_t>(needed - span) | kCommitted | kPadding, std::memory_order_release);
+    offset = 0;
+  }
+
+  auto header = reinterpret_cast<RecordHeader *>(data_ + offset);
+  memcpy(data_ + offset + sizeof(RecordHeader), record.data(), record.size());
+  header->size_and_flags.store(static_cast<uint32_t>(record.size()) | kCommitted,
+                               std::memory_order_release);
+  return true;
+}
+
+bool ShmRing::Peek(nostd::string_view &record) noexcept
+{
+  while (true)
+  {
+    uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    if (tail == header_->head.load(std::memory_order_relaxed))
+    {
+      return false;
+    }
+
+    uint64_t offset = tail & (capacity_ - 1);
+    auto header     = reinterpret_cast<RecordHeader *>(data_ + offset);
+    uint32_t word   = header->size_and_flags.load(std::memory_order_acquire);
+    if ((word & kCommitted) == 0)
+    {
+      // A producer reserved the record but hasn't finished writing it.
+      return false;
+    }
+
+    if ((word & kPadding) != 0)
+    {
+      pending_span_ = word & kSizeMask;
+      Pop();
+      continue;
+    }
+
+    size_t size   = word & kSizeMask;
+    record        = nostd::string_view{data_ + offset + sizeof(RecordHeader), size};
+    pending_span_ = Align(sizeof(RecordHeader) + size);
+    return true;
+  }
+}
+
+void ShmRing::Pop() noexcept
+{
+  if (pending_span_ == 0)
+  {
+    return;
+  }
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  // Clear the released space: records can start at any aligned offset, so stale
+  // bytes could otherwise be mistaken for a published header.
+  memset(data_ + (tail & (capacity_ - 1)), 0, pending_span_);
+  header_->tail.store(tail + pending_span_, std::memory_order_release);
+  pending_span_ = 0;
+}
+
+uint64_t ShmRing::dropped_count() const noexcept
+{
+  return header_->dropped.load(std::memory_order_relaxed);
+}
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,49 @@
+#include "opentelemetry/exporters/shm/span_exporter.h"
+
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+ShmSpanExporter::ShmSpanExporter(const std::string &name, size_t capacity) noexcept
+    : ring_(ShmRing::Open(name, capacity))
+{}
+
+std::unique_ptr<sdk::trace::Recordable> ShmSpanExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<sdk::trace::Recordable>(new sdk::trace::SpanData);
+}
+
+sdk::trace::ExportResult ShmSpanExporter::Export(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept
+{
+  if (is_shutdown_ || ring_ == nullptr)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  bool dropped = false;
+  for (auto &recordable : spans)
+  {
+    auto span = static_cast<const sdk::trace::SpanData *>(recordable.get());
+    if (span == nullptr)
+    {
+      continue;
+    }
+    buffer_.clear();
+    sdk::trace::SpanDataSerializer::Serialize(*span, buffer_);
+    dropped |= !ring_->TryWrite(buffer_);
+  }
+  return dropped ? sdk::trace::ExportResult::kFailure : sdk::trace::ExportResult::kSuccess;
+}
+
+void ShmSpanExporter::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  is_shutdown_ = true;
+}
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
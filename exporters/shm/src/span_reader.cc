@@ -0,0 +1,58 @@
+#include "opentelemetry/exporters/shm/span_reader.h"
+
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace shm
+{
+ShmSpanReader::ShmSpanReader(const std::string &name, size_t capacity) noexcept
+    : ring_(ShmRing::Open(name, capacity))
+{}
+
+size_t ShmSpanReader::Drain(sdk::trace::SpanExporter &exporter, size_t max_batch_size) noexcept
+{
+  if (ring_ == nullptr)
+  {
+    return 0;
+  }
+
+  std::vector<std::unique_ptr<sdk::trace::Recordable>> batch;
+  size_t count = 0;
+  nostd::string_view record;
+  while (count < max_batch_size && ring_->Peek(record))
+  {
+    auto recordable = exporter.MakeRecordable();
+    if (recordable != nullptr)
+    {
+      if (sdk::trace::SpanDataSerializer::Deserialize(record, *recordable))
+      {
+        batch.push_back(std::move(recordable));
+      }
+      else
+      {
+        ++invalid_spans_;
+      }
+    }
+    ring_->Pop();
+    ++count;
+  }
+
+  if (!batch.empty())
+  {
+    exporter.Export(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(batch.data(), batch.size()));
+  }
+  return count;
+}
+
+uint64_t ShmSpanReader::GetDroppedSpanCount() const noexcept
+{
+  return ring_ == nullptr ? 0 : ring_->dropped_count();
+}
+}  // namespace shm
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
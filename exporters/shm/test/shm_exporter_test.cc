@@ -0,0 +1,196 @@
+#include "opentelemetry/exporters/shm/span_exporter.h"
+#include "opentelemetry/exporters/shm/span_reader.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace opentelemetry::exporter::shm;
+using opentelemetry::sdk::trace::ExportResult;
+using opentelemetry::sdk::trace::Recordable;
+using opentelemetry::sdk::trace::SpanData;
+using opentelemetry::sdk::trace::SpanExporter;
+namespace nostd = opentelemetry::nostd;
+
+/**
+ * A stand-in for the exporter a sidecar forwards to; it keeps received spans.
+ */
+class CollectingSpanExporter final : public SpanExporter
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override
+  {
+    ++batches;
+    for (auto &recordable : spans)
+    {
+      std::unique_ptr<SpanData> span(static_cast<SpanData *>(recordable.release()));
+      names.push_back(std::string(span->GetName()));
+      this->spans.push_back(std::move(span));
+    }
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+  std::vector<std::unique_ptr<SpanData>> spans;
+  std::vector<std::string> names;
+  size_t batches = 0;
+};
+
+class ShmSpanExporterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    name_ = "/shm_exporter_test-" + std::to_string(getpid()) + "-" +
+            testing::UnitTest::GetInstance()->current_test_info()->name();
+    ShmRing::Unlink(name_);
+  }
+
+  void TearDown() override { ShmRing::Unlink(name_); }
+
+  ExportResult ExportSpans(SpanExporter &exporter, const std::string &prefix, int num_spans)
+  {
+    std::vector<std::unique_ptr<Recordable>> batch;
+    for (int i = 0; i < num_spans; ++i)
+    {
+      batch.push_back(exporter.MakeRecordable());
+      batch.back()->SetName(prefix + std::to_string(i));
+    }
+    return exporter.Export(nostd::span<std::unique_ptr<Recordable>>(batch.data(), batch.size()));
+  }
+
+  std::string name_;
+};
+
+TEST_F(ShmSpanExporterTest, ForwardsSpansToReader)
+{
+  ShmSpanExporter exporter(name_);
+  ShmSpanReader reader(name_);
+  ASSERT_TRUE(reader.IsOpen());
+
+  auto recordable = exporter.MakeRecordable();
+  recordable->SetName("span");
+  recordable->SetAttribute("key", "value");
+  std::unique_ptr<Recordable> batch[] = {std::move(recordable)};
+  EXPECT_EQ(exporter.Export(nostd::span<std::unique_ptr<Recordable>>(batch, 1)),
+            ExportResult::kSuccess);
+
+  CollectingSpanExporter collector;
+  EXPECT_EQ(reader.Drain(collector), 1);
+  ASSERT_EQ(collector.spans.size(), 1);
+  EXPECT_EQ(collector.spans[0]->GetName(), "span");
+  EXPECT_EQ(nostd::get<std::string>(collector.spans[0]->GetAttributes().at("key")), "value");
+  EXPECT_EQ(reader.Drain(collector), 0);
+}
+
+TEST_F(ShmSpanExporterTest, DrainsInBatches)
+{
+  ShmSpanExporter exporter(name_);
+  ShmSpanReader reader(name_);
+  CollectingSpanExporter collector;
+
+  ExportSpans(exporter, "span", 5);
+  EXPECT_EQ(reader.Drain(collector, 2), 2);
+  EXPECT_EQ(reader.Drain(collector, 2), 2);
+  EXPECT_EQ(reader.Drain(collector, 2), 1);
+  EXPECT_EQ(collector.batches, 3);
+  EXPECT_EQ(collector.names,
+            (std::vector<std::string>{"span0", "span1", "span2", "span3", "span4"}));
+}
+
+TEST_F(ShmSpanExporterTest, WrapsAround)
+{
+  // The smallest ring holds a few dozen spans, so this wraps many times.
+  ShmSpanExporter exporter(name_, 0);
+  ShmSpanReader reader(name_);
+  CollectingSpanExporter collector;
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < 200; ++i)
+  {
+    std::string prefix = "batch" + std::to_string(i) + "-";
+    ASSERT_EQ(ExportSpans(exporter, prefix, 7), ExportResult::kSuccess);
+    for (int j = 0; j < 7; ++j)
+    {
+      expected.push_back(prefix + std::to_string(j));
+    }
+    while (reader.Drain(collector) > 0)
+    {
+    }
+  }
+  EXPECT_EQ(collector.names, expected);
+  EXPECT_EQ(reader.GetDroppedSpanCount(), 0);
+}
+
+TEST_F(ShmSpanExporterTest, DropsWhenFull)
+{
+  ShmSpanExporter exporter(name_, 0);
+  ShmSpanReader reader(name_);
+  CollectingSpanExporter collector;
+
+  EXPECT_EQ(ExportSpans(exporter, "span", 1000), ExportResult::kFailure);
+  EXPECT_GT(reader.GetDroppedSpanCount(), 0);
+
+  while (reader.Drain(collector) > 0)
+  {
+  }
+  EXPECT_EQ(collector.names.size() + reader.GetDroppedSpanCount(), 1000);
+  EXPECT_EQ(collector.names.front(), "span0");
+
+  // Space is available again once the reader caught up.
+  EXPECT_EQ(ExportSpans(exporter, "more", 1), ExportResult::kSuccess);
+}
+
+TEST_F(ShmSpanExporterTest, RejectsOversizedCapacity)
+{
+  EXPECT_EQ(ShmRing::Open(name_, size_t{1} << 31), nullptr);
+  EXPECT_NE(ShmRing::Open(name_, 4096), nullptr);
+}
+
+TEST_F(ShmSpanExporterTest, ConcurrentProducers)
+{
+  ShmSpanReader reader(name_, 64 * 1024);
+  CollectingSpanExporter collector;
+
+  const int num_threads = 4;
+  const int num_spans   = 2000;
+  std::atomic<int> running{num_threads};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&, t] {
+      ShmSpanExporter exporter(name_);
+      for (int i = 0; i < num_spans; ++i)
+      {
+        ExportSpans(exporter, std::to_string(t) + "-", 1);
+      }
+      --running;
+    });
+  }
+  while (running > 0)
+  {
+    reader.Drain(collector);
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  while (reader.Drain(collector) > 0)
+  {
+  }
+
+  EXPECT_EQ(collector.names.size() + reader.GetDroppedSpanCount(), num_threads * num_spans);
+  EXPECT_EQ(reader.GetInvalidSpanCount(), 0);
+}
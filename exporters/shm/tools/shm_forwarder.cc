@@ -0,0 +1,67 @@
+// A sidecar that drains spans that applications export with the
+// ShmSpanExporter and forwards them through the OStreamSpanExporter.
+//
+// Usage: shm_forwarder [name] [capacity]
+
+#include "opentelemetry/exporters/ostream/span_exporter.h"
+#include "opentelemetry/exporters/shm/span_reader.h"
+
+#include <signal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace shm = opentelemetry::exporter::shm;
+
+namespace
+{
+std::atomic<bool> is_running{true};
+
+void Stop(int)
+{
+  is_running = false;
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  std::string name = argc > 1 ? argv[1] : "/otel-spans";
+  size_t capacity  = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16 * 1024 * 1024;
+
+  shm::ShmSpanReader reader(name, capacity);
+  if (!reader.IsOpen())
+  {
+    std::cerr << "Failed to open shared memory object " << name << std::endl;
+    return 1;
+  }
+
+  signal(SIGINT, Stop);
+  signal(SIGTERM, Stop);
+
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter;
+
+  // Back off while the ring is empty, but stay responsive under load.
+  const auto max_idle_interval = std::chrono::milliseconds(50);
+  auto idle_interval           = std::chrono::milliseconds(1);
+  while (is_running)
+  {
+    if (reader.Drain(exporter) > 0)
+    {
+      idle_interval = std::chrono::milliseconds(1);
+      continue;
+    }
+    std::this_thread::sleep_for(idle_interval);
+    idle_interval = std::min(idle_interval * 2, max_idle_interval);
+  }
+
+  while (reader.Drain(exporter) > 0)
+  {
+  }
+  exporter.Shutdown();
+  std::cerr << "Spans dropped by applications: " << reader.GetDroppedSpanCount() << std::endl;
+  return 0;
+}
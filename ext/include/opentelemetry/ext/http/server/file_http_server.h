@@ -1,7 +1,12 @@
 #pragma once
 
+#include <sys/stat.h>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -24,7 +29,7 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
     std::ostringstream os;
     os << host << ":" << port;
     setServerName(os.str());
-    addListeningPort(port);
+    port_ = addListeningPort(port);
   };
 
   /**
@@ -35,7 +40,141 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
    */
   void InitializeFileEndpoint(FileHttpServer &server) { server[root_endpt_] = ServeFile; }
 
+  /**
+   * @returns the port the server listens on
+   */
+  int GetPort() const { return port_; }
+
 private:
+  /**
+   * A file as it was when it was loaded. The cached entry is replaced when the
+   * modification time or size of the file changes.
+   */
+  struct CachedFile
+  {
+    int64_t mtime_ns;
+    size_t size;
+    std::string etag;
+    std::string last_modified;
+    std::shared_ptr<HTTP_SERVER_NS::HttpSharedBody const> body;
+  };
+
+  enum RangeResult
+  {
+    kNoRange,
+    kSatisfiable,
+    kUnsatisfiable
+  };
+
+  /**
+   * Returns the modification time of a file in nanoseconds, so that a file
+   * rewritten within a second isn't taken for unchanged where the system
+   * tracks finer times
+   */
+  static int64_t GetModificationTime(const struct stat &file_stat)
+  {
+#if defined(__linux__)
+    return static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    return static_cast<int64_t>(file_stat.st_mtimespec.tv_sec) * 1000000000 +
+           file_stat.st_mtimespec.tv_nsec;
+#else
+    return static_cast<int64_t>(file_stat.st_mtime) * 1000000000;
+#endif
+  }
+
+  /**
+   * Return the cached file whose location is searched for relative to where
+   * the executable was triggered, loading it if it isn't cached or changed
+   * since it was cached. Files larger than kMaxInMemoryFileSize are kept open
+   * and sent with sendfile() on Linux instead of being read into memory.
+   * @param name of the file to look for
+   * @returns the file, or nullptr if no regular file was found
+   */
+  std::shared_ptr<const CachedFile> GetFile(std::string filename)
+  {
+#ifdef _WIN32
+    std::replace(filename.begin(), filename.end(), '/', '\\');
+#endif
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) != 0 || (file_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+      return nullptr;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      auto cached = file_cache_.find(filename);
+      if (cached != file_cache_.end() &&
+          cached->second->mtime_ns == GetModificationTime(file_stat) &&
+          cached->second->size == static_cast<size_t>(file_stat.st_size))
+      {
+        return cached->second;
+      }
+    }
+
+    std::shared_ptr<CachedFile> file(new CachedFile());
+    std::shared_ptr<HTTP_SERVER_NS::HttpSharedBody> body(new HTTP_SERVER_NS::HttpSharedBody());
+    file->mtime_ns = GetModificationTime(file_stat);
+#ifdef __linux__
+    if (static_cast<size_t>(file_stat.st_size) > kMaxInMemoryFileSize)
+    {
+      body->fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+      if (body->fd < 0 || fstat(body->fd, &file_stat) != 0)
+      {
+        return nullptr;
+      }
+      file->mtime_ns = GetModificationTime(file_stat);
+      body->size     = static_cast<size_t>(file_stat.st_size);
+    }
+    else
+#endif
+    {
+      if (!FileGetSuccess(filename, body->data))
+      {
+        return nullptr;
+      }
+      body->size = body->data.size();
+    }
+    file->size = body->size;
+    file->body = std::move(body);
+
+    std::ostringstream etag;
+    etag << '"' << std::hex << file->mtime_ns << '-' << file->size << '"';
+    file->etag          = etag.str();
+    file->last_modified = formatTimestamp(static_cast<time_t>(file->mtime_ns / 1000000000));
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto &cached = file_cache_[filename];
+    if (cached != nullptr)
+    {
+      cache_size_ -= cached->body->data.size();
+      cached_open_files_ -= (cached->body->fd >= 0) ? 1 : 0;
+    }
+    cache_size_ += file->body->data.size();
+    cached_open_files_ += (file->body->fd >= 0) ? 1 : 0;
+    cached = file;
+    // The cache is emptied when it grows too large; responses being sent keep
+    // their files alive until they are sent
+    if (cache_size_ > kMaxCacheSize || file_cache_.size() > kMaxCachedFiles)
+    {
+      file_cache_.clear();
+      cache_size_        = 0;
+      cached_open_files_ = 0;
+    }
+    else if (cached_open_files_ > kMaxCachedOpenFiles)
+    {
+      // Each of these files holds a descriptor, so they are dropped sooner
+      // than files held in memory
+      for (auto it = file_cache_.begin(); it != file_cache_.end();)
+      {
+        it = (it->second->body->fd >= 0) ? file_cache_.erase(it) : std::next(it);
+      }
+      cached_open_files_ = 0;
+    }
+    return file;
+  }
+
   /**
    * Return whether a file is found whose location is searched for relative to
    * where the executable was triggered. If the file is valid, fill result with
@@ -46,11 +185,8 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
    * @returns whether a file was found and result filled with display
    * information
    */
-  bool FileGetSuccess(const std::string &filename, std::vector<char> &result)
+  bool FileGetSuccess(const std::string &filename, std::string &result)
   {
-#ifdef _WIN32
-    std::replace(filename.begin(), filename.end(), '/', '\\');
-#endif
     std::streampos size;
     std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
     if (file.is_open())
@@ -60,7 +196,7 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
       {
         result.resize(size);
         file.seekg(0, std::ios::beg);
-        file.read(result.data(), size);
+        file.read(&result[0], size);
       }
       file.close();
       return true;
@@ -81,13 +217,14 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
   };
 
   /**
-   * Returns the standardized name of a file by removing backslashes, and
-   * assuming index.html is the wanted file if a directory is given
+   * Returns the standardized name of a file by removing backslashes and the
+   * query, and assuming index.html is the wanted file if a directory is given
    * @param name of the file
    */
   std::string GetFileName(std::string name)
   {
-    if (name.back() == '/')
+    name = name.substr(0, name.find('?'));
+    if (!name.empty() && name.back() == '/')
     {
       auto temp = name.substr(0, name.size() - 1);
       name      = temp;
@@ -100,9 +237,136 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
     return name;
   }
 
+  /**
+   * Returns whether a file name taken from a URI stays in the folder files are
+   * served from, so that it is neither absolute nor leaves it through ".."
+   * @param name of the file, without the leading slash of the URI
+   */
+  static bool IsServableFileName(const std::string &name)
+  {
+    if (name.empty() || name[0] == '/' || name[0] == '\\' || name.find("..") != std::string::npos)
+    {
+      return false;
+    }
+#ifdef _WIN32
+    // Drive letters, and alternate data streams
+    if (name.find(':') != std::string::npos)
+    {
+      return false;
+    }
+#endif
+    return true;
+  }
+
+  /**
+   * Returns the value of a request header, or an empty string if the request
+   * doesn't have it
+   */
+  static std::string GetHeader(HTTP_SERVER_NS::HttpRequest const &req, const char *name)
+  {
+    opentelemetry::nostd::string_view value;
+    if (req.parsed != nullptr && req.parsed->getHeader(name, value))
+    {
+      return std::string(value.data(), value.size());
+    }
+    auto header = req.headers.find(name);
+    return (header != req.headers.end()) ? header->second : std::string();
+  }
+
+  /**
+   * Returns whether the entity tag matches the value of an If-None-Match
+   * header, using the weak comparison of RFC 7232
+   */
+  static bool MatchesETag(const std::string &if_none_match, const std::string &etag)
+  {
+    size_t pos = 0;
+    while (pos < if_none_match.size())
+    {
+      size_t end = if_none_match.find(',', pos);
+      if (end == std::string::npos)
+      {
+        end = if_none_match.size();
+      }
+      size_t begin = if_none_match.find_first_not_of(" \t", pos);
+      size_t last  = if_none_match.find_last_not_of(" \t", end - 1);
+      if (begin < end && last != std::string::npos && last >= begin)
+      {
+        std::string tag = if_none_match.substr(begin, last - begin + 1);
+        if (tag.compare(0, 2, "W/") == 0)
+        {
+          tag.erase(0, 2);
+        }
+        if (tag == "*" || tag == etag)
+        {
+          return true;
+        }
+      }
+      pos = end + 1;
+    }
+    return false;
+  }
+
+  /**
+   * Parses a Range header with a single byte range. Multiple ranges aren't
+   * supported, and such requests are answered with the whole file.
+   * @param range is the value of the Range header
+   * @param size is the size of the file
+   * @param first and last are set to the first and last byte of the range
+   */
+  static RangeResult ParseRange(const std::string &range, size_t size, size_t &first, size_t &last)
+  {
+    const std::string prefix = "bytes=";
+    if (range.compare(0, prefix.size(), prefix) != 0 || range.find(',') != std::string::npos)
+    {
+      return kNoRange;
+    }
+    size_t dash = range.find('-', prefix.size());
+    if (dash == std::string::npos)
+    {
+      return kNoRange;
+    }
+    std::string first_str = range.substr(prefix.size(), dash - prefix.size());
+    std::string last_str  = range.substr(dash + 1);
+    if ((first_str.empty() && last_str.empty()) ||
+        first_str.find_first_not_of("0123456789") != std::string::npos ||
+        last_str.find_first_not_of("0123456789") != std::string::npos ||
+        first_str.size() > 18 || last_str.size() > 18)
+    {
+      return kNoRange;
+    }
+
+    if (first_str.empty())
+    {
+      // The last bytes of the file
+      size_t suffix = std::stoull(last_str);
+      if (suffix == 0 || size == 0)
+      {
+        return kUnsatisfiable;
+      }
+      first = (suffix < size) ? size - suffix : 0;
+      last  = size - 1;
+      return kSatisfiable;
+    }
+
+    first = std::stoull(first_str);
+    last  = last_str.empty() ? size - 1 : std::stoull(last_str);
+    if (first >= size)
+    {
+      return kUnsatisfiable;
+    }
+    if (last < first)
+    {
+      return kNoRange;
+    }
+    last = std::min(last, size - 1);
+    return kSatisfiable;
+  }
+
   /**
    * Sets the response object with the correct file data based on the requested
-   * file address, or return 404 error if a file isn't found
+   * file address, or return 404 error if a file isn't found. The file data is
+   * shared with the cache instead of being copied into the response, and
+   * conditional and range requests are answered from the cached file.
    * @param req is the HTTP request, which we use to figure out the response to
    * send
    * @param resp is the HTTP response we want to send to the frontend, including
@@ -110,16 +374,62 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
    */
   HTTP_SERVER_NS::HttpRequestCallback ServeFile{
       [&](HTTP_SERVER_NS::HttpRequest const &req, HTTP_SERVER_NS::HttpResponse &resp) {
-        LOG_INFO("File: %s\n", req.uri.c_str());
-        auto f        = GetFileName(req.uri);
-        auto filename = f.c_str() + 1;
+        std::string uri = req.uri;
+        if (req.parsed != nullptr)
+        {
+          uri.assign(req.parsed->uri().data(), req.parsed->uri().size());
+        }
+        LOG_INFO("File: %s\n", uri.c_str());
+        std::string filename = GetFileName(uri).substr(1);
 
-        std::vector<char> content;
-        if (FileGetSuccess(filename, content))
+        auto file = IsServableFileName(filename) ? GetFile(filename) : nullptr;
+        if (file != nullptr)
         {
           resp.headers[HTTP_SERVER_NS::CONTENT_TYPE] = GetMimeContentType(filename);
-          resp.body                                  = std::string(content.data(), content.size());
-          resp.code                                  = 200;
+          resp.headers["ETag"]                       = file->etag;
+          resp.headers["Last-Modified"]              = file->last_modified;
+          resp.headers["Accept-Ranges"]              = "bytes";
+
+          std::string if_none_match = GetHeader(req, "If-None-Match");
+          if (!if_none_match.empty() && MatchesETag(if_none_match, file->etag))
+          {
+            resp.code    = 304;
+            resp.message = HTTP_SERVER_NS::HttpServer::getDefaultResponseMessage(resp.code);
+            return resp.code;
+          }
+
+          size_t first         = 0;
+          size_t last          = 0;
+          RangeResult range    = kNoRange;
+          std::string if_range = GetHeader(req, "If-Range");
+          if (if_range.empty() || if_range == file->etag)
+          {
+            range = ParseRange(GetHeader(req, "Range"), file->size, first, last);
+          }
+          if (range == kUnsatisfiable)
+          {
+            resp.headers["Content-Range"] = "bytes */" + std::to_string(file->size);
+            resp.code                     = 416;
+            resp.message = HTTP_SERVER_NS::HttpServer::getDefaultResponseMessage(resp.code);
+            return resp.code;
+          }
+
+          resp.sharedBody = file->body;
+          if (range == kSatisfiable)
+          {
+            resp.headers["Content-Range"] = "bytes " + std::to_string(first) + "-" +
+                                            std::to_string(last) + "/" +
+                                            std::to_string(file->size);
+            resp.sharedBodyOffset = first;
+            resp.sharedBodyLength = last - first + 1;
+            resp.code             = 206;
+          }
+          else
+          {
+            resp.sharedBodyOffset = 0;
+            resp.sharedBodyLength = file->size;
+            resp.code             = 200;
+          }
           resp.message = HTTP_SERVER_NS::HttpServer::getDefaultResponseMessage(resp.code);
           return resp.code;
         }
@@ -133,6 +443,20 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
         return 404;
       }};
 
+  // Files larger than this are sent from the file rather than from memory
+  static constexpr size_t kMaxInMemoryFileSize = 256 * 1024;
+  // Limits of the memory held by the cache, and of the number of files in it
+  static constexpr size_t kMaxCacheSize   = 64 * 1024 * 1024;
+  static constexpr size_t kMaxCachedFiles = 1024;
+  // Limit of the files in the cache that are kept open, far below the usual
+  // limit of 1024 descriptors per process
+  static constexpr size_t kMaxCachedOpenFiles = 64;
+
+  std::mutex cache_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const CachedFile>> file_cache_;
+  size_t cache_size_        = 0;
+  size_t cached_open_files_ = 0;
+
   // Maps file extensions to their HTTP-compatible mime file type
   const std::unordered_map<std::string, std::string> mime_types_ = {
       {"css", "text/css"},   {"png", "image/png"},  {"js", "text/javascript"},
@@ -140,6 +464,7 @@ class FileHttpServer : public HTTP_SERVER_NS::HttpServer
       {"txt", "text/plain"}, {"jpg", "image/jpeg"}, {"jpeg", "image/jpeg"},
   };
   const std::string root_endpt_ = "/";
+  int port_;
 };
 
 }  // namespace HTTP_SERVER_NS
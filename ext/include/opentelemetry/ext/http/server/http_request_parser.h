@@ -0,0 +1,273 @@
+// Copyright 2020, OpenTelemetry Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "opentelemetry/nostd/string_view.h"
+
+#ifndef HTTP_SERVER_NS
+#  define HTTP_SERVER_NS testing
+#endif
+
+namespace HTTP_SERVER_NS
+{
+
+// Parses the request line and headers of an HTTP request without copying
+// them. The parser is fed the buffer holding everything received for the
+// request so far, and resumes where the previous call stopped, so no byte is
+// scanned twice. Parsed values are views into the buffer passed to the last
+// call of parse(), valid until that buffer is modified. Headers are kept in a
+// flat array that is reused across requests.
+class HttpRequestParser
+{
+public:
+  enum Result
+  {
+    Incomplete,
+    Complete,
+    Invalid
+  };
+
+  struct Header
+  {
+    opentelemetry::nostd::string_view name;
+    opentelemetry::nostd::string_view value;
+  };
+
+  // Prepares the parser for the next request.
+  void reset()
+  {
+    m_state    = RequestLine;
+    m_pos      = 0;
+    m_scan     = 0;
+    m_method   = {0, 0};
+    m_uri      = {0, 0};
+    m_protocol = {0, 0};
+    m_headers.clear();
+  }
+
+  // Parses the request line and headers held by the buffer. The buffer must
+  // start with the bytes passed to the previous calls since reset(), but may
+  // have been moved. Once the request is complete, further calls only update
+  // the buffer the parsed values point into.
+  Result parse(char const *data, size_t size)
+  {
+    m_data = data;
+    while (m_state != Done)
+    {
+      if (m_state == Failed)
+      {
+        return Invalid;
+      }
+      char const *eol = static_cast<char const *>(memchr(data + m_scan, '\n', size - m_scan));
+      if (eol == nullptr)
+      {
+        m_scan = size;
+        return Incomplete;
+      }
+      size_t next = static_cast<size_t>(eol - data) + 1;
+      size_t end  = next - 1;
+      if (end > m_pos && data[end - 1] == '\r')
+      {
+        end--;
+      }
+      bool valid = (m_state == RequestLine) ? parseRequestLine(m_pos, end)
+                                            : parseHeaderLine(m_pos, end);
+      m_pos  = next;
+      m_scan = next;
+      if (!valid)
+      {
+        m_state = Failed;
+      }
+    }
+    return Complete;
+  }
+
+  // Returns whether the request line and all headers were parsed.
+  bool complete() const { return m_state == Done; }
+
+  // Returns the number of bytes of the request line and headers, including
+  // the empty line that ends them, or the number of bytes parsed so far if
+  // the request isn't complete yet.
+  size_t headersLength() const { return m_pos; }
+
+  opentelemetry::nostd::string_view method() const { return view(m_method); }
+
+  opentelemetry::nostd::string_view uri() const { return view(m_uri); }
+
+  opentelemetry::nostd::string_view protocol() const { return view(m_protocol); }
+
+  size_t headerCount() const { return m_headers.size(); }
+
+  Header header(size_t index) const
+  {
+    return {view(m_headers[index].name), view(m_headers[index].value)};
+  }
+
+  // Looks up the first header with the given name, ignoring case.
+  bool getHeader(opentelemetry::nostd::string_view name,
+                 opentelemetry::nostd::string_view &value) const
+  {
+    for (auto const &header : m_headers)
+    {
+      if (equalsIgnoreCase(view(header.name), name))
+      {
+        value = view(header.value);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool equalsIgnoreCase(opentelemetry::nostd::string_view a,
+                               opentelemetry::nostd::string_view b)
+  {
+    if (a.size() != b.size())
+    {
+      return false;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+      if (toLower(a[i]) != toLower(b[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  struct Range
+  {
+    size_t begin;
+    size_t end;
+  };
+
+  struct HeaderRange
+  {
+    Range name;
+    Range value;
+  };
+
+  enum State
+  {
+    RequestLine,
+    Headers,
+    Done,
+    Failed
+  };
+
+  static char toLower(char ch)
+  {
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+  }
+
+  opentelemetry::nostd::string_view view(Range range) const
+  {
+    return opentelemetry::nostd::string_view(m_data + range.begin, range.end - range.begin);
+  }
+
+  // Parses a token that ends at a space or at the end of the line.
+  bool parseToken(size_t &pos, size_t end, Range &token) const
+  {
+    token.begin = pos;
+    while (pos < end && m_data[pos] != ' ')
+    {
+      pos++;
+    }
+    token.end = pos;
+    return token.end > token.begin;
+  }
+
+  bool parseRequestLine(size_t pos, size_t end)
+  {
+    // Empty lines before the request line are ignored (RFC 7230, 3.5)
+    if (pos == end)
+    {
+      return true;
+    }
+    if (!parseToken(pos, end, m_method) || pos == end)
+    {
+      return false;
+    }
+    while (pos < end && m_data[pos] == ' ')
+    {
+      pos++;
+    }
+    if (!parseToken(pos, end, m_uri) || pos == end)
+    {
+      return false;
+    }
+    while (pos < end && m_data[pos] == ' ')
+    {
+      pos++;
+    }
+    if (!parseToken(pos, end, m_protocol) || pos != end)
+    {
+      return false;
+    }
+    m_state = Headers;
+    return true;
+  }
+
+  bool parseHeaderLine(size_t pos, size_t end)
+  {
+    if (pos == end)
+    {
+      m_state = Done;
+      return true;
+    }
+
+    HeaderRange header;
+    header.name.begin = pos;
+    while (pos < end && m_data[pos] != ':' && m_data[pos] != ' ' && m_data[pos] != '\t')
+    {
+      pos++;
+    }
+    header.name.end = pos;
+    if (pos == end || m_data[pos] != ':' || header.name.end == header.name.begin)
+    {
+      return false;
+    }
+    pos++;
+
+    while (pos < end && (m_data[pos] == ' ' || m_data[pos] == '\t'))
+    {
+      pos++;
+    }
+    while (end > pos && (m_data[end - 1] == ' ' || m_data[end - 1] == '\t'))
+    {
+      end--;
+    }
+    header.value = {pos, end};
+    m_headers.push_back(header);
+    return true;
+  }
+
+  char const *m_data = nullptr;
+  State m_state      = RequestLine;
+  // Start of the line being parsed
+  size_t m_pos = 0;
+  // Where the search for the end of the line resumes
+  size_t m_scan = 0;
+  Range m_method{0, 0};
+  Range m_uri{0, 0};
+  Range m_protocol{0, 0};
+  std::vector<HeaderRange> m_headers;
+};
+
+}  // namespace HTTP_SERVER_NS
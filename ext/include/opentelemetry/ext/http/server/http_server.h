@@ -14,10 +14,15 @@
 
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
+#include <vector>
 
+#include "http_request_parser.h"
 #include "socket_tools.h"
 
 #ifdef HAVE_HTTP_DEBUG
@@ -41,11 +46,41 @@ constexpr const char *CONTENT_TYPE_BIN  = "application/octet-stream";
 struct HttpRequest
 {
   std::string client;
+  // The request line and headers are not copied in zero-copy mode, see
+  // HttpServer::setZeroCopyRequests()
   std::string method;
   std::string uri;
   std::string protocol;
   std::map<std::string, std::string> headers;
   std::string content;
+  // Views of the request line and headers, valid while the request is handled
+  HttpRequestParser const *parsed = nullptr;
+};
+
+// A response body shared between responses, such as a cached file. It is
+// held in memory, or on Linux as an open file sent with sendfile().
+struct HttpSharedBody
+{
+  std::string data;
+  // The file the body is sent from, if it isn't held in data
+  int fd      = -1;
+  size_t size = 0;
+
+  HttpSharedBody() = default;
+
+  HttpSharedBody(HttpSharedBody const &) = delete;
+
+  HttpSharedBody &operator=(HttpSharedBody const &) = delete;
+
+  ~HttpSharedBody()
+  {
+#ifndef _WIN32
+    if (fd >= 0)
+    {
+      ::close(fd);
+    }
+#endif
+  }
 };
 
 struct HttpResponse
@@ -54,6 +89,16 @@ struct HttpResponse
   std::string message;
   std::map<std::string, std::string> headers;
   std::string body;
+  // If set, the range of the shared body is sent instead of body, without
+  // copying it into the response
+  std::shared_ptr<HttpSharedBody const> sharedBody;
+  size_t sharedBodyOffset = 0;
+  size_t sharedBodyLength = 0;
+  // If set, the body is produced by this function after the handler returns,
+  // and sent with chunked transfer encoding as it is produced. Each call
+  // appends the next part of the body and returns false after the last part.
+  // It is called on the thread of the server, so it must own its state.
+  std::function<bool(std::string &chunk)> streamBody;
 };
 
 using CallbackFunction = std::function<int(HttpRequest const &request, HttpResponse &response)>;
@@ -95,16 +140,43 @@ class HttpRequestCallback
 //   - Support enough of HTTP to be used as a mock
 //   - Be flexible to allow creating various test scenarios
 // Out of scope:
-//   - Performance
 //   - Full support of RFC 7230-7237
-class HttpServer : private SocketTools::Reactor::SocketCallback
+//
+// The server runs one reactor thread by default. With setThreadCount(), it
+// runs several, each accepting and serving its own connections; handlers are
+// then called from all of them and must be thread-safe.
+class HttpServer
 {
 protected:
+  class Worker;
+
+  // Part of the responses to send on a connection, either held by the
+  // segment or shared with other responses
+  struct SendSegment
+  {
+    std::string data;
+    std::shared_ptr<HttpSharedBody const> body;
+    size_t offset;
+    size_t size;
+
+    char const *bytes() const
+    {
+      return (body != nullptr ? body->data.data() : data.data()) + offset;
+    }
+
+    bool isFile() const { return body != nullptr && body->fd >= 0; }
+  };
+
   struct Connection
   {
+    Worker *worker;
     SocketTools::Socket socket;
     std::string receiveBuffer;
-    std::string sendBuffer;
+    // Responses waiting to be sent, with the headers and bodies of consecutive
+    // responses sent together
+    std::deque<SendSegment> sendQueue;
+    // Whether the socket waits to become writable instead of readable
+    bool sendPending;
     enum
     {
       Idle,
@@ -112,20 +184,108 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
       Sending100Continue,
       ReceivingBody,
       Processing,
-      SendingHeaders,
-      SendingBody,
+      Sending,
       Closing
     } state;
     size_t contentLength;
     bool keepalive;
+    bool chunked;
+    HttpRequestParser parser;
     HttpRequest request;
     HttpResponse response;
   };
 
+  // Connections by socket. Sockets are small integers on POSIX systems, so
+  // there the connections are kept in a flat table indexed by socket.
+  class ConnectionTable
+  {
+  public:
+    Connection *find(SocketTools::Socket socket)
+    {
+#ifdef _WIN32
+      auto connIt = m_connections.find(socket);
+      return (connIt != m_connections.end()) ? &connIt->second : nullptr;
+#else
+      if (socket.invalid() || static_cast<size_t>(socket.m_sock) >= m_connections.size() ||
+          m_connections[socket.m_sock].socket.invalid())
+      {
+        return nullptr;
+      }
+      return &m_connections[socket.m_sock];
+#endif
+    }
+
+    Connection &insert(SocketTools::Socket socket)
+    {
+#ifdef _WIN32
+      Connection &conn = m_connections[socket];
+#else
+      if (static_cast<size_t>(socket.m_sock) >= m_connections.size())
+      {
+        m_connections.resize(socket.m_sock + 1);
+      }
+      Connection &conn = m_connections[socket.m_sock];
+#endif
+      // Nothing of a previous connection on the same socket may be left
+      conn        = Connection();
+      conn.socket = socket;
+      return conn;
+    }
+
+    void erase(SocketTools::Socket socket)
+    {
+#ifdef _WIN32
+      m_connections.erase(socket);
+#else
+      m_connections[socket.m_sock] = Connection();
+#endif
+    }
+
+  private:
+#ifdef _WIN32
+    std::map<SocketTools::Socket, Connection> m_connections;
+#else
+    std::vector<Connection> m_connections;
+#endif
+  };
+
+  // A reactor thread with its listening sockets and the connections it
+  // accepted. Connections stay on the worker that accepted them.
+  class Worker : public SocketTools::Reactor::SocketCallback
+  {
+  public:
+    HttpServer &m_server;
+    SocketTools::Reactor m_reactor;
+    std::list<SocketTools::Socket> m_listeningSockets;
+    ConnectionTable m_connections;
+
+    explicit Worker(HttpServer &server) : m_server(server), m_reactor(*this) {}
+
+    void onSocketAcceptable(SocketTools::Socket socket) override
+    {
+      m_server.onSocketAcceptable(*this, socket);
+    }
+
+    void onSocketReadable(SocketTools::Socket socket) override
+    {
+      m_server.onSocketReadable(*this, socket);
+    }
+
+    void onSocketWritable(SocketTools::Socket socket) override
+    {
+      m_server.onSocketWritable(*this, socket);
+    }
+
+    void onSocketClosed(SocketTools::Socket socket) override
+    {
+      m_server.onSocketClosed(*this, socket);
+    }
+  };
+
   std::string m_serverHost;
   bool allowKeepalive{true};
-  SocketTools::Reactor m_reactor;
-  std::list<SocketTools::Socket> m_listeningSockets;
+  bool m_zeroCopyRequests{false};
+  std::vector<std::unique_ptr<Worker>> m_workers;
 
   class HttpRequestHandler : public std::pair<std::string, HttpRequestCallback *>
   {
@@ -164,18 +324,31 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
   std::list<HttpRequestHandler> m_handlers;
 
-  std::map<SocketTools::Socket, Connection> m_connections;
   size_t m_maxRequestHeadersSize, m_maxRequestContentSize;
 
+  enum
+  {
+    // Limits of the buffers and bytes passed to a single send
+    MaxSendBuffers = 64,
+    MaxSendSize    = 1 << 30
+  };
+
 public:
   void setKeepalive(bool keepAlive) { allowKeepalive = keepAlive; }
 
+  // In zero-copy mode the request line and headers are not copied into the
+  // strings and the header map of HttpRequest, and handlers read them from
+  // HttpRequest::parsed instead.
+  void setZeroCopyRequests(bool zeroCopy) { m_zeroCopyRequests = zeroCopy; }
+
   HttpServer()
       : m_serverHost("unnamed"),
         allowKeepalive(true),
-        m_reactor(*this),
         m_maxRequestHeadersSize(8192),
-        m_maxRequestContentSize(2 * 1024 * 1024){};
+        m_maxRequestContentSize(2 * 1024 * 1024)
+  {
+    m_workers.emplace_back(new Worker(*this));
+  };
 
   HttpServer(std::string serverHost, int port = 30000) : HttpServer()
   {
@@ -187,9 +360,25 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
   ~HttpServer()
   {
-    for (auto &sock : m_listeningSockets)
+    for (auto &worker : m_workers)
     {
-      sock.close();
+      for (auto &sock : worker->m_listeningSockets)
+      {
+        sock.close();
+      }
+    }
+  }
+
+  // Sets the number of reactor threads. Must be called before any listening
+  // port is added.
+  void setThreadCount(size_t threadCount)
+  {
+    // No thread-safety here!
+    assert(m_workers.front()->m_listeningSockets.empty());
+    m_workers.resize(1);
+    while (m_workers.size() < threadCount)
+    {
+      m_workers.emplace_back(new Worker(*this));
     }
   }
 
@@ -201,22 +390,40 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
   void setServerName(std::string const &name) { m_serverHost = name; }
 
+  // Every worker listens on its own socket for the port, and the kernel
+  // balances new connections between them. Without SO_REUSEPORT only the
+  // first worker listens.
   int addListeningPort(int port)
   {
-    SocketTools::Socket socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    socket.setNonBlocking();
-    socket.setReuseAddr();
-
-    SocketTools::SocketAddr addr(0, port);
-    socket.bind(addr);
-    socket.getsockname(addr);
-
-    socket.listen(10);
-    m_listeningSockets.push_back(socket);
-    m_reactor.addSocket(socket, SocketTools::Reactor::Acceptable);
-    LOG_INFO("HttpServer: Listening on %s", addr.toString().c_str());
+    bool reusePort = false;
+    for (auto &worker : m_workers)
+    {
+      SocketTools::Socket socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      if (worker == m_workers.front())
+      {
+        reusePort = m_workers.size() > 1 && enableReusePort(socket);
+      }
+      else if (!reusePort || !enableReusePort(socket))
+      {
+        socket.close();
+        break;
+      }
+      socket.setNonBlocking();
+      socket.setReuseAddr();
+
+      SocketTools::SocketAddr addr(0, port);
+      socket.bind(addr);
+      socket.getsockname(addr);
+      // Later workers bind to the port that was picked for the first one
+      port = addr.port();
+
+      socket.listen(SOMAXCONN);
+      worker->m_listeningSockets.push_back(socket);
+      worker->m_reactor.addSocket(socket, SocketTools::Reactor::Acceptable);
+      LOG_INFO("HttpServer: Listening on %s", addr.toString().c_str());
+    }
 
-    return addr.port();
+    return port;
   }
 
   HttpRequestHandler &addHandler(const std::string &root, HttpRequestCallback &handler)
@@ -242,49 +449,72 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     return (*this);
   };
 
-  void start() { m_reactor.start(); }
+  void start()
+  {
+    for (auto &worker : m_workers)
+    {
+      worker->m_reactor.start();
+    }
+  }
 
-  void stop() { m_reactor.stop(); }
+  void stop()
+  {
+    for (auto &worker : m_workers)
+    {
+      worker->m_reactor.stop();
+    }
+  }
 
 protected:
-  virtual void onSocketAcceptable(SocketTools::Socket socket) override
+  // Lets several sockets listen on the same port. Returns false where that
+  // isn't supported.
+  virtual bool enableReusePort(SocketTools::Socket &socket) { return socket.setReusePort(); }
+
+  // The callbacks below are called on the thread of the worker, and only
+  // touch the state of that worker.
+  virtual void onSocketAcceptable(Worker &worker, SocketTools::Socket socket)
   {
     LOG_TRACE("HttpServer: accepting socket fd=0x%llx", socket.m_sock);
-    assert(std::find(m_listeningSockets.begin(), m_listeningSockets.end(), socket) !=
-           m_listeningSockets.end());
+    assert(std::find(worker.m_listeningSockets.begin(), worker.m_listeningSockets.end(),
+                     socket) != worker.m_listeningSockets.end());
 
     SocketTools::Socket csocket;
     SocketTools::SocketAddr caddr;
-    if (socket.accept(csocket, caddr))
+    // Accept all pending connections at once
+    while (socket.accept(csocket, caddr))
     {
       csocket.setNonBlocking();
-      Connection &conn    = m_connections[csocket];
-      conn.socket         = csocket;
+      Connection &conn    = worker.m_connections.insert(csocket);
+      conn.worker         = &worker;
+      conn.sendPending    = false;
       conn.state          = Connection::Idle;
       conn.request.client = caddr.toString();
-      m_reactor.addSocket(csocket, SocketTools::Reactor::Readable | SocketTools::Reactor::Closed);
+      worker.m_reactor.addSocket(csocket,
+                                 SocketTools::Reactor::Readable | SocketTools::Reactor::Closed);
       LOG_TRACE("HttpServer: [%s] accepted", conn.request.client.c_str());
     }
   }
 
-  virtual void onSocketReadable(SocketTools::Socket socket) override
+  virtual void onSocketReadable(Worker &worker, SocketTools::Socket socket)
   {
     LOG_TRACE("HttpServer: reading socket fd=0x%llx", socket.m_sock);
-    // No thread-safety here!
-    assert(std::find(m_listeningSockets.begin(), m_listeningSockets.end(), socket) ==
-           m_listeningSockets.end());
+    assert(std::find(worker.m_listeningSockets.begin(), worker.m_listeningSockets.end(),
+                     socket) == worker.m_listeningSockets.end());
 
-    // No thread-safety here!
-    auto connIt = m_connections.find(socket);
-    if (connIt == m_connections.end())
+    Connection *connPtr = worker.m_connections.find(socket);
+    if (connPtr == nullptr)
     {
       return;
     }
-    Connection &conn = connIt->second;
+    Connection &conn = *connPtr;
 
     char buffer[2048] = {0};
     int received      = socket.recv(buffer, sizeof(buffer));
     LOG_TRACE("HttpServer: [%s] received %d", conn.request.client.c_str(), received);
+    if (received < 0 && socket.error() == SocketTools::Socket::ErrorWouldBlock)
+    {
+      return;
+    }
     if (received <= 0)
     {
       handleConnectionClosed(conn);
@@ -295,21 +525,18 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     handleConnection(conn);
   }
 
-  virtual void onSocketWritable(SocketTools::Socket socket) override
+  virtual void onSocketWritable(Worker &worker, SocketTools::Socket socket)
   {
     LOG_TRACE("HttpServer: writing socket fd=0x%llx", socket.m_sock);
+    assert(std::find(worker.m_listeningSockets.begin(), worker.m_listeningSockets.end(),
+                     socket) == worker.m_listeningSockets.end());
 
-    // No thread-safety here!
-    assert(std::find(m_listeningSockets.begin(), m_listeningSockets.end(), socket) ==
-           m_listeningSockets.end());
-
-    // No thread-safety here!
-    auto connIt = m_connections.find(socket);
-    if (connIt == m_connections.end())
+    Connection *connPtr = worker.m_connections.find(socket);
+    if (connPtr == nullptr)
     {
       return;
     }
-    Connection &conn = connIt->second;
+    Connection &conn = *connPtr;
 
     if (!sendMore(conn))
     {
@@ -317,45 +544,203 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     }
   }
 
-  virtual void onSocketClosed(SocketTools::Socket socket) override
+  virtual void onSocketClosed(Worker &worker, SocketTools::Socket socket)
   {
     LOG_TRACE("HttpServer: closing socket fd=0x%llx", socket.m_sock);
-    assert(std::find(m_listeningSockets.begin(), m_listeningSockets.end(), socket) ==
-           m_listeningSockets.end());
+    assert(std::find(worker.m_listeningSockets.begin(), worker.m_listeningSockets.end(),
+                     socket) == worker.m_listeningSockets.end());
 
-    auto connIt = m_connections.find(socket);
-    if (connIt == m_connections.end())
+    Connection *connPtr = worker.m_connections.find(socket);
+    if (connPtr == nullptr)
     {
       return;
     }
-    Connection &conn = connIt->second;
+    Connection &conn = *connPtr;
 
     handleConnectionClosed(conn);
   }
 
+  // Sends as much of the queued responses as the socket takes, gathering
+  // consecutive segments held in memory into a single call. Returns whether
+  // there is more to send once the socket is writable again.
   bool sendMore(Connection &conn)
   {
-    if (conn.sendBuffer.empty())
+    while (!conn.sendQueue.empty())
     {
-      return false;
+      size_t size = 0;
+      int sent;
+#ifdef __linux__
+      if (conn.sendQueue.front().isFile())
+      {
+        SendSegment const &segment = conn.sendQueue.front();
+        size                       = std::min<size_t>(segment.size, MaxSendSize);
+        sent = conn.socket.sendFile(segment.body->fd, segment.offset, static_cast<unsigned>(size));
+        if (sent == 0)
+        {
+          // The file was truncated, the response can't be completed
+          LOG_WARN("HttpServer: [%s] shared body truncated", conn.request.client.c_str());
+          conn.socket.shutdown(SocketTools::Socket::ShutdownSend);
+          return true;
+        }
+      }
+      else
+#endif
+      {
+        SocketTools::Socket::Buffer buffers[MaxSendBuffers];
+        unsigned count = 0;
+        for (auto const &segment : conn.sendQueue)
+        {
+          size_t length = std::min<size_t>(segment.size, MaxSendSize - size);
+          if (count == MaxSendBuffers || segment.isFile() || length == 0)
+          {
+            break;
+          }
+          buffers[count++] = SocketTools::Socket::makeBuffer(segment.bytes(), length);
+          size += length;
+        }
+        sent = conn.socket.sendv(buffers, count);
+      }
+      LOG_TRACE("HttpServer: [%s] sent %d", conn.request.client.c_str(), sent);
+      if (sent < 0 && conn.socket.error() != SocketTools::Socket::ErrorWouldBlock)
+      {
+        return true;
+      }
+
+      for (size_t left = (sent > 0) ? sent : 0; left > 0;)
+      {
+        SendSegment &segment = conn.sendQueue.front();
+        size_t length        = std::min(left, segment.size);
+        segment.offset += length;
+        segment.size -= length;
+        left -= length;
+        if (segment.size == 0)
+        {
+          conn.sendQueue.pop_front();
+        }
+      }
+
+      if (sent < static_cast<int>(size))
+      {
+        conn.worker->m_reactor.addSocket(
+            conn.socket, SocketTools::Reactor::Writable | SocketTools::Reactor::Closed);
+        conn.sendPending = true;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Sends what is left of the responses, and then waits for the socket to
+  // become readable again.
+  void receiveMore(Connection &conn)
+  {
+    if (sendMore(conn))
+    {
+      return;
+    }
+    if (conn.sendPending)
+    {
+      conn.worker->m_reactor.addSocket(
+          conn.socket, SocketTools::Reactor::Readable | SocketTools::Reactor::Closed);
+      conn.sendPending = false;
     }
+  }
 
-    int sent = conn.socket.send(conn.sendBuffer.data(), static_cast<int>(conn.sendBuffer.size()));
-    LOG_TRACE("HttpServer: [%s] sent %d", conn.request.client.c_str(), sent);
-    if (sent < 0 && conn.socket.error() != SocketTools::Socket::ErrorWouldBlock)
+  static void queueData(Connection &conn, std::string data)
+  {
+    if (data.empty())
     {
-      return true;
+      return;
     }
-    conn.sendBuffer.erase(0, sent);
+    conn.sendQueue.emplace_back();
+    SendSegment &segment = conn.sendQueue.back();
+    segment.offset       = 0;
+    segment.size         = data.size();
+    segment.data         = std::move(data);
+  }
 
-    if (!conn.sendBuffer.empty())
+  static void queueSharedBody(Connection &conn,
+                              std::shared_ptr<HttpSharedBody const> body,
+                              size_t offset,
+                              size_t size)
+  {
+    if (size == 0)
     {
-      m_reactor.addSocket(conn.socket,
-                          SocketTools::Reactor::Writable | SocketTools::Reactor::Closed);
-      return true;
+      return;
     }
+    conn.sendQueue.emplace_back();
+    SendSegment &segment = conn.sendQueue.back();
+    segment.body         = std::move(body);
+    segment.offset       = offset;
+    segment.size         = size;
+  }
 
-    return false;
+  // Queues the status line, the headers and the body of the response.
+  void queueResponse(Connection &conn)
+  {
+    std::string headers;
+    headers.reserve(256);
+    if (conn.parser.complete())
+    {
+      headers.append(conn.parser.protocol().data(), conn.parser.protocol().size());
+    }
+    else
+    {
+      headers += "HTTP/1.1";
+    }
+    headers += ' ';
+    headers += std::to_string(conn.response.code);
+    headers += ' ';
+    headers += conn.response.message;
+    headers += "\r\n";
+    for (auto const &header : conn.response.headers)
+    {
+      headers += header.first;
+      headers += ": ";
+      headers += header.second;
+      headers += "\r\n";
+    }
+    headers += "\r\n";
+    queueData(conn, std::move(headers));
+
+    if (conn.response.sharedBody != nullptr)
+    {
+      queueSharedBody(conn, std::move(conn.response.sharedBody), conn.response.sharedBodyOffset,
+                      conn.response.sharedBodyLength);
+    }
+    else
+    {
+      queueData(conn, std::move(conn.response.body));
+    }
+  }
+
+  // Queues the next part of a streamed body.
+  void queueChunk(Connection &conn)
+  {
+    std::string chunk;
+    bool more = conn.response.streamBody(chunk);
+    if (!more)
+    {
+      conn.response.streamBody = nullptr;
+    }
+    if (!conn.chunked)
+    {
+      queueData(conn, std::move(chunk));
+      return;
+    }
+    if (!chunk.empty())
+    {
+      char size[24];
+      snprintf(size, sizeof(size), "%llx\r\n", static_cast<unsigned long long>(chunk.size()));
+      queueData(conn, size);
+      chunk += "\r\n";
+      queueData(conn, std::move(chunk));
+    }
+    if (!more)
+    {
+      queueData(conn, "0\r\n\r\n");
+    }
   }
 
 protected:
@@ -366,10 +751,11 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     {
       LOG_WARN("HttpServer: [%s] connection closed unexpectedly", conn.request.client.c_str());
     }
-    m_reactor.removeSocket(conn.socket);
-    auto connIt = m_connections.find(conn.socket);
-    conn.socket.close();
-    m_connections.erase(connIt);
+    Worker &worker             = *conn.worker;
+    SocketTools::Socket socket = conn.socket;
+    worker.m_reactor.removeSocket(socket);
+    worker.m_connections.erase(socket);
+    socket.close();
   }
 
   void handleConnection(Connection &conn)
@@ -378,6 +764,7 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     {
       if (conn.state == Connection::Idle)
       {
+        conn.parser.reset();
         conn.response.code = 0;
         conn.state         = Connection::ReceivingHeaders;
         LOG_TRACE("HttpServer: [%s] receiving headers", conn.request.client.c_str());
@@ -385,14 +772,11 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
       if (conn.state == Connection::ReceivingHeaders)
       {
-        bool lfOnly = false;
-        size_t ofs  = conn.receiveBuffer.find("\r\n\r\n");
-        if (ofs == std::string::npos)
-        {
-          lfOnly = true;
-          ofs    = conn.receiveBuffer.find("\n\n");
-        }
-        size_t headersLen = (ofs != std::string::npos) ? ofs : conn.receiveBuffer.length();
+        auto result =
+            conn.parser.parse(conn.receiveBuffer.data(), conn.receiveBuffer.length());
+        size_t headersLen = (result == HttpRequestParser::Complete)
+                                ? conn.parser.headersLength()
+                                : conn.receiveBuffer.length();
         if (headersLen > m_maxRequestHeadersSize)
         {
           LOG_WARN("HttpServer: [%s] headers too long - %u", conn.request.client.c_str(),
@@ -402,12 +786,13 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
           conn.state         = Connection::Processing;
           continue;
         }
-        if (ofs == std::string::npos)
+        if (result == HttpRequestParser::Incomplete)
         {
+          receiveMore(conn);
           return;
         }
 
-        if (!parseHeaders(conn))
+        if (result == HttpRequestParser::Invalid)
         {
           LOG_WARN("HttpServer: [%s] invalid headers", conn.request.client.c_str());
           conn.response.code = 400;  // Bad Request
@@ -415,33 +800,39 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
           conn.state         = Connection::Processing;
           continue;
         }
+        if (!m_zeroCopyRequests)
+        {
+          copyRequest(conn.parser, conn.request);
+        }
         LOG_INFO("HttpServer: [%s] %s %s %s", conn.request.client.c_str(),
-                 conn.request.method.c_str(), conn.request.uri.c_str(),
-                 conn.request.protocol.c_str());
-        conn.receiveBuffer.erase(0, ofs + (lfOnly ? 2 : 4));
+                 std::string(conn.parser.method().data(), conn.parser.method().size()).c_str(),
+                 std::string(conn.parser.uri().data(), conn.parser.uri().size()).c_str(),
+                 std::string(conn.parser.protocol().data(), conn.parser.protocol().size()).c_str());
 
-        conn.keepalive        = (conn.request.protocol == "HTTP/1.1");
-        auto const connection = conn.request.headers.find("Connection");
-        if (connection != conn.request.headers.end())
+        opentelemetry::nostd::string_view value;
+        conn.keepalive = (conn.parser.protocol() == "HTTP/1.1");
+        if (conn.parser.getHeader("Connection", value))
         {
-          if (equalsLowercased(connection->second, "keep-alive"))
+          if (HttpRequestParser::equalsIgnoreCase(value, "keep-alive"))
           {
             conn.keepalive = true;
           }
-          else if (equalsLowercased(connection->second, "close"))
+          else if (HttpRequestParser::equalsIgnoreCase(value, "close"))
           {
             conn.keepalive = false;
           }
         }
 
-        auto const contentLength = conn.request.headers.find("Content-Length");
-        if (contentLength != conn.request.headers.end())
+        conn.contentLength = 0;
+        if (conn.parser.getHeader("Content-Length", value) &&
+            !parseContentLength(value, conn.contentLength))
         {
-          conn.contentLength = atoi(contentLength->second.c_str());
-        }
-        else
-        {
-          conn.contentLength = 0;
+          LOG_WARN("HttpServer: [%s] invalid content length - %s", conn.request.client.c_str(),
+                   std::string(value.data(), value.size()).c_str());
+          conn.response.code = 400;  // Bad Request
+          conn.keepalive     = false;
+          conn.state         = Connection::Processing;
+          continue;
         }
         if (conn.contentLength > m_maxRequestContentSize)
         {
@@ -453,19 +844,18 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
           continue;
         }
 
-        auto const expect = conn.request.headers.find("Expect");
-        if (expect != conn.request.headers.end() && conn.request.protocol == "HTTP/1.1")
+        if (conn.parser.getHeader("Expect", value) && conn.parser.protocol() == "HTTP/1.1")
         {
-          if (!equalsLowercased(expect->second, "100-continue"))
+          if (!HttpRequestParser::equalsIgnoreCase(value, "100-continue"))
           {
             LOG_WARN("HttpServer: [%s] unknown expectation - %s", conn.request.client.c_str(),
-                     expect->second.c_str());
+                     std::string(value.data(), value.size()).c_str());
             conn.response.code = 417;  // Expectation Failed
             conn.keepalive     = false;
             conn.state         = Connection::Processing;
             continue;
           }
-          conn.sendBuffer = "HTTP/1.1 100 Continue\r\n\r\n";
+          queueData(conn, "HTTP/1.1 100 Continue\r\n\r\n");
           conn.state      = Connection::Sending100Continue;
           LOG_TRACE("HttpServer: [%s] sending \"100 Continue\"", conn.request.client.c_str());
           continue;
@@ -488,21 +878,17 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
       if (conn.state == Connection::ReceivingBody)
       {
-        if (conn.receiveBuffer.length() < conn.contentLength)
+        // The request line and headers stay in the receive buffer until the
+        // request is processed, as the parser refers to them
+        size_t headersLen = conn.parser.headersLength();
+        if (conn.receiveBuffer.length() < headersLen + conn.contentLength)
         {
+          receiveMore(conn);
           return;
         }
 
-        if (conn.receiveBuffer.length() == conn.contentLength)
-        {
-          conn.request.content = std::move(conn.receiveBuffer);
-          conn.receiveBuffer.clear();
-        }
-        else
-        {
-          conn.request.content.assign(conn.receiveBuffer, 0, conn.contentLength);
-          conn.receiveBuffer.erase(0, conn.contentLength);
-        }
+        conn.request.content.assign(conn.receiveBuffer, headersLen, conn.contentLength);
+        conn.parser.parse(conn.receiveBuffer.data(), conn.receiveBuffer.length());
 
         conn.state = Connection::Processing;
         LOG_TRACE("HttpServer: [%s] processing request", conn.request.client.c_str());
@@ -510,58 +896,60 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
 
       if (conn.state == Connection::Processing)
       {
-        processRequest(conn);
-
-        std::ostringstream os;
-        os << conn.request.protocol << ' ' << conn.response.code << ' ' << conn.response.message
-           << "\r\n";
-        for (auto const &header : conn.response.headers)
+        if (!processRequest(conn))
         {
-          os << header.first << ": " << header.second << "\r\n";
+          return;
         }
-        os << "\r\n";
-
-        conn.sendBuffer = os.str();
-        conn.state      = Connection::SendingHeaders;
-        LOG_TRACE("HttpServer: [%s] sending headers", conn.request.client.c_str());
-      }
-
-      if (conn.state == Connection::SendingHeaders)
-      {
-        if (sendMore(conn))
+        queueResponse(conn);
+        if (conn.parser.complete())
         {
-          return;
+          conn.receiveBuffer.erase(0, conn.parser.headersLength() + conn.contentLength);
         }
+        conn.keepalive &= allowKeepalive;
 
-        conn.sendBuffer = std::move(conn.response.body);
-        conn.state      = Connection::SendingBody;
-        LOG_TRACE("HttpServer: [%s] sending body", conn.request.client.c_str());
+        // The responses to pipelined requests are sent together, once all the
+        // requests received so far are handled
+        if (conn.keepalive && !conn.receiveBuffer.empty() && conn.response.streamBody == nullptr &&
+            conn.sendQueue.size() < MaxSendBuffers)
+        {
+          conn.state = Connection::Idle;
+          LOG_TRACE("HttpServer: [%s] idle (pipelined)", conn.request.client.c_str());
+          continue;
+        }
+        conn.state = Connection::Sending;
+        LOG_TRACE("HttpServer: [%s] sending response", conn.request.client.c_str());
       }
 
-      if (conn.state == Connection::SendingBody)
+      if (conn.state == Connection::Sending)
       {
-        if (sendMore(conn))
+        // Streamed bodies are produced as fast as the socket takes them
+        for (;;)
         {
-          return;
+          if (sendMore(conn))
+          {
+            return;
+          }
+          if (conn.response.streamBody == nullptr)
+          {
+            break;
+          }
+          queueChunk(conn);
         }
 
-        conn.keepalive &= allowKeepalive;
-
         if (conn.keepalive)
         {
-          m_reactor.addSocket(conn.socket,
-                              SocketTools::Reactor::Readable | SocketTools::Reactor::Closed);
           conn.state = Connection::Idle;
           LOG_TRACE("HttpServer: [%s] idle (keep-alive)", conn.request.client.c_str());
           if (conn.receiveBuffer.empty())
           {
+            receiveMore(conn);
             return;
           }
         }
         else
         {
           conn.socket.shutdown(SocketTools::Socket::ShutdownSend);
-          m_reactor.addSocket(conn.socket, SocketTools::Reactor::Closed);
+          conn.worker->m_reactor.addSocket(conn.socket, SocketTools::Reactor::Closed);
           conn.state = Connection::Closing;
           LOG_TRACE("HttpServer: [%s] closing", conn.request.client.c_str());
         }
@@ -574,125 +962,32 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     }
   }
 
-  bool parseHeaders(Connection &conn)
+  // Parses the value of a Content-Length header. Returns false if it isn't a
+  // number that fits a size_t.
+  static bool parseContentLength(opentelemetry::nostd::string_view value, size_t &length)
   {
-    // Method
-    char const *begin = conn.receiveBuffer.c_str();
-    char const *ptr   = begin;
-    while (*ptr && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
-    {
-      ptr++;
-    }
-    if (*ptr != ' ')
-    {
-      return false;
-    }
-    conn.request.method.assign(begin, ptr);
-    while (*ptr == ' ')
-    {
-      ptr++;
-    }
-
-    // URI
-    begin = ptr;
-    while (*ptr && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
-    {
-      ptr++;
-    }
-    if (*ptr != ' ')
-    {
-      return false;
-    }
-    conn.request.uri.assign(begin, ptr);
-    while (*ptr == ' ')
-    {
-      ptr++;
-    }
-
-    // Protocol
-    begin = ptr;
-    while (*ptr && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
-    {
-      ptr++;
-    }
-    if (*ptr != '\r' && *ptr != '\n')
+    if (value.empty())
     {
       return false;
     }
-    conn.request.protocol.assign(begin, ptr);
-    if (*ptr == '\r')
+    size_t parsed = 0;
+    for (char ch : value)
     {
-      ptr++;
-    }
-    if (*ptr != '\n')
-    {
-      return false;
-    }
-    ptr++;
-
-    // Headers
-    conn.request.headers.clear();
-    while (*ptr != '\r' && *ptr != '\n')
-    {
-      // Name
-      begin = ptr;
-      while (*ptr && *ptr != ':' && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
-      {
-        ptr++;
-      }
-      if (*ptr != ':')
+      if (ch < '0' || ch > '9')
       {
         return false;
       }
-      std::string name = normalizeHeaderName(begin, ptr);
-      ptr++;
-      while (*ptr == ' ')
-      {
-        ptr++;
-      }
-
-      // Value
-      begin = ptr;
-      while (*ptr && *ptr != '\r' && *ptr != '\n')
-      {
-        ptr++;
-      }
-      conn.request.headers[name] = std::string(begin, ptr);
-      if (*ptr == '\r')
-      {
-        ptr++;
-      }
-      if (*ptr != '\n')
+      size_t digit = static_cast<size_t>(ch - '0');
+      if (parsed > (SIZE_MAX - digit) / 10)
       {
         return false;
       }
-      ptr++;
+      parsed = parsed * 10 + digit;
     }
-
-    if (*ptr == '\r')
-    {
-      ptr++;
-    }
-    if (*ptr != '\n')
-    {
-      return false;
-    }
-    ptr++;
-
+    length = parsed;
     return true;
   }
 
-  static bool equalsLowercased(std::string const &str, char const *mask)
-  {
-    char const *ptr = str.c_str();
-    while (*ptr && *mask && ::tolower(*ptr) == *mask)
-    {
-      ptr++;
-      mask++;
-    }
-    return !*ptr && !*mask;
-  }
-
   static std::string normalizeHeaderName(char const *begin, char const *end)
   {
     std::string result(begin, end);
@@ -716,19 +1011,27 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     return result;
   }
 
-  void processRequest(Connection &conn)
+  // Returns false if the handler closed the connection, which then may not be
+  // used anymore.
+  bool processRequest(Connection &conn)
   {
     conn.response.message.clear();
     conn.response.headers.clear();
     conn.response.body.clear();
+    conn.response.sharedBody.reset();
+    conn.response.streamBody = nullptr;
+
+    // Set here, as connections may move in the connection table between calls
+    conn.request.parsed = &conn.parser;
 
     if (conn.response.code == 0)
     {
-      conn.response.code = 404;  // Not Found
+      opentelemetry::nostd::string_view uri = conn.parser.uri();
+      conn.response.code                    = 404;  // Not Found
       for (auto &handler : m_handlers)
       {
-        if (conn.request.uri.length() >= handler.first.length() &&
-            strncmp(conn.request.uri.c_str(), handler.first.c_str(), handler.first.length()) == 0)
+        if (uri.length() >= handler.first.length() &&
+            strncmp(uri.data(), handler.first.c_str(), handler.first.length()) == 0)
         {
           LOG_TRACE("HttpServer: [%s] using handler for %s", conn.request.client.c_str(),
                     handler.first.c_str());
@@ -747,6 +1050,7 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
       {
         LOG_TRACE("HttpServer: [%s] closing by request", conn.request.client.c_str());
         handleConnectionClosed(conn);
+        return false;
       }
     }
 
@@ -755,10 +1059,29 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
       conn.response.message = getDefaultResponseMessage(conn.response.code);
     }
 
-    conn.response.headers["Host"]           = m_serverHost;
-    conn.response.headers["Connection"]     = (conn.keepalive ? "keep-alive" : "close");
-    conn.response.headers["Date"]           = formatTimestamp(time(nullptr));
-    conn.response.headers["Content-Length"] = std::to_string(conn.response.body.size());
+    // Streamed bodies are sent to HTTP/1.0 clients as they are, ended by
+    // closing the connection
+    conn.chunked = false;
+    if (conn.response.streamBody != nullptr)
+    {
+      conn.chunked = conn.parser.complete() && conn.parser.protocol() == "HTTP/1.1";
+      conn.keepalive &= conn.chunked;
+    }
+
+    conn.response.headers["Host"]       = m_serverHost;
+    conn.response.headers["Connection"] = (conn.keepalive ? "keep-alive" : "close");
+    conn.response.headers["Date"]       = formatTimestamp(time(nullptr));
+    if (conn.chunked)
+    {
+      conn.response.headers["Transfer-Encoding"] = "chunked";
+    }
+    else if (conn.response.streamBody == nullptr)
+    {
+      conn.response.headers["Content-Length"] = std::to_string(
+          conn.response.sharedBody != nullptr ? conn.response.sharedBodyLength
+                                              : conn.response.body.size());
+    }
+    return true;
   }
 
   static std::string formatTimestamp(time_t time)
@@ -775,6 +1098,23 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
   }
 
 public:
+  // Copies the request line and headers of a parsed request into the strings
+  // and the header map of the request.
+  static void copyRequest(HttpRequestParser const &parser, HttpRequest &request)
+  {
+    request.method.assign(parser.method().data(), parser.method().size());
+    request.uri.assign(parser.uri().data(), parser.uri().size());
+    request.protocol.assign(parser.protocol().data(), parser.protocol().size());
+    request.headers.clear();
+    for (size_t i = 0; i < parser.headerCount(); i++)
+    {
+      auto header = parser.header(i);
+      request.headers[normalizeHeaderName(header.name.data(),
+                                          header.name.data() + header.name.size())] =
+          std::string(header.value.data(), header.value.size());
+    }
+  }
+
   static char const *getDefaultResponseMessage(int code)
   {
     switch (code)
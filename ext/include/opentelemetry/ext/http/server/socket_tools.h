@@ -41,6 +41,7 @@
 
 #  ifdef __linux__
 #    include <sys/epoll.h>
+#    include <sys/sendfile.h>
 #  endif
 
 #  if __APPLE__
@@ -58,6 +59,7 @@
 #  include <netinet/in.h>
 #  include <netinet/tcp.h>
 #  include <sys/socket.h>
+#  include <sys/uio.h>
 
 #endif
 
@@ -278,6 +280,13 @@ struct Socket
   static Type const Invalid = -1;
 #endif
 
+  // A buffer of a scatter/gather send
+#ifdef _WIN32
+  typedef WSABUF Buffer;
+#else
+  typedef iovec Buffer;
+#endif
+
   Type m_sock;
 
   Socket(Type sock = Invalid) : m_sock(sock) {}
@@ -320,6 +329,18 @@ struct Socket
                          sizeof(value)) == 0);
   }
 
+  bool setReusePort()
+  {
+    assert(m_sock != Invalid);
+#ifdef SO_REUSEPORT
+    int value = 1;
+    return (::setsockopt(m_sock, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<char *>(&value),
+                         sizeof(value)) == 0);
+#else
+    return false;
+#endif
+  }
+
   bool setNoDelay()
   {
     assert(m_sock != Invalid);
@@ -362,6 +383,46 @@ struct Socket
     return static_cast<int>(::send(m_sock, reinterpret_cast<char const *>(buffer), size, 0));
   }
 
+  static Buffer makeBuffer(void const *data, size_t size)
+  {
+    Buffer buffer;
+#ifdef _WIN32
+    buffer.buf = const_cast<char *>(reinterpret_cast<char const *>(data));
+    buffer.len = static_cast<ULONG>(size);
+#else
+    buffer.iov_base = const_cast<void *>(data);
+    buffer.iov_len  = size;
+#endif
+    return buffer;
+  }
+
+  // Sends the buffers in order with a single call
+  int sendv(Buffer const *buffers, unsigned count)
+  {
+    assert(m_sock != Invalid);
+#ifdef _WIN32
+    DWORD sent = 0;
+    if (::WSASend(m_sock, const_cast<Buffer *>(buffers), count, &sent, 0, NULL, NULL) != 0)
+    {
+      return -1;
+    }
+    return static_cast<int>(sent);
+#else
+    return static_cast<int>(::writev(m_sock, buffers, static_cast<int>(count)));
+#endif
+  }
+
+#ifdef __linux__
+  // Sends up to size bytes of the file, starting at offset, without copying
+  // them through user space.
+  int sendFile(int fd, size_t offset, unsigned size)
+  {
+    assert(m_sock != Invalid);
+    off_t off = static_cast<off_t>(offset);
+    return static_cast<int>(::sendfile(m_sock, fd, &off, size));
+  }
+#endif
+
   bool bind(SocketAddr const &addr)
   {
     assert(m_sock != Invalid);
@@ -478,7 +539,13 @@ struct Reactor : protected common::Thread
 
   SocketCallback &m_callback;
 
+#ifdef _WIN32
+  /* in the order of m_events */
+  std::vector<SocketData> m_sockets;
+#else
+  /* indexed by file descriptor, unused entries hold an invalid socket */
   std::vector<SocketData> m_sockets;
+#endif
 
 #ifdef _WIN32
   /* use WinSock events on Windows */
@@ -488,6 +555,10 @@ struct Reactor : protected common::Thread
 #ifdef __linux__
   /* use epoll on Linux */
   int m_epollFd;
+  enum
+  {
+    MaxEvents = 64
+  };
 #endif
 
 #ifdef TARGET_OS_MAC
@@ -537,8 +608,8 @@ struct Reactor : protected common::Thread
     }
     else
     {
-      auto it = std::find(m_sockets.begin(), m_sockets.end(), socket);
-      if (it == m_sockets.end())
+      SocketData *it = findSocket(socket);
+      if (it == nullptr)
       {
         LOG_TRACE("Reactor: Adding socket 0x%x with flags 0x%x", static_cast<int>(socket), flags);
 #ifdef _WIN32
@@ -559,10 +630,7 @@ struct Reactor : protected common::Thread
         EV_SET(&event, event.ident, EVFILT_WRITE, EV_ADD, 0, 0, NULL);
         kevent(kq, &event, 1, NULL, 0, NULL);
 #endif
-        m_sockets.push_back(SocketData());
-        m_sockets.back().socket = socket;
-        m_sockets.back().flags  = 0;
-        it                      = m_sockets.end() - 1;
+        it = &insertSocket(socket);
       }
       else
       {
@@ -590,7 +658,7 @@ struct Reactor : protected common::Thread
         {
           lNetworkEvents |= FD_CLOSE;
         }
-        auto eventIt = m_events.begin() + std::distance(m_sockets.begin(), it);
+        auto eventIt = m_events.begin() + (it - m_sockets.data());
         ::WSAEventSelect(socket, *eventIt, lNetworkEvents);
 #endif
 #ifdef __linux__
@@ -627,11 +695,11 @@ struct Reactor : protected common::Thread
   void removeSocket(const Socket &socket)
   {
     LOG_TRACE("Reactor: Removing socket 0x%x", static_cast<int>(socket));
-    auto it = std::find(m_sockets.begin(), m_sockets.end(), socket);
-    if (it != m_sockets.end())
+    SocketData *it = findSocket(socket);
+    if (it != nullptr)
     {
 #ifdef _WIN32
-      auto eventIt = m_events.begin() + std::distance(m_sockets.begin(), it);
+      auto eventIt = m_events.begin() + (it - m_sockets.data());
       ::WSAEventSelect(it->socket, *eventIt, 0);
       ::WSACloseEvent(*eventIt);
       m_events.erase(eventIt);
@@ -656,10 +724,65 @@ struct Reactor : protected common::Thread
         LOG_ERROR("cannot delete fd=0x%x from kqueue!", event.ident);
       }
 #endif
-      m_sockets.erase(it);
+      eraseSocket(it);
     }
   }
 
+  /// <summary>
+  /// Find the data of a socket
+  /// </summary>
+  /// <param name="socket"></param>
+  /// <returns>the socket data, or nullptr if the socket wasn't added</returns>
+  SocketData *findSocket(const Socket &socket)
+  {
+#ifdef _WIN32
+    auto it = std::find(m_sockets.begin(), m_sockets.end(), socket);
+    return (it != m_sockets.end()) ? &*it : nullptr;
+#else
+    if (socket.invalid() || static_cast<size_t>(socket.m_sock) >= m_sockets.size() ||
+        m_sockets[socket.m_sock].socket.invalid())
+    {
+      return nullptr;
+    }
+    return &m_sockets[socket.m_sock];
+#endif
+  }
+
+  /// <summary>
+  /// Insert the data of a socket that wasn't added yet
+  /// </summary>
+  /// <param name="socket"></param>
+  /// <returns>the socket data</returns>
+  SocketData &insertSocket(const Socket &socket)
+  {
+#ifdef _WIN32
+    m_sockets.push_back(SocketData());
+    SocketData &sd = m_sockets.back();
+#else
+    if (static_cast<size_t>(socket.m_sock) >= m_sockets.size())
+    {
+      m_sockets.resize(socket.m_sock + 1);
+    }
+    SocketData &sd = m_sockets[socket.m_sock];
+#endif
+    sd.socket = socket;
+    sd.flags  = 0;
+    return sd;
+  }
+
+  /// <summary>
+  /// Erase the data of a socket
+  /// </summary>
+  /// <param name="sd"></param>
+  void eraseSocket(SocketData *sd)
+  {
+#ifdef _WIN32
+    m_sockets.erase(m_sockets.begin() + (sd - m_sockets.data()));
+#else
+    *sd = SocketData();
+#endif
+  }
+
   /// <summary>
   /// Start server
   /// </summary>
@@ -684,6 +807,10 @@ struct Reactor : protected common::Thread
 #else /* Linux and Mac */
     for (auto &sd : m_sockets)
     {
+      if (sd.socket.invalid())
+      {
+        continue;
+      }
 #  ifdef __linux__
       ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, sd.socket, nullptr);
 #  endif
@@ -754,18 +881,22 @@ struct Reactor : protected common::Thread
 #endif
 
 #ifdef __linux__
-      epoll_event events[4];
-      int result = ::epoll_wait(m_epollFd, events, sizeof(events) / sizeof(events[0]), 500);
+      epoll_event events[MaxEvents];
+      int result = ::epoll_wait(m_epollFd, events, MaxEvents, 500);
       if (result == 0 || (result == -1 && errno == EINTR))
       {
         continue;
       }
 
-      assert(result >= 1 && static_cast<size_t>(result) <= sizeof(events) / sizeof(events[0]));
+      assert(result >= 1 && result <= MaxEvents);
       for (int i = 0; i < result; i++)
       {
-        auto it = std::find(m_sockets.begin(), m_sockets.end(), events[i].data.fd);
-        assert(it != m_sockets.end());
+        // A callback for an earlier event of the batch may have removed it
+        SocketData *it = findSocket(events[i].data.fd);
+        if (it == nullptr)
+        {
+          continue;
+        }
         Socket socket = it->socket;
         int flags     = it->flags;
 
@@ -802,8 +933,11 @@ struct Reactor : protected common::Thread
       {
         struct kevent &event = m_events[i];
         int fd               = (int)event.ident;
-        auto it              = std::find(m_sockets.begin(), m_sockets.end(), fd);
-        assert(it != m_sockets.end());
+        SocketData *it       = findSocket(fd);
+        if (it == nullptr)
+        {
+          continue;
+        }
         Socket socket = it->socket;
         int flags     = it->flags;
 
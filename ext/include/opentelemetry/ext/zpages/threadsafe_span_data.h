@@ -1,12 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
 #include "opentelemetry/sdk/trace/recordable.h"
 #include "opentelemetry/sdk/trace/span_data.h"
 #include "opentelemetry/trace/canonical_code.h"
@@ -24,32 +30,127 @@ namespace ext
 {
 namespace zpages
 {
+class TracezSpanProcessor;
+class ThreadsafeSpanData;
+
+/**
+ * An immutable copy of the data of a ThreadsafeSpanData at one point in time.
+ * Snapshots share their attributes and events with the span data they were
+ * taken from, which copies them only when it is modified afterwards.
+ */
+class SpanDataSnapshot final
+{
+public:
+  using AttributeMap = std::unordered_map<std::string, SpanDataAttributeValue>;
+  using EventList    = std::vector<SpanDataEvent>;
+
+  opentelemetry::trace::TraceId GetTraceId() const noexcept { return trace_id_; }
+
+  opentelemetry::trace::SpanId GetSpanId() const noexcept { return span_id_; }
+
+  opentelemetry::trace::SpanId GetParentSpanId() const noexcept { return parent_span_id_; }
+
+  opentelemetry::nostd::string_view GetName() const noexcept { return name_; }
+
+  opentelemetry::trace::CanonicalCode GetStatus() const noexcept { return status_code_; }
+
+  opentelemetry::nostd::string_view GetDescription() const noexcept { return status_desc_; }
+
+  opentelemetry::core::SystemTimestamp GetStartTime() const noexcept { return start_time_; }
+
+  std::chrono::nanoseconds GetDuration() const noexcept { return duration_; }
+
+  const AttributeMap &GetAttributes() const noexcept
+  {
+    static const AttributeMap empty;
+    return attributes_ != nullptr ? *attributes_ : empty;
+  }
+
+  const EventList &GetEvents() const noexcept
+  {
+    static const EventList empty;
+    return events_ != nullptr ? *events_ : empty;
+  }
+
+private:
+  friend class ThreadsafeSpanData;
+
+  // The version of the span data this snapshot was taken at
+  uint64_t version_ = 0;
+  opentelemetry::trace::TraceId trace_id_;
+  opentelemetry::trace::SpanId span_id_;
+  opentelemetry::trace::SpanId parent_span_id_;
+  core::SystemTimestamp start_time_;
+  std::chrono::nanoseconds duration_{0};
+  std::string name_;
+  opentelemetry::trace::CanonicalCode status_code_{opentelemetry::trace::CanonicalCode::OK};
+  std::string status_desc_;
+  std::shared_ptr<const AttributeMap> attributes_;
+  std::shared_ptr<const EventList> events_;
+};
 
 /**
  * This class is a threadsafe version of span data used for zpages in OT
+ *
+ * Writers modify the span data under a mutex. The ids, times and status are
+ * kept in atomic words, so the getters for them never lock or touch a
+ * reference count. The trace id takes two words, which are read under a
+ * seqlock on the version: the read is retried while a writer is active.
+ *
+ * The name, description, attributes and events are read through
+ * GetSnapshot(), which reuses the cached snapshot as long as the span data
+ * hasn't been modified since it was taken. Loading the cached snapshot takes
+ * no mutex_, but it is an atomic load of a shared_ptr, which may take a lock
+ * of the standard library and changes the reference count.
  */
 class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
 {
 public:
+  /**
+   * Get a consistent snapshot of this span's data
+   * @return a snapshot that is shared by all readers until the span data is
+   * modified
+   */
+  std::shared_ptr<const SpanDataSnapshot> GetSnapshot() const noexcept
+  {
+    auto snapshot = snapshot_.load();
+    if (snapshot != nullptr && snapshot->version_ == version_.load(std::memory_order_acquire))
+    {
+      return snapshot;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot = snapshot_.load();
+    if (snapshot != nullptr && snapshot->version_ == version_.load(std::memory_order_relaxed))
+    {
+      return snapshot;
+    }
+    snapshot = MakeSnapshot();
+    snapshot_.store(snapshot);
+    return snapshot;
+  }
+
   /**
    * Get the trace id for this span
    * @return the trace id for this span
    */
   opentelemetry::trace::TraceId GetTraceId() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return trace_id_;
+    uint64_t words[2];
+    ReadConsistent([&] {
+      words[0] = trace_id_[0].load(std::memory_order_relaxed);
+      words[1] = trace_id_[1].load(std::memory_order_relaxed);
+    });
+    return opentelemetry::trace::TraceId(
+        nostd::span<const uint8_t, opentelemetry::trace::TraceId::kSize>(
+            reinterpret_cast<const uint8_t *>(words), sizeof(words)));
   }
 
   /**
    * Get the span id for this span
    * @return the span id for this span
    */
-  opentelemetry::trace::SpanId GetSpanId() const noexcept
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return span_id_;
-  }
+  opentelemetry::trace::SpanId GetSpanId() const noexcept { return LoadSpanId(span_id_); }
 
   /**
    * Get the parent span id for this span
@@ -57,19 +158,15 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
    */
   opentelemetry::trace::SpanId GetParentSpanId() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return parent_span_id_;
+    return LoadSpanId(parent_span_id_);
   }
 
   /**
-   * Get the name for this span
+   * Get a copy of the name for this span. Use GetSnapshot() to read it
+   * without copying.
    * @return the name for this span
    */
-  opentelemetry::nostd::string_view GetName() const noexcept
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return name_;
-  }
+  std::string GetName() const noexcept { return std::string(GetSnapshot()->GetName()); }
 
   /**
    * Get the status for this span
@@ -77,18 +174,17 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
    */
   opentelemetry::trace::CanonicalCode GetStatus() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return status_code_;
+    return static_cast<opentelemetry::trace::CanonicalCode>(status_code_.load());
   }
 
   /**
-   * Get the status description for this span
+   * Get a copy of the status description for this span. Use GetSnapshot() to
+   * read it without copying.
    * @return the description of the the status of this span
    */
-  opentelemetry::nostd::string_view GetDescription() const noexcept
+  std::string GetDescription() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return status_desc_;
+    return std::string(GetSnapshot()->GetDescription());
   }
 
   /**
@@ -97,8 +193,7 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
    */
   opentelemetry::core::SystemTimestamp GetStartTime() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return start_time_;
+    return opentelemetry::core::SystemTimestamp(std::chrono::nanoseconds(start_time_.load()));
   }
 
   /**
@@ -107,18 +202,17 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
    */
   std::chrono::nanoseconds GetDuration() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return duration_;
+    return std::chrono::nanoseconds(duration_.load());
   }
 
   /**
-   * Get the attributes for this span
+   * Get a copy of the attributes for this span. Use GetSnapshot() to read
+   * them without copying.
    * @return the attributes for this span
    */
   const std::unordered_map<std::string, SpanDataAttributeValue> GetAttributes() const noexcept
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return attributes_;
+    return GetSnapshot()->GetAttributes();
   }
 
   void SetIds(opentelemetry::trace::TraceId trace_id,
@@ -126,40 +220,50 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
               opentelemetry::trace::SpanId parent_span_id) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    trace_id_       = trace_id;
-    span_id_        = span_id;
-    parent_span_id_ = parent_span_id;
+    BeginWrite();
+    StoreIds(trace_id, span_id, parent_span_id);
+    EndWrite();
   }
 
   void SetAttribute(nostd::string_view key, const common::AttributeValue &value) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    attributes_[std::string(key)] = nostd::visit(converter_, value);
+    BeginWrite();
+    Unshare(attributes_, attributes_shared_)[std::string(key)] = nostd::visit(converter_, value);
+    EndWrite();
   }
 
   void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    status_code_ = code;
+    BeginWrite();
+    status_code_.store(static_cast<int>(code), std::memory_order_relaxed);
     status_desc_ = std::string(description);
+    EndWrite();
   }
 
   void SetName(nostd::string_view name) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    BeginWrite();
     name_ = std::string(name);
+    EndWrite();
   }
 
   void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    start_time_ = start_time;
+    BeginWrite();
+    start_time_.store(start_time.time_since_epoch().count(), std::memory_order_relaxed);
+    EndWrite();
   }
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    duration_ = duration;
+    BeginWrite();
+    duration_.store(duration.count(), std::memory_order_relaxed);
+    EndWrite();
   }
 
   void AddLink(
@@ -167,7 +271,6 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
       const trace_api::KeyValueIterable &attributes =
           trace_api::KeyValueIterableView<std::map<std::string, int>>({})) noexcept override
   {
-    std::lock_guard<std::mutex> lock(mutex_);
     (void)span_context;
     (void)attributes;
   }
@@ -179,44 +282,160 @@ class ThreadsafeSpanData final : public opentelemetry::sdk::trace::Recordable
           trace_api::KeyValueIterableView<std::map<std::string, int>>({})) noexcept override
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    events_.push_back(SpanDataEvent(std::string(name), timestamp));
+    BeginWrite();
+    Unshare(events_, events_shared_).push_back(SpanDataEvent(std::string(name), timestamp));
+    EndWrite();
     // TODO: handle attributes
   }
 
   ThreadsafeSpanData() {}
   ThreadsafeSpanData(const ThreadsafeSpanData &threadsafe_span_data)
-      : ThreadsafeSpanData(threadsafe_span_data,
-                           std::lock_guard<std::mutex>(threadsafe_span_data.mutex_))
+      : ThreadsafeSpanData(threadsafe_span_data.GetSnapshot())
   {}
 
 private:
-  ThreadsafeSpanData(const ThreadsafeSpanData &threadsafe_span_data,
-                     const std::lock_guard<std::mutex> &)
-      : trace_id_(threadsafe_span_data.trace_id_),
-        span_id_(threadsafe_span_data.span_id_),
-        parent_span_id_(threadsafe_span_data.parent_span_id_),
-        start_time_(threadsafe_span_data.start_time_),
-        duration_(threadsafe_span_data.duration_),
-        name_(threadsafe_span_data.name_),
-        status_code_(threadsafe_span_data.status_code_),
-        status_desc_(threadsafe_span_data.status_desc_),
-        attributes_(threadsafe_span_data.attributes_),
-        events_(threadsafe_span_data.events_),
-        converter_(threadsafe_span_data.converter_)
-  {}
+  friend class TracezSpanProcessor;
+
+  // Takes over the data of a snapshot, which becomes the cached snapshot.
+  explicit ThreadsafeSpanData(std::shared_ptr<const SpanDataSnapshot> snapshot)
+      : name_(snapshot->name_),
+        status_desc_(snapshot->status_desc_),
+        // Shared with the snapshot, so Unshare() copies them before they change
+        attributes_(std::const_pointer_cast<SpanDataSnapshot::AttributeMap>(snapshot->attributes_)),
+        events_(std::const_pointer_cast<SpanDataSnapshot::EventList>(snapshot->events_)),
+        attributes_shared_(true),
+        events_shared_(true),
+        version_(snapshot->version_),
+        snapshot_(std::move(snapshot))
+  {
+    auto source = snapshot_.load();
+    StoreIds(source->trace_id_, source->span_id_, source->parent_span_id_);
+    start_time_.store(source->start_time_.time_since_epoch().count(), std::memory_order_relaxed);
+    duration_.store(source->duration_.count(), std::memory_order_relaxed);
+    status_code_.store(static_cast<int>(source->status_code_), std::memory_order_relaxed);
+  }
+
+  // Must be called with mutex_ held.
+  std::shared_ptr<const SpanDataSnapshot> MakeSnapshot() const
+  {
+    auto snapshot             = std::make_shared<SpanDataSnapshot>();
+    snapshot->version_        = version_.load(std::memory_order_relaxed);
+    snapshot->trace_id_       = GetTraceId();
+    snapshot->span_id_        = GetSpanId();
+    snapshot->parent_span_id_ = GetParentSpanId();
+    snapshot->start_time_     = GetStartTime();
+    snapshot->duration_       = GetDuration();
+    snapshot->name_           = name_;
+    snapshot->status_code_    = GetStatus();
+    snapshot->status_desc_    = status_desc_;
+    snapshot->attributes_     = attributes_;
+    snapshot->events_         = events_;
+    attributes_shared_        = true;
+    events_shared_            = true;
+    return snapshot;
+  }
+
+  // Calls read until it ran while no writer was active. read must only load
+  // atomics, as it may run concurrently with a writer.
+  template <class Read>
+  void ReadConsistent(Read read) const noexcept
+  {
+    for (;;)
+    {
+      uint64_t version = version_.load(std::memory_order_acquire);
+      if ((version & 1) == 0)
+      {
+        read();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == version)
+        {
+          return;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  opentelemetry::trace::SpanId LoadSpanId(const std::atomic<uint64_t> &word) const noexcept
+  {
+    uint64_t value = word.load();
+    return opentelemetry::trace::SpanId(
+        nostd::span<const uint8_t, opentelemetry::trace::SpanId::kSize>(
+            reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+  }
+
+  // Must be called between BeginWrite() and EndWrite(), or before the span
+  // data is shared.
+  void StoreIds(opentelemetry::trace::TraceId trace_id,
+                opentelemetry::trace::SpanId span_id,
+                opentelemetry::trace::SpanId parent_span_id) noexcept
+  {
+    uint64_t words[2];
+    memcpy(words, trace_id.Id().data(), sizeof(words));
+    trace_id_[0].store(words[0], std::memory_order_relaxed);
+    trace_id_[1].store(words[1], std::memory_order_relaxed);
+    memcpy(words, span_id.Id().data(), sizeof(words[0]));
+    span_id_.store(words[0], std::memory_order_relaxed);
+    memcpy(words, parent_span_id.Id().data(), sizeof(words[0]));
+    parent_span_id_.store(words[0], std::memory_order_relaxed);
+  }
+
+  // Must be called with mutex_ held, before modifying the span data. Makes
+  // the version odd, so that readers retry or take a new snapshot.
+  void BeginWrite() noexcept
+  {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  // Must be called with mutex_ held, after modifying the span data.
+  void EndWrite() noexcept
+  {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Returns a container that is safe to modify, copying it first if a snapshot
+  // shares it. Must be called with mutex_ held.
+  template <class T>
+  static T &Unshare(std::shared_ptr<T> &container, bool &shared)
+  {
+    if (container == nullptr)
+    {
+      container = std::make_shared<T>();
+    }
+    else if (shared)
+    {
+      container = std::make_shared<T>(*container);
+    }
+    shared = false;
+    return *container;
+  }
 
   mutable std::mutex mutex_;
-  opentelemetry::trace::TraceId trace_id_;
-  opentelemetry::trace::SpanId span_id_;
-  opentelemetry::trace::SpanId parent_span_id_;
-  core::SystemTimestamp start_time_;
-  std::chrono::nanoseconds duration_{0};
+  // The trace id as two words, and the span ids as one word each
+  std::atomic<uint64_t> trace_id_[2] = {};
+  std::atomic<uint64_t> span_id_{0};
+  std::atomic<uint64_t> parent_span_id_{0};
+  std::atomic<int64_t> start_time_{0};
+  std::atomic<int64_t> duration_{0};
+  std::atomic<int> status_code_{static_cast<int>(opentelemetry::trace::CanonicalCode::OK)};
   std::string name_;
-  opentelemetry::trace::CanonicalCode status_code_{opentelemetry::trace::CanonicalCode::OK};
   std::string status_desc_;
-  std::unordered_map<std::string, SpanDataAttributeValue> attributes_;
-  std::vector<SpanDataEvent> events_;
+  std::shared_ptr<SpanDataSnapshot::AttributeMap> attributes_;
+  std::shared_ptr<SpanDataSnapshot::EventList> events_;
+  // Whether a snapshot shares the containers above. Guarded by mutex_.
+  mutable bool attributes_shared_ = false;
+  mutable bool events_shared_     = false;
   AttributeConverter converter_;
+
+  // Odd while a writer modifies the span data, and bumped twice on every
+  // modification. The cached snapshot is current while its version matches.
+  std::atomic<uint64_t> version_{0};
+  mutable opentelemetry::sdk::AtomicSharedPtr<const SpanDataSnapshot> snapshot_{nullptr};
+
+  // Links of the lists that TracezSpanProcessor keeps spans in
+  ThreadsafeSpanData *next_started_ = nullptr;
+  ThreadsafeSpanData *next_ended_   = nullptr;
 };
 }  // namespace zpages
 }  // namespace ext
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <iostream>
-#include <list>
+#include <iterator>
+#include <memory>
 #include <string>
 
 #include "opentelemetry/ext/zpages/threadsafe_span_data.h"
@@ -33,6 +35,109 @@ namespace zpages
  */
 const int kMaxNumberOfSampleSpans = 5;
 
+/**
+ * SampleSpans holds the most recent sample spans of a kind for a span name in
+ * a fixed-size ring; once it is full, adding a sample replaces the oldest one.
+ * Samples are immutable and shared, so copying the samples, as is done when
+ * the aggregated data is handed out, only copies references.
+ */
+class SampleSpans
+{
+public:
+  /**
+   * Iterates over the samples from the oldest to the most recent one.
+   */
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = ThreadsafeSpanData;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const ThreadsafeSpanData *;
+    using reference         = const ThreadsafeSpanData &;
+
+    const_iterator(const SampleSpans *samples, size_t index) noexcept
+        : samples_(samples), index_(index)
+    {}
+
+    reference operator*() const noexcept { return *samples_->At(index_); }
+
+    pointer operator->() const noexcept { return samples_->At(index_).get(); }
+
+    const_iterator &operator++() noexcept
+    {
+      ++index_;
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept
+    {
+      const_iterator previous = *this;
+      ++index_;
+      return previous;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept { return index_ == other.index_; }
+
+    bool operator!=(const const_iterator &other) const noexcept { return index_ != other.index_; }
+
+  private:
+    const SampleSpans *samples_;
+    size_t index_;
+  };
+
+  size_t size() const noexcept { return size_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+
+  /** @return the oldest sample */
+  const ThreadsafeSpanData &front() const noexcept { return *At(0); }
+
+  /** @return the most recent sample */
+  const ThreadsafeSpanData &back() const noexcept { return *At(size_ - 1); }
+
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+  const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+  /**
+   * Adds a sample, replacing the oldest one if the ring is full.
+   */
+  void push_back(std::shared_ptr<const ThreadsafeSpanData> span) noexcept
+  {
+    if (size_ < samples_.size())
+    {
+      samples_[(start_ + size_) % samples_.size()] = std::move(span);
+      ++size_;
+    }
+    else
+    {
+      samples_[start_] = std::move(span);
+      start_           = (start_ + 1) % samples_.size();
+    }
+  }
+
+  void clear() noexcept
+  {
+    for (auto &sample : samples_)
+    {
+      sample.reset();
+    }
+    start_ = 0;
+    size_  = 0;
+  }
+
+private:
+  const std::shared_ptr<const ThreadsafeSpanData> &At(size_t index) const noexcept
+  {
+    return samples_[(start_ + index) % samples_.size()];
+  }
+
+  std::array<std::shared_ptr<const ThreadsafeSpanData>, kMaxNumberOfSampleSpans> samples_;
+  size_t start_ = 0;
+  size_t size_  = 0;
+};
+
 /**
  * TracezData is the data to be displayed for tracez zpages that is stored for
  * each span name.
@@ -53,22 +158,23 @@ struct TracezData
   std::array<unsigned int, kLatencyBoundaries.size()> completed_span_count_per_latency_bucket;
 
   /**
-   * sample_latency_spans is an array of lists, each index of the array
+   * sample_latency_spans is an array of sample rings, each index of the array
    * corresponds to a latency boundary(of which there are 9).
-   * The list in each index stores the sample spans for that latency boundary.
+   * The ring in each index stores the sample spans for that latency boundary.
    */
-  std::array<std::list<ThreadsafeSpanData>, kLatencyBoundaries.size()> sample_latency_spans;
+  std::array<SampleSpans, kLatencyBoundaries.size()> sample_latency_spans;
 
   /**
-   * sample_error_spans is a list that stores the error samples for a span name.
+   * sample_error_spans stores the error samples for a span name.
    */
-  std::list<ThreadsafeSpanData> sample_error_spans;
+  SampleSpans sample_error_spans;
 
   /**
-   * sample_running_spans is a list that stores the running span samples for a
-   * span name.
+   * sample_running_spans stores the running span samples for a span name.
+   * They are copies of the running spans taken when the set of running spans
+   * with the name changed.
    */
-  std::list<ThreadsafeSpanData> sample_running_spans;
+  SampleSpans sample_running_spans;
 
   TracezData()
   {
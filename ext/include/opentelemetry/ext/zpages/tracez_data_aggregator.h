@@ -3,12 +3,14 @@
 #include <array>
 #include <atomic>
 #include <condition_variable>
-#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include "opentelemetry/ext/zpages/latency_boundaries.h"
 #include "opentelemetry/ext/zpages/tracez_data.h"
@@ -37,6 +39,12 @@ namespace zpages
  * data when requested. This function is ensured to be called in sequence to the
  * aggregate spans function which is called periodically.
  *
+ * Aggregation is incremental: each update only processes the spans that
+ * started or completed since the previous one. Running spans are tracked by
+ * span id, so a completed span is removed from the running span data of the
+ * name it was counted under, even if it was renamed. Spans without a valid
+ * span id are not counted as running.
+ *
  * TODO: Consider a singleton pattern for this class, not sure if multiple
  * instances of this class should exist.
  */
@@ -61,6 +69,15 @@ class TracezDataAggregator
    */
   std::map<std::string, TracezData> GetAggregatedTracezData();
 
+  /**
+   * GetDataVersion returns a number that changes whenever the aggregated data
+   * changes. Data returned by a later call to GetAggregatedTracezData is at
+   * least as recent as the returned version, so it can be used to cache
+   * anything derived from the aggregated data.
+   * @returns the version of the aggregated data.
+   */
+  uint64_t GetDataVersion() const noexcept;
+
 private:
   /**
    * AggregateSpans is the function that is called to update the aggregated data
@@ -76,22 +93,24 @@ class TracezDataAggregator
   void AggregateCompletedSpans(std::vector<std::unique_ptr<ThreadsafeSpanData>> &completed_spans);
 
   /**
-   * AggregateRunningSpans aggregates the data for all running spans received
-   * from the span processor. Running spans are not cleared by the span
-   * processor and multiple calls to this function may contain running spans for
-   * which data has already been collected in a previous call. Additionally,
-   * span names can change while span is running and there seems to be
-   * no trivial to way to know if it is a new or old running span so at every
-   * call to this function the available running span data is reset and
-   * recalculated. At this time there is no unique way to identify a span
-   * object once this is done, there might be some better ways to do this.
-   * TODO : SpanProcessor is never notified when a span name is changed while it
-   * is running and that is propogated to the data aggregator. The running span
-   * name if changed while it is running will not be updated in the data
-   * aggregator till the span is completed.
-   * @param running_spans is the running spans to be aggregated.
+   * AggregateStartedSpans adds the newly started spans to the running spans
+   * of their names.
+   * @param started_spans are the newly started spans that are still running.
    */
-  void AggregateRunningSpans(std::unordered_set<ThreadsafeSpanData *> &running_spans);
+  void AggregateStartedSpans(std::vector<ThreadsafeSpanData *> &started_spans);
+
+  /**
+   * RemoveRunningSpan removes a completed span from the running spans of the
+   * name it was counted under, if it was counted as running.
+   * @param span is the completed span.
+   */
+  void RemoveRunningSpan(const ThreadsafeSpanData &span);
+
+  /**
+   * UpdateRunningSpanData updates the running span count and samples of the
+   * span names whose running spans changed during this update.
+   */
+  void UpdateRunningSpanData();
 
   /**
    * AggregateStatusOKSpans is the function called to update the data of spans
@@ -107,14 +126,6 @@ class TracezDataAggregator
    */
   void AggregateStatusErrorSpan(std::unique_ptr<ThreadsafeSpanData> &error_span);
 
-  /**
-   * ClearRunningSpanData is a function that is used to clear all running span
-   * at the beginning of a call to AggregateSpan data.
-   * Running span data has to be cleared before aggregation because running
-   * span data is recalculated at every call to AggregateSpans.
-   */
-  void ClearRunningSpanData();
-
   /**
    * FindLatencyBoundary finds the latency boundary to which the duration of
    * the given span_data belongs to
@@ -125,16 +136,6 @@ class TracezDataAggregator
    */
   LatencyBoundary FindLatencyBoundary(std::unique_ptr<ThreadsafeSpanData> &ok_span);
 
-  /**
-   * InsertIntoSampleSpanList is a helper function that is called to insert
-   * a given span into a sample span list. A function is used for insertion
-   * because list size is to be limited at a set maximum.
-   * @param sample_spans the sample span list into which span is to be inserted
-   * @param span_data the span_data to be inserted into list
-   */
-  void InsertIntoSampleSpanList(std::list<ThreadsafeSpanData> &sample_spans,
-                                ThreadsafeSpanData &span_data);
-
   /** Instance of span processor used to collect raw data **/
   std::shared_ptr<TracezSpanProcessor> tracez_span_processor_;
 
@@ -150,10 +151,25 @@ class TracezDataAggregator
   std::map<std::string, TracezData> aggregated_tracez_data_;
   std::mutex mtx_;
 
+  /** The running spans of a span name, by span id **/
+  using RunningSpans = std::unordered_map<uint64_t, ThreadsafeSpanData *>;
+
+  /** The running spans by the name they were counted under **/
+  std::map<std::string, RunningSpans> running_spans_;
+
+  /** The name each running span was counted under, by span id **/
+  std::unordered_map<uint64_t, std::string> running_span_names_;
+
+  /** The names whose running spans changed during the current update **/
+  std::set<std::string> changed_running_span_names_;
+
   /** A boolean that is set to true in the constructor and false in the
    * destructor to start and end execution of aggregate spans **/
   std::atomic<bool> execute_;
 
+  /** Bumped under mtx_ by every update that changes the aggregated data **/
+  std::atomic<uint64_t> data_version_{0};
+
   /** Thread that executes aggregate spans at regurlar intervals during this
   object's lifetime**/
   std::thread aggregate_spans_thread_;
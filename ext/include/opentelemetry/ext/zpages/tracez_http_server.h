@@ -0,0 +1,116 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "opentelemetry/ext/http/server/http_server.h"
+#include "opentelemetry/ext/zpages/tracez_data_aggregator.h"
+#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace ext
+{
+namespace zpages
+{
+/**
+ * TracezHttpServer serves the data of a TracezDataAggregator over HTTP:
+ * - /tracez/get/aggregations returns the aggregated data, including the sample
+ *   spans, as JSON.
+ * - /tracez returns an HTML page summarizing the aggregated data.
+ *
+ * Pages are rendered once per version of the aggregated data and cached, and
+ * responses send the cached page without copying it.
+ */
+class TracezHttpServer : public HTTP_SERVER_NS::HttpServer
+{
+public:
+  /**
+   * Construct the server and start listening on the given host and port.
+   * @param aggregator is the aggregator whose data is served
+   * @param host is the host name the server reports
+   * @param port is the port to listen on, or 0 to pick a free one
+   */
+  TracezHttpServer(std::unique_ptr<TracezDataAggregator> aggregator,
+                   const std::string &host = "localhost",
+                   int port                = 30000);
+
+  /** Stops serving before the handlers are destroyed **/
+  ~TracezHttpServer() { stop(); }
+
+  /**
+   * @returns the port the server listens on
+   */
+  int GetPort() const noexcept { return port_; }
+
+  /**
+   * @returns the aggregated data rendered as JSON, rendering it only if it
+   * changed since it was last rendered
+   */
+  std::shared_ptr<const std::string> GetAggregationsJson();
+
+  /**
+   * @returns the HTML summary of the aggregated data, rendering it only if it
+   * changed since it was last rendered
+   */
+  std::shared_ptr<const std::string> GetTracezHtml();
+
+private:
+  /** A rendered page and the version of the aggregated data it shows **/
+  struct RenderedPage
+  {
+    uint64_t version;
+    HTTP_SERVER_NS::HttpSharedBody body;
+  };
+
+  using RenderFunction = void (*)(const std::map<std::string, TracezData> &, std::string &);
+
+  std::shared_ptr<const RenderedPage> GetJsonPage();
+
+  std::shared_ptr<const RenderedPage> GetHtmlPage();
+
+  /**
+   * GetPage returns the cached page if it shows the current version of the
+   * aggregated data, and renders and caches it otherwise.
+   */
+  std::shared_ptr<const RenderedPage> GetPage(
+      opentelemetry::sdk::AtomicSharedPtr<const RenderedPage> &cache,
+      RenderFunction render);
+
+  std::unique_ptr<TracezDataAggregator> data_aggregator_;
+  int port_;
+
+  /** Serializes rendering, so that a page is rendered once per version **/
+  std::mutex render_mutex_;
+  opentelemetry::sdk::AtomicSharedPtr<const RenderedPage> json_page_{nullptr};
+  opentelemetry::sdk::AtomicSharedPtr<const RenderedPage> html_page_{nullptr};
+
+  /** Sets the page as the body of the response, sharing it with the cache **/
+  static int ServePage(std::shared_ptr<const RenderedPage> page,
+                       const char *content_type,
+                       HTTP_SERVER_NS::HttpResponse &resp)
+  {
+    resp.headers[HTTP_SERVER_NS::CONTENT_TYPE] = content_type;
+    resp.sharedBodyOffset                      = 0;
+    resp.sharedBodyLength                      = page->body.size;
+    resp.sharedBody = std::shared_ptr<const HTTP_SERVER_NS::HttpSharedBody>(page, &page->body);
+    resp.code       = 200;
+    return resp.code;
+  }
+
+  HTTP_SERVER_NS::HttpRequestCallback serve_json_{
+      [this](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        return ServePage(GetJsonPage(), "application/json", resp);
+      }};
+
+  HTTP_SERVER_NS::HttpRequestCallback serve_html_{
+      [this](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        return ServePage(GetHtmlPage(), "text/html", resp);
+      }};
+};
+
+}  // namespace zpages
+}  // namespace ext
+OPENTELEMETRY_END_NAMESPACE
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -19,6 +20,11 @@ namespace zpages
 /*
  * The span processor passes and stores running and completed recordables (casted as span_data)
  * to be used by the TraceZ Data Aggregator.
+ *
+ * Starting and ending a span doesn't lock: OnStart and OnEnd push the span onto
+ * intrusive lists of started and ended spans with a compare-and-swap. Only
+ * GetSpanSnapshot, which is called by a single aggregator, takes a lock; it
+ * collects the lists and maintains the set of running spans on its own.
  */
 class TracezSpanProcessor : public opentelemetry::sdk::trace::SpanProcessor
 {
@@ -29,11 +35,22 @@ class TracezSpanProcessor : public opentelemetry::sdk::trace::SpanProcessor
     std::vector<std::unique_ptr<ThreadsafeSpanData>> completed;
   };
 
+  struct SpanChanges
+  {
+    std::vector<ThreadsafeSpanData *> started;
+    std::vector<std::unique_ptr<ThreadsafeSpanData>> completed;
+  };
+
   /*
    * Initialize a span processor.
    */
   explicit TracezSpanProcessor() noexcept {}
 
+  /*
+   * Destroys the ended spans that were not collected by a snapshot.
+   */
+  ~TracezSpanProcessor() override;
+
   /*
    * Create a span recordable, which is span_data
    * @return a newly initialized recordable
@@ -60,14 +77,25 @@ class TracezSpanProcessor : public opentelemetry::sdk::trace::SpanProcessor
   /*
    * Returns a snapshot of all spans stored. This snapshot has a copy of the
    * stored running_spans and gives ownership of completed spans to the caller.
-   * Stored completed_spans are cleared from the processor. Currently,
-   * copy-on-write is utilized where possible to minimize contention, but locks
-   * may be added in the future.
+   * Stored completed_spans are cleared from the processor. Spans that end after
+   * the snapshot was taken are kept alive until the next snapshot, so the
+   * running spans of a snapshot remain valid until then. Taking a snapshot
+   * doesn't block starting or ending spans.
    * @return snapshot of all currently running spans and newly completed spans
    * (spans never sent while complete) at the time that the function is called
    */
   CollectedSpans GetSpanSnapshot() noexcept;
 
+  /*
+   * Returns the changes since the last snapshot or changes were taken: the
+   * spans that started and are still running, and ownership of the spans that
+   * completed. Unlike GetSpanSnapshot, this doesn't copy the set of running
+   * spans, so its cost doesn't grow with the number of running spans. A running
+   * span remains valid until the call that returns it as completed.
+   * @return the spans started and completed since the last call
+   */
+  SpanChanges GetSpanChanges() noexcept;
+
   /*
    * For now, does nothing. In the future, it
    * may send all ended spans that have not yet been sent to the aggregator.
@@ -89,8 +117,33 @@ class TracezSpanProcessor : public opentelemetry::sdk::trace::SpanProcessor
   {}
 
 private:
-  mutable std::mutex mtx_;
-  CollectedSpans spans_;
+  /*
+   * Collects the spans started and ended since the last call and updates the
+   * set of running spans. Must be called with snapshot_mtx_ held.
+   * @param started if not null, receives the newly started spans that are
+   * still running
+   * @param completed receives the newly completed spans
+   */
+  void CollectSpans(std::vector<ThreadsafeSpanData *> *started,
+                    std::vector<std::unique_ptr<ThreadsafeSpanData>> &completed) noexcept;
+
+  /*
+   * Pushes a span onto an intrusive list with the given link member.
+   */
+  static void Push(std::atomic<ThreadsafeSpanData *> &list,
+                   ThreadsafeSpanData *ThreadsafeSpanData::*next,
+                   ThreadsafeSpanData *span) noexcept;
+
+  /* Spans started since the last snapshot, linked by next_started_ */
+  std::atomic<ThreadsafeSpanData *> started_{nullptr};
+
+  /* Spans ended since the last snapshot, linked by next_ended_. The processor
+   * owns them. */
+  std::atomic<ThreadsafeSpanData *> ended_{nullptr};
+
+  /* Serializes snapshots and guards running_ */
+  std::mutex snapshot_mtx_;
+  std::unordered_set<ThreadsafeSpanData *> running_;
 };
 }  // namespace zpages
 }  // namespace ext
@@ -1,10 +1,26 @@
 #include "opentelemetry/ext/zpages/tracez_data_aggregator.h"
 
+#include <cstring>
+
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace ext
 {
 namespace zpages
 {
+namespace
+{
+/**
+ * Returns the key that running spans are tracked by, or 0 if the span has no
+ * valid span id.
+ */
+uint64_t GetSpanKey(const ThreadsafeSpanData &span)
+{
+  uint64_t key = 0;
+  static_assert(SpanId::kSize == sizeof(key), "span ids must fit in the key");
+  memcpy(&key, span.GetSpanId().Id().data(), sizeof(key));
+  return key;
+}
+}  // namespace
 
 TracezDataAggregator::TracezDataAggregator(std::shared_ptr<TracezSpanProcessor> span_processor,
                                            milliseconds update_interval)
@@ -40,6 +56,11 @@ std::map<std::string, TracezData> TracezDataAggregator::GetAggregatedTracezData(
   return aggregated_tracez_data_;
 }
 
+uint64_t TracezDataAggregator::GetDataVersion() const noexcept
+{
+  return data_version_.load(std::memory_order_acquire);
+}
+
 LatencyBoundary TracezDataAggregator::FindLatencyBoundary(
     std::unique_ptr<ThreadsafeSpanData> &span_data)
 {
@@ -52,63 +73,22 @@ LatencyBoundary TracezDataAggregator::FindLatencyBoundary(
   return LatencyBoundary::k100SecondToMax;
 }
 
-void TracezDataAggregator::InsertIntoSampleSpanList(std::list<ThreadsafeSpanData> &sample_spans,
-                                                    ThreadsafeSpanData &span_data)
-{
-  /**
-   * Check to see if the sample span list size exceeds the set limit, if it does
-   * free up memory and remove the earliest inserted sample before appending
-   */
-  if (sample_spans.size() == kMaxNumberOfSampleSpans)
-  {
-    sample_spans.pop_front();
-  }
-  sample_spans.push_back(ThreadsafeSpanData(span_data));
-}
-
-void TracezDataAggregator::ClearRunningSpanData()
-{
-  auto it = aggregated_tracez_data_.begin();
-  while (it != aggregated_tracez_data_.end())
-  {
-    it->second.running_span_count = 0;
-    it->second.sample_running_spans.clear();
-
-    // Check if any data exists in the struct, if not delete entry
-    bool is_completed_span_count_zero = true;
-    for (const auto &completed_span_count : it->second.completed_span_count_per_latency_bucket)
-    {
-      if (completed_span_count > 0)
-        is_completed_span_count_zero = false;
-    }
-
-    if (it->second.error_span_count == 0 && is_completed_span_count_zero)
-    {
-      it = aggregated_tracez_data_.erase(it);
-    }
-    else
-    {
-      ++it;
-    }
-  }
-}
-
 void TracezDataAggregator::AggregateStatusOKSpan(std::unique_ptr<ThreadsafeSpanData> &ok_span)
 {
   // Find and update boundary of aggregated data that span belongs
   auto boundary_name = FindLatencyBoundary(ok_span);
 
   // Get the data for name in aggrgation and update count and sample spans
-  auto &tracez_data = aggregated_tracez_data_.at(ok_span->GetName().data());
-  InsertIntoSampleSpanList(tracez_data.sample_latency_spans[boundary_name], *ok_span.get());
+  auto &tracez_data = aggregated_tracez_data_.at(ok_span->GetName());
+  tracez_data.sample_latency_spans[boundary_name].push_back(std::move(ok_span));
   tracez_data.completed_span_count_per_latency_bucket[boundary_name]++;
 }
 
 void TracezDataAggregator::AggregateStatusErrorSpan(std::unique_ptr<ThreadsafeSpanData> &error_span)
 {
   // Get data for name in aggregation and update count and sample spans
-  auto &tracez_data = aggregated_tracez_data_.at(error_span->GetName().data());
-  InsertIntoSampleSpanList(tracez_data.sample_error_spans, *error_span.get());
+  auto &tracez_data = aggregated_tracez_data_.at(error_span->GetName());
+  tracez_data.sample_error_spans.push_back(std::move(error_span));
   tracez_data.error_span_count++;
 }
 
@@ -117,7 +97,9 @@ void TracezDataAggregator::AggregateCompletedSpans(
 {
   for (auto &completed_span : completed_spans)
   {
-    std::string span_name = completed_span->GetName().data();
+    RemoveRunningSpan(*completed_span);
+
+    std::string span_name = completed_span->GetName();
 
     if (aggregated_tracez_data_.find(span_name) == aggregated_tracez_data_.end())
     {
@@ -131,53 +113,114 @@ void TracezDataAggregator::AggregateCompletedSpans(
   }
 }
 
-void TracezDataAggregator::AggregateRunningSpans(
-    std::unordered_set<ThreadsafeSpanData *> &running_spans)
+void TracezDataAggregator::RemoveRunningSpan(const ThreadsafeSpanData &span)
 {
-  for (auto &running_span : running_spans)
+  auto name_it = running_span_names_.find(GetSpanKey(span));
+  if (name_it == running_span_names_.end())
   {
-    std::string span_name = running_span->GetName().data();
+    return;
+  }
 
-    if (aggregated_tracez_data_.find(span_name) == aggregated_tracez_data_.end())
+  auto running_it = running_spans_.find(name_it->second);
+  running_it->second.erase(name_it->first);
+  if (running_it->second.empty())
+  {
+    running_spans_.erase(running_it);
+  }
+  changed_running_span_names_.insert(std::move(name_it->second));
+  running_span_names_.erase(name_it);
+}
+
+void TracezDataAggregator::AggregateStartedSpans(std::vector<ThreadsafeSpanData *> &started_spans)
+{
+  for (auto started_span : started_spans)
+  {
+    uint64_t key = GetSpanKey(*started_span);
+    if (key == 0)
     {
-      aggregated_tracez_data_[span_name] = TracezData();
+      continue;
     }
 
-    auto &tracez_data = aggregated_tracez_data_[span_name];
-    InsertIntoSampleSpanList(aggregated_tracez_data_[span_name].sample_running_spans,
-                             *running_span);
-    tracez_data.running_span_count++;
+    std::string span_name = started_span->GetName();
+    if (!running_span_names_.emplace(key, span_name).second)
+    {
+      continue;
+    }
+    running_spans_[span_name][key] = started_span;
+    changed_running_span_names_.insert(std::move(span_name));
   }
 }
 
+void TracezDataAggregator::UpdateRunningSpanData()
+{
+  for (const auto &span_name : changed_running_span_names_)
+  {
+    auto running_it = running_spans_.find(span_name);
+    if (running_it == running_spans_.end())
+    {
+      auto data_it = aggregated_tracez_data_.find(span_name);
+      if (data_it == aggregated_tracez_data_.end())
+      {
+        continue;
+      }
+      auto &tracez_data              = data_it->second;
+      tracez_data.running_span_count = 0;
+      tracez_data.sample_running_spans.clear();
+
+      // Remove the entry if no completed spans were seen for the name either.
+      bool is_completed_span_count_zero = true;
+      for (const auto &completed_span_count : tracez_data.completed_span_count_per_latency_bucket)
+      {
+        if (completed_span_count > 0)
+          is_completed_span_count_zero = false;
+      }
+      if (tracez_data.error_span_count == 0 && is_completed_span_count_zero)
+      {
+        aggregated_tracez_data_.erase(data_it);
+      }
+      continue;
+    }
+
+    auto &tracez_data              = aggregated_tracez_data_[span_name];
+    tracez_data.running_span_count = running_it->second.size();
+    tracez_data.sample_running_spans.clear();
+    for (const auto &running_span : running_it->second)
+    {
+      if (tracez_data.sample_running_spans.size() == kMaxNumberOfSampleSpans)
+      {
+        break;
+      }
+      tracez_data.sample_running_spans.push_back(
+          std::make_shared<const ThreadsafeSpanData>(*running_span.second));
+    }
+  }
+  changed_running_span_names_.clear();
+}
+
 void TracezDataAggregator::AggregateSpans()
 {
-  auto span_snapshot = tracez_span_processor_->GetSpanSnapshot();
   /**
-   * TODO: At this time in the project, there is no way of uniquely identifying
-   * a span(their id's are not being set yet).
-   * If in the future this is added then clearing of running spans will not bee
-   * required.
-   * For now this step of clearing and recalculating running span data is
-   * required because it is unkown which spans have moved from running to
-   * completed since the previous call. Additionally, the span name can change
-   * for spans while they are running.
-   *
-   * A better approach for identifying moved spans would have been to map
-   * span id to span name, find these span names in the aggregated data and then
-   * delete only this information for running span data as opposed to clearing
-   * all running span data. However this cannot be done at this time because,
-   * unique identifiers to span data have not been added yet.
-   *
-   * A few things to note:
-   * i) Duplicate running spans may be recieved from the span processor in one
-   *    multiple successive calls to this function.
-   * ii) Only the newly completed spans are recieved by this function.
-   *     Completed spans will not be seen more than once
+   * Only the changes since the previous call are processed:
+   * i) Completed spans are removed from the running spans of the name they
+   *    were counted under and added to the completed span data. Completed
+   *    spans are not seen more than once.
+   * ii) Newly started spans are added to the running spans of their name.
+   *     Span names can change while spans are running; a running span is
+   *     counted under the name it had when it was first seen until it
+   *     completes.
+   * iii) The running span data is recalculated only for the names whose
+   *      running spans changed.
    **/
-  ClearRunningSpanData();
-  AggregateCompletedSpans(span_snapshot.completed);
-  AggregateRunningSpans(span_snapshot.running);
+  auto span_changes = tracez_span_processor_->GetSpanChanges();
+  bool changed      = !span_changes.completed.empty();
+  AggregateCompletedSpans(span_changes.completed);
+  AggregateStartedSpans(span_changes.started);
+  changed |= !changed_running_span_names_.empty();
+  UpdateRunningSpanData();
+  if (changed)
+  {
+    data_version_.fetch_add(1, std::memory_order_release);
+  }
 }
 
 }  // namespace zpages
@@ -0,0 +1,297 @@
+#include "opentelemetry/ext/zpages/tracez_http_server.h"
+#include "opentelemetry/sdk/common/json.h"
+
+#include <sstream>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace ext
+{
+namespace zpages
+{
+namespace
+{
+using sdk::common::AppendJsonDouble;
+using sdk::common::AppendJsonString;
+
+/** Names of the latency buckets, in the order of kLatencyBoundaries **/
+const std::array<const char *, kLatencyBoundaries.size()> kLatencyBoundaryNames = {
+    ">0us",  ">10us", ">100us", ">1ms", ">10ms", ">100ms", ">1s", ">10s", ">100s",
+};
+
+void AppendHtmlEscaped(std::string &out, nostd::string_view str)
+{
+  for (char ch : str)
+  {
+    switch (ch)
+    {
+      case '&':
+        out += "&amp;";
+        break;
+      case '<':
+        out += "&lt;";
+        break;
+      case '>':
+        out += "&gt;";
+        break;
+      case '"':
+        out += "&quot;";
+        break;
+      default:
+        out += ch;
+    }
+  }
+}
+
+template <class Id>
+void AppendId(std::string &out, const Id &id)
+{
+  char hex[2 * Id::kSize];
+  id.ToLowerBase16(hex);
+  out += '"';
+  out.append(hex, sizeof(hex));
+  out += '"';
+}
+
+/**
+ * Appends attribute values as JSON values.
+ */
+class JsonValueWriter
+{
+public:
+  explicit JsonValueWriter(std::string &out) noexcept : out_(out) {}
+
+  void operator()(bool value) { out_ += value ? "true" : "false"; }
+
+  void operator()(int64_t value) { out_ += std::to_string(value); }
+
+  void operator()(uint64_t value) { out_ += std::to_string(value); }
+
+  void operator()(double value) { AppendJsonDouble(out_, value); }
+
+  void operator()(const std::string &value) { AppendJsonString(out_, value); }
+
+  template <class T>
+  void operator()(const std::vector<T> &values)
+  {
+    out_ += '[';
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      if (i > 0)
+      {
+        out_ += ',';
+      }
+      (*this)(static_cast<T>(values[i]));
+    }
+    out_ += ']';
+  }
+
+private:
+  std::string &out_;
+};
+
+void AppendSampleJson(std::string &out, const ThreadsafeSpanData &span)
+{
+  auto snapshot = span.GetSnapshot();
+  out += "{\"name\":";
+  AppendJsonString(out, snapshot->GetName());
+  out += ",\"trace_id\":";
+  AppendId(out, snapshot->GetTraceId());
+  out += ",\"span_id\":";
+  AppendId(out, snapshot->GetSpanId());
+  out += ",\"parent_span_id\":";
+  AppendId(out, snapshot->GetParentSpanId());
+  out += ",\"start\":";
+  out += std::to_string(snapshot->GetStartTime().time_since_epoch().count());
+  out += ",\"duration\":";
+  out += std::to_string(snapshot->GetDuration().count());
+  out += ",\"status\":";
+  out += std::to_string(static_cast<int>(snapshot->GetStatus()));
+  out += ",\"description\":";
+  AppendJsonString(out, snapshot->GetDescription());
+  out += ",\"attributes\":{";
+  bool first = true;
+  JsonValueWriter value_writer(out);
+  for (const auto &attribute : snapshot->GetAttributes())
+  {
+    if (!first)
+    {
+      out += ',';
+    }
+    first = false;
+    AppendJsonString(out, attribute.first);
+    out += ':';
+    nostd::visit(value_writer, attribute.second);
+  }
+  out += "}}";
+}
+
+void AppendSamplesJson(std::string &out, const SampleSpans &samples)
+{
+  out += '[';
+  bool first = true;
+  for (const auto &span : samples)
+  {
+    if (!first)
+    {
+      out += ',';
+    }
+    first = false;
+    AppendSampleJson(out, span);
+  }
+  out += ']';
+}
+
+/**
+ * Renders the aggregated data as a JSON array with an object per span name.
+ */
+void RenderJson(const std::map<std::string, TracezData> &aggregations, std::string &out)
+{
+  out += '[';
+  bool first = true;
+  for (const auto &aggregation : aggregations)
+  {
+    const auto &data = aggregation.second;
+    if (!first)
+    {
+      out += ',';
+    }
+    first = false;
+    out += "{\"name\":";
+    AppendJsonString(out, aggregation.first);
+    out += ",\"running\":";
+    out += std::to_string(data.running_span_count);
+    out += ",\"error\":";
+    out += std::to_string(data.error_span_count);
+    out += ",\"latency\":[";
+    for (size_t boundary = 0; boundary < kLatencyBoundaries.size(); ++boundary)
+    {
+      if (boundary > 0)
+      {
+        out += ',';
+      }
+      out += std::to_string(data.completed_span_count_per_latency_bucket[boundary]);
+    }
+    out += "],\"running_samples\":";
+    AppendSamplesJson(out, data.sample_running_spans);
+    out += ",\"error_samples\":";
+    AppendSamplesJson(out, data.sample_error_spans);
+    out += ",\"latency_samples\":[";
+    for (size_t boundary = 0; boundary < kLatencyBoundaries.size(); ++boundary)
+    {
+      if (boundary > 0)
+      {
+        out += ',';
+      }
+      AppendSamplesJson(out, data.sample_latency_spans[boundary]);
+    }
+    out += "]}";
+  }
+  out += ']';
+}
+
+/**
+ * Renders the aggregated data as an HTML table with a row per span name.
+ */
+void RenderHtml(const std::map<std::string, TracezData> &aggregations, std::string &out)
+{
+  out +=
+      "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>TraceZ</title></head><body>"
+      "<h1>TraceZ Summary</h1><table border=\"1\"><tr><th>Span Name</th><th>Running</th>";
+  for (const char *boundary_name : kLatencyBoundaryNames)
+  {
+    out += "<th>";
+    AppendHtmlEscaped(out, boundary_name);
+    out += "</th>";
+  }
+  out += "<th>Error</th></tr>";
+  for (const auto &aggregation : aggregations)
+  {
+    const auto &data = aggregation.second;
+    out += "<tr><td>";
+    AppendHtmlEscaped(out, aggregation.first);
+    out += "</td><td>";
+    out += std::to_string(data.running_span_count);
+    out += "</td>";
+    for (unsigned int count : data.completed_span_count_per_latency_bucket)
+    {
+      out += "<td>";
+      out += std::to_string(count);
+      out += "</td>";
+    }
+    out += "<td>";
+    out += std::to_string(data.error_span_count);
+    out += "</td></tr>";
+  }
+  out += "</table></body></html>";
+}
+}  // namespace
+
+TracezHttpServer::TracezHttpServer(std::unique_ptr<TracezDataAggregator> aggregator,
+                                   const std::string &host,
+                                   int port)
+    : data_aggregator_(std::move(aggregator))
+{
+  port_ = addListeningPort(port);
+  std::ostringstream os;
+  os << host << ":" << port_;
+  setServerName(os.str());
+  // The handlers don't look at the request
+  setZeroCopyRequests(true);
+
+  // Handlers match by prefix in the order they are added.
+  (*this)["/tracez/get/aggregations"] = serve_json_;
+  (*this)["/tracez"]                  = serve_html_;
+}
+
+std::shared_ptr<const std::string> TracezHttpServer::GetAggregationsJson()
+{
+  auto page = GetJsonPage();
+  return std::shared_ptr<const std::string>(page, &page->body.data);
+}
+
+std::shared_ptr<const std::string> TracezHttpServer::GetTracezHtml()
+{
+  auto page = GetHtmlPage();
+  return std::shared_ptr<const std::string>(page, &page->body.data);
+}
+
+std::shared_ptr<const TracezHttpServer::RenderedPage> TracezHttpServer::GetJsonPage()
+{
+  return GetPage(json_page_, RenderJson);
+}
+
+std::shared_ptr<const TracezHttpServer::RenderedPage> TracezHttpServer::GetHtmlPage()
+{
+  return GetPage(html_page_, RenderHtml);
+}
+
+std::shared_ptr<const TracezHttpServer::RenderedPage> TracezHttpServer::GetPage(
+    opentelemetry::sdk::AtomicSharedPtr<const RenderedPage> &cache,
+    RenderFunction render)
+{
+  auto page = cache.load();
+  if (page == nullptr || page->version != data_aggregator_->GetDataVersion())
+  {
+    std::lock_guard<std::mutex> lock(render_mutex_);
+    // The version is read before the data, so the data rendered is at least
+    // as recent as the version the page is cached under.
+    uint64_t version = data_aggregator_->GetDataVersion();
+    page             = cache.load();
+    if (page == nullptr || page->version != version)
+    {
+      auto rendered     = std::make_shared<RenderedPage>();
+      rendered->version = version;
+      rendered->body.data.reserve(page != nullptr ? page->body.size : 0);
+      render(data_aggregator_->GetAggregatedTracezData(), rendered->body.data);
+      rendered->body.size = rendered->body.data.size();
+      cache.store(rendered);
+      page = std::move(rendered);
+    }
+  }
+  return page;
+}
+
+}  // namespace zpages
+}  // namespace ext
+OPENTELEMETRY_END_NAMESPACE
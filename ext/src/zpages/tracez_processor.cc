@@ -1,15 +1,39 @@
 #include "opentelemetry/ext/zpages/tracez_processor.h"
 
+#include <algorithm>
+
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace ext
 {
 namespace zpages
 {
 
+TracezSpanProcessor::~TracezSpanProcessor()
+{
+  ThreadsafeSpanData *span = ended_.exchange(nullptr, std::memory_order_acquire);
+  while (span != nullptr)
+  {
+    ThreadsafeSpanData *next = span->next_ended_;
+    delete span;
+    span = next;
+  }
+}
+
+void TracezSpanProcessor::Push(std::atomic<ThreadsafeSpanData *> &list,
+                               ThreadsafeSpanData *ThreadsafeSpanData::*next,
+                               ThreadsafeSpanData *span) noexcept
+{
+  ThreadsafeSpanData *head = list.load(std::memory_order_relaxed);
+  do
+  {
+    span->*next = head;
+  } while (!list.compare_exchange_weak(head, span, std::memory_order_release,
+                                       std::memory_order_relaxed));
+}
+
 void TracezSpanProcessor::OnStart(opentelemetry::sdk::trace::Recordable &span) noexcept
 {
-  std::lock_guard<std::mutex> lock(mtx_);
-  spans_.running.insert(static_cast<ThreadsafeSpanData *>(&span));
+  Push(started_, &ThreadsafeSpanData::next_started_, static_cast<ThreadsafeSpanData *>(&span));
 }
 
 void TracezSpanProcessor::OnEnd(
@@ -17,27 +41,81 @@ void TracezSpanProcessor::OnEnd(
 {
   if (span == nullptr)
     return;
-  auto span_raw = static_cast<ThreadsafeSpanData *>(span.get());
-  std::lock_guard<std::mutex> lock(mtx_);
-  auto span_it = spans_.running.find(span_raw);
-  if (span_it != spans_.running.end())
+  Push(ended_, &ThreadsafeSpanData::next_ended_,
+       static_cast<ThreadsafeSpanData *>(span.release()));
+}
+
+void TracezSpanProcessor::CollectSpans(
+    std::vector<ThreadsafeSpanData *> *started,
+    std::vector<std::unique_ptr<ThreadsafeSpanData>> &completed) noexcept
+{
+  // Collect the ended spans before the started ones: a span is started before
+  // it ends, so every collected ended span has been collected as started,
+  // either now or by an earlier call.
+  ThreadsafeSpanData *ended        = ended_.exchange(nullptr, std::memory_order_acquire);
+  ThreadsafeSpanData *started_list = started_.exchange(nullptr, std::memory_order_acquire);
+
+  for (; started_list != nullptr; started_list = started_list->next_started_)
+  {
+    running_.insert(started_list);
+    if (started != nullptr)
+    {
+      started->push_back(started_list);
+    }
+  }
+
+  // The list holds the most recently ended span first; reverse it to return
+  // completed spans in the order they ended.
+  ThreadsafeSpanData *in_order = nullptr;
+  while (ended != nullptr)
+  {
+    ThreadsafeSpanData *next = ended->next_ended_;
+    ended->next_ended_       = in_order;
+    in_order                 = ended;
+    ended                    = next;
+  }
+
+  while (in_order != nullptr)
   {
-    spans_.running.erase(span_it);
-    spans_.completed.push_back(
-        std::unique_ptr<ThreadsafeSpanData>(static_cast<ThreadsafeSpanData *>(span.release())));
+    std::unique_ptr<ThreadsafeSpanData> span(in_order);
+    in_order = in_order->next_ended_;
+    // Spans that were never started with this processor are dropped.
+    if (running_.erase(span.get()) != 0)
+    {
+      completed.push_back(std::move(span));
+    }
+  }
+
+  if (started != nullptr)
+  {
+    // Spans that started and ended since the last call are only reported as
+    // completed.
+    auto &spans = *started;
+    spans.erase(std::remove_if(spans.begin(), spans.end(),
+                               [this](ThreadsafeSpanData *span) {
+                                 return running_.find(span) == running_.end();
+                               }),
+                spans.end());
   }
 }
 
 TracezSpanProcessor::CollectedSpans TracezSpanProcessor::GetSpanSnapshot() noexcept
 {
   CollectedSpans snapshot;
-  std::lock_guard<std::mutex> lock(mtx_);
-  snapshot.running   = spans_.running;
-  snapshot.completed = std::move(spans_.completed);
-  spans_.completed.clear();
+  std::lock_guard<std::mutex> lock(snapshot_mtx_);
+  CollectSpans(nullptr, snapshot.completed);
+  snapshot.running = running_;
   return snapshot;
 }
 
+TracezSpanProcessor::SpanChanges TracezSpanProcessor::GetSpanChanges() noexcept
+{
+  SpanChanges changes;
+  std::lock_guard<std::mutex> lock(snapshot_mtx_);
+  CollectSpans(&changes.started, changes.completed);
+  return changes;
+}
+
 }  // namespace zpages
 }  // namespace ext
 OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,241 @@
+#include "opentelemetry/ext/http/server/file_http_server.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+class TestFileHttpServer : public HTTP_SERVER_NS::FileHttpServer
+{
+public:
+  TestFileHttpServer() : FileHttpServer("localhost", 0) { InitializeFileEndpoint(*this); }
+
+  ~TestFileHttpServer() { stop(); }
+
+  using FileHttpServer::GetPort;
+};
+
+struct Response
+{
+  int code = 0;
+  std::string headers;
+  std::string body;
+};
+
+class FileHttpServerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { server.start(); }
+
+  void TearDown() override
+  {
+    for (auto const &name : files)
+    {
+      std::remove(name.c_str());
+    }
+  }
+
+  // Returns a file name that is unique to the running test, so that tests
+  // running in parallel don't overwrite each other's files.
+  static std::string FileName(const std::string &extension)
+  {
+    return std::string("file_http_server_test_") +
+           ::testing::UnitTest::GetInstance()->current_test_info()->name() + extension;
+  }
+
+  void WriteFile(const std::string &name, const std::string &content)
+  {
+    std::ofstream file(name, std::ios::out | std::ios::binary | std::ios::trunc);
+    file << content;
+    files.push_back(name);
+  }
+
+  Response Get(const std::string &uri, const std::string &headers = "")
+  {
+    SocketTools::Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    EXPECT_TRUE(client.connect(SocketTools::SocketAddr(0x7f000001, server.GetPort())));
+    std::string request = "GET " + uri + " HTTP/1.0\r\n" + headers + "\r\n";
+    EXPECT_EQ(client.send(request.data(), static_cast<unsigned>(request.size())),
+              static_cast<int>(request.size()));
+
+    std::string received;
+    char buffer[4096];
+    int size;
+    while ((size = client.recv(buffer, sizeof(buffer))) > 0)
+    {
+      received.append(buffer, size);
+    }
+    client.close();
+
+    Response response;
+    size_t headers_end = received.find("\r\n\r\n");
+    if (received.size() > 12 && headers_end != std::string::npos)
+    {
+      response.code    = std::stoi(received.substr(9, 3));
+      response.headers = received.substr(0, headers_end + 2);
+      response.body    = received.substr(headers_end + 4);
+    }
+    return response;
+  }
+
+  static std::string GetHeader(const Response &response, const std::string &name)
+  {
+    size_t begin = response.headers.find("\r\n" + name + ": ");
+    if (begin == std::string::npos)
+    {
+      return "";
+    }
+    begin += name.size() + 4;
+    return response.headers.substr(begin, response.headers.find("\r\n", begin) - begin);
+  }
+
+  TestFileHttpServer server;
+  std::vector<std::string> files;
+};
+
+}  // namespace
+
+TEST_F(FileHttpServerTest, ServesFile)
+{
+  WriteFile(FileName(".html"), "<html></html>");
+  auto response = Get("/" + FileName(".html") + "?query");
+  EXPECT_EQ(response.code, 200);
+  EXPECT_EQ(response.body, "<html></html>");
+  EXPECT_EQ(GetHeader(response, "Content-Type"), "text/html");
+  EXPECT_EQ(GetHeader(response, "Content-Length"), "13");
+  EXPECT_FALSE(GetHeader(response, "ETag").empty());
+
+  EXPECT_EQ(Get("/" + FileName("_missing.html")).code, 404);
+  EXPECT_EQ(Get("/../" + FileName(".html")).code, 404);
+}
+
+TEST_F(FileHttpServerTest, RejectsAbsolutePath)
+{
+  WriteFile(FileName(".txt"), "content");
+  char cwd[4096];
+  ASSERT_NE(getcwd(cwd, sizeof(cwd)), nullptr);
+  std::string path = std::string(cwd) + "/" + FileName(".txt");
+  ASSERT_EQ(path[0], '/');
+
+  EXPECT_EQ(Get("/" + FileName(".txt")).code, 200);
+  EXPECT_EQ(Get("/" + path).code, 404);
+}
+
+TEST_F(FileHttpServerTest, ReloadsChangedFile)
+{
+  WriteFile(FileName(".txt"), "first");
+  auto first = Get("/" + FileName(".txt"));
+  EXPECT_EQ(first.body, "first");
+
+  WriteFile(FileName(".txt"), "changed");
+  auto changed = Get("/" + FileName(".txt"));
+  EXPECT_EQ(changed.body, "changed");
+  EXPECT_NE(GetHeader(changed, "ETag"), GetHeader(first, "ETag"));
+}
+
+TEST_F(FileHttpServerTest, ReloadsRewriteWithinSecond)
+{
+  // Rewritten with the same size in the same second
+  timespec times[2] = {{1600000000, 100}, {1600000000, 100}};
+  WriteFile(FileName(".txt"), "first");
+  ASSERT_EQ(utimensat(AT_FDCWD, FileName(".txt").c_str(), times, 0), 0);
+  auto first = Get("/" + FileName(".txt"));
+  EXPECT_EQ(first.body, "first");
+
+  times[1].tv_nsec = 200;
+  WriteFile(FileName(".txt"), "other");
+  ASSERT_EQ(utimensat(AT_FDCWD, FileName(".txt").c_str(), times, 0), 0);
+  auto other = Get("/" + FileName(".txt"), "If-None-Match: " + GetHeader(first, "ETag") + "\r\n");
+  EXPECT_EQ(other.code, 200);
+  EXPECT_EQ(other.body, "other");
+}
+
+TEST_F(FileHttpServerTest, NotModified)
+{
+  WriteFile(FileName(".txt"), "content");
+  std::string etag = GetHeader(Get("/" + FileName(".txt")), "ETag");
+
+  auto response = Get("/" + FileName(".txt"), "If-None-Match: \"other\", W/" + etag + "\r\n");
+  EXPECT_EQ(response.code, 304);
+  EXPECT_EQ(response.body, "");
+  EXPECT_EQ(GetHeader(response, "ETag"), etag);
+
+  EXPECT_EQ(Get("/" + FileName(".txt"), "If-None-Match: \"other\"\r\n").code, 200);
+}
+
+TEST_F(FileHttpServerTest, Range)
+{
+  WriteFile(FileName(".txt"), "0123456789");
+
+  auto response = Get("/" + FileName(".txt"), "Range: bytes=2-4\r\n");
+  EXPECT_EQ(response.code, 206);
+  EXPECT_EQ(response.body, "234");
+  EXPECT_EQ(GetHeader(response, "Content-Range"), "bytes 2-4/10");
+
+  EXPECT_EQ(Get("/" + FileName(".txt"), "Range: bytes=7-\r\n").body, "789");
+  EXPECT_EQ(Get("/" + FileName(".txt"), "Range: bytes=-2\r\n").body, "89");
+  EXPECT_EQ(Get("/" + FileName(".txt"), "Range: bytes=5-100\r\n").body, "56789");
+
+  response = Get("/" + FileName(".txt"), "Range: bytes=10-\r\n");
+  EXPECT_EQ(response.code, 416);
+  EXPECT_EQ(GetHeader(response, "Content-Range"), "bytes */10");
+
+  // Multiple ranges and ranges of an outdated entity are answered with the file
+  EXPECT_EQ(Get("/" + FileName(".txt"), "Range: bytes=0-1,3-4\r\n").code, 200);
+  EXPECT_EQ(Get("/" + FileName(".txt"), "Range: bytes=0-1\r\nIf-Range: \"old\"\r\n").code,
+            200);
+}
+
+TEST_F(FileHttpServerTest, LargeFile)
+{
+  std::string content;
+  for (int i = 0; content.size() < 1024 * 1024; i++)
+  {
+    content += std::to_string(i) + '\n';
+  }
+  WriteFile(FileName(".json"), content);
+
+  auto response = Get("/" + FileName(".json"));
+  EXPECT_EQ(response.code, 200);
+  EXPECT_TRUE(response.body == content);
+
+  response = Get("/" + FileName(".json"), "Range: bytes=500000-500009\r\n");
+  EXPECT_EQ(response.code, 206);
+  EXPECT_EQ(response.body, content.substr(500000, 10));
+}
+
+#ifdef __linux__
+TEST_F(FileHttpServerTest, BoundsOpenCachedFiles)
+{
+  auto count_open_files = [] {
+    int count = 0;
+    DIR *dir  = opendir("/proc/self/fd");
+    while (dir != nullptr && readdir(dir) != nullptr)
+    {
+      count++;
+    }
+    closedir(dir);
+    return count;
+  };
+
+  // Files this large are sent from an open descriptor
+  std::string content(300 * 1024, 'x');
+  int open_files = count_open_files();
+  for (int i = 0; i < 100; i++)
+  {
+    std::string name = FileName("_" + std::to_string(i) + ".txt");
+    WriteFile(name, content);
+    EXPECT_EQ(Get("/" + name).code, 200);
+  }
+  EXPECT_LE(count_open_files() - open_files, 64);
+}
+#endif
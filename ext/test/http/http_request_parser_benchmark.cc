@@ -0,0 +1,107 @@
+#include "opentelemetry/ext/http/server/http_request_parser.h"
+#include "opentelemetry/ext/http/server/http_server.h"
+
+#include <algorithm>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+using HTTP_SERVER_NS::HttpRequest;
+using HTTP_SERVER_NS::HttpRequestParser;
+using HTTP_SERVER_NS::HttpServer;
+
+namespace
+{
+// A request as sent by a command line client
+const std::string kCurlRequest =
+    "GET /tracez/get/aggregations HTTP/1.1\r\n"
+    "Host: localhost:30000\r\n"
+    "User-Agent: curl/7.68.0\r\n"
+    "Accept: */*\r\n"
+    "\r\n";
+
+// A request as sent by a browser
+const std::string kBrowserRequest =
+    "GET /tracez HTTP/1.1\r\n"
+    "Host: localhost:30000\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"86\", \"Google Chrome\";v=\"86\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+    "Chrome/86.0.4240.75 Safari/537.36\r\n"
+    "Accept: "
+    "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/"
+    "*;q=0.8,application/signed-exchange;v=b3;q=0.9\r\n"
+    "Sec-Fetch-Site: none\r\n"
+    "Sec-Fetch-Mode: navigate\r\n"
+    "Sec-Fetch-User: ?1\r\n"
+    "Sec-Fetch-Dest: document\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "\r\n";
+
+// Measures parsing a whole request without copying it.
+void BM_ParseZeroCopy(benchmark::State &state, const std::string &request)
+{
+  HttpRequestParser parser;
+  for (auto _ : state)
+  {
+    parser.reset();
+    benchmark::DoNotOptimize(parser.parse(request.data(), request.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK_CAPTURE(BM_ParseZeroCopy, curl, kCurlRequest);
+BENCHMARK_CAPTURE(BM_ParseZeroCopy, browser, kBrowserRequest);
+
+// Measures parsing a whole request and copying it into the strings and the
+// header map of an HttpRequest, as the server does outside zero-copy mode.
+void BM_ParseAndCopy(benchmark::State &state, const std::string &request)
+{
+  HttpRequestParser parser;
+  HttpRequest copy;
+  for (auto _ : state)
+  {
+    parser.reset();
+    parser.parse(request.data(), request.size());
+    HttpServer::copyRequest(parser, copy);
+    benchmark::DoNotOptimize(copy.headers.size());
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK_CAPTURE(BM_ParseAndCopy, curl, kCurlRequest);
+BENCHMARK_CAPTURE(BM_ParseAndCopy, browser, kBrowserRequest);
+
+// Measures parsing a request that arrives in reads of the given size.
+void BM_ParseIncremental(benchmark::State &state, const std::string &request)
+{
+  HttpRequestParser parser;
+  size_t read_size = static_cast<size_t>(state.range(0));
+  for (auto _ : state)
+  {
+    parser.reset();
+    for (size_t size = read_size; size < request.size() + read_size; size += read_size)
+    {
+      benchmark::DoNotOptimize(parser.parse(request.data(), std::min(size, request.size())));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK_CAPTURE(BM_ParseIncremental, browser, kBrowserRequest)->Arg(16)->Arg(128);
+
+// Measures looking up the last header of a parsed request.
+void BM_GetHeader(benchmark::State &state)
+{
+  HttpRequestParser parser;
+  parser.parse(kBrowserRequest.data(), kBrowserRequest.size());
+  opentelemetry::nostd::string_view value;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(parser.getHeader("accept-language", value));
+  }
+}
+BENCHMARK(BM_GetHeader);
+}  // namespace
+BENCHMARK_MAIN();
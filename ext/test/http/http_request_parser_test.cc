@@ -0,0 +1,78 @@
+#include "opentelemetry/ext/http/server/http_request_parser.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using HTTP_SERVER_NS::HttpRequestParser;
+
+TEST(HttpRequestParser, ParsesRequest)
+{
+  std::string request =
+      "GET /tracez HTTP/1.1\r\n"
+      "Host: localhost\r\n"
+      "Accept:  text/html \r\n"
+      "\r\n"
+      "body";
+  HttpRequestParser parser;
+  ASSERT_EQ(parser.parse(request.data(), request.size()), HttpRequestParser::Complete);
+  EXPECT_EQ(parser.method(), "GET");
+  EXPECT_EQ(parser.uri(), "/tracez");
+  EXPECT_EQ(parser.protocol(), "HTTP/1.1");
+  EXPECT_EQ(parser.headersLength(), request.size() - 4);
+  ASSERT_EQ(parser.headerCount(), 2);
+  EXPECT_EQ(parser.header(0).name, "Host");
+  EXPECT_EQ(parser.header(0).value, "localhost");
+
+  opentelemetry::nostd::string_view value;
+  ASSERT_TRUE(parser.getHeader("accept", value));
+  EXPECT_EQ(value, "text/html");
+  EXPECT_FALSE(parser.getHeader("Content-Length", value));
+}
+
+TEST(HttpRequestParser, ResumesAcrossPartialReads)
+{
+  std::string request = "POST /data HTTP/1.0\nContent-Length: 3\n\nabc";
+  std::string buffer;
+  HttpRequestParser parser;
+  size_t headers_end = request.find("\n\n") + 2;
+  for (size_t i = 0; i < request.size(); i++)
+  {
+    // Appending may move the buffer, which the parser must cope with
+    buffer.push_back(request[i]);
+    buffer.shrink_to_fit();
+    auto result = parser.parse(buffer.data(), buffer.size());
+    ASSERT_EQ(result, (i + 1 < headers_end) ? HttpRequestParser::Incomplete
+                                            : HttpRequestParser::Complete);
+  }
+  EXPECT_EQ(parser.headersLength(), headers_end);
+  EXPECT_EQ(parser.method(), "POST");
+  opentelemetry::nostd::string_view value;
+  ASSERT_TRUE(parser.getHeader("content-length", value));
+  EXPECT_EQ(value, "3");
+}
+
+TEST(HttpRequestParser, RejectsInvalidRequests)
+{
+  for (std::string request : {"GET\r\n\r\n", "GET / HTTP/1.1 extra\r\n\r\n",
+                              "GET / HTTP/1.1\r\nNo-Colon\r\n\r\n",
+                              "GET / HTTP/1.1\r\nBad Name: value\r\n\r\n"})
+  {
+    HttpRequestParser parser;
+    EXPECT_EQ(parser.parse(request.data(), request.size()), HttpRequestParser::Invalid)
+        << request;
+  }
+}
+
+TEST(HttpRequestParser, Reset)
+{
+  std::string first  = "GET /first HTTP/1.1\r\nA: 1\r\n\r\n";
+  std::string second = "\r\nGET /second HTTP/1.1\r\n\r\n";
+  HttpRequestParser parser;
+  ASSERT_EQ(parser.parse(first.data(), first.size()), HttpRequestParser::Complete);
+  parser.reset();
+  EXPECT_FALSE(parser.complete());
+  ASSERT_EQ(parser.parse(second.data(), second.size()), HttpRequestParser::Complete);
+  EXPECT_EQ(parser.uri(), "/second");
+  EXPECT_EQ(parser.headerCount(), 0);
+}
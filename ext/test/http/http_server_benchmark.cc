@@ -0,0 +1,385 @@
+#include "opentelemetry/ext/http/server/http_server.h"
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+/**
+ * Keeps a request in flight on each of a set of keep-alive connections and
+ * measures the latency of every request.
+ */
+class LoadGenerator
+{
+public:
+  LoadGenerator(int port, size_t connection_count) : epoll_fd_(::epoll_create1(0))
+  {
+    SocketTools::SocketAddr addr(SocketTools::SocketAddr::Loopback, port);
+    connections_.resize(connection_count);
+    for (auto &connection : connections_)
+    {
+      connection.socket = SocketTools::Socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      connection.socket.setNoDelay();
+      if (!connection.socket.connect(addr))
+      {
+        ok_ = false;
+      }
+      connection.socket.setNonBlocking();
+      epoll_event event = {};
+      event.events      = EPOLLIN;
+      event.data.ptr    = &connection;
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, connection.socket, &event);
+    }
+  }
+
+  ~LoadGenerator()
+  {
+    for (auto &connection : connections_)
+    {
+      connection.socket.close();
+    }
+    ::close(epoll_fd_);
+  }
+
+  bool ok() const { return ok_; }
+
+  /**
+   * Sends a request on every connection and waits for all responses.
+   * @param latencies receives the latency of every request in microseconds
+   * @return whether every request got a response
+   */
+  bool RunRound(std::vector<double> &latencies)
+  {
+    static const std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    auto start                       = std::chrono::steady_clock::now();
+    for (auto &connection : connections_)
+    {
+      connection.response.clear();
+      if (connection.socket.send(request.data(), static_cast<unsigned>(request.size())) !=
+          static_cast<int>(request.size()))
+      {
+        return false;
+      }
+    }
+
+    size_t pending = connections_.size();
+    epoll_event events[256];
+    while (pending > 0)
+    {
+      int count = ::epoll_wait(epoll_fd_, events, 256, 5000);
+      if (count <= 0)
+      {
+        return false;
+      }
+      for (int i = 0; i < count; ++i)
+      {
+        auto &connection = *static_cast<Connection *>(events[i].data.ptr);
+        char buffer[4096];
+        int received;
+        while ((received = connection.socket.recv(buffer, sizeof(buffer))) > 0)
+        {
+          connection.response.append(buffer, received);
+        }
+        if (received == 0)
+        {
+          return false;
+        }
+        if (IsComplete(connection.response))
+        {
+          auto latency = std::chrono::steady_clock::now() - start;
+          latencies.push_back(
+              std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(latency)
+                  .count());
+          --pending;
+        }
+      }
+    }
+    return true;
+  }
+
+private:
+  struct Connection
+  {
+    SocketTools::Socket socket;
+    std::string response;
+  };
+
+  // Whether the response holds the headers and the whole body
+  static bool IsComplete(const std::string &response)
+  {
+    size_t headers_end = response.find("\r\n\r\n");
+    if (headers_end == std::string::npos)
+    {
+      return false;
+    }
+    size_t length_pos = response.find("Content-Length: ");
+    size_t length     = 0;
+    if (length_pos != std::string::npos && length_pos < headers_end)
+    {
+      length = std::strtoul(response.c_str() + length_pos + 16, nullptr, 10);
+    }
+    return response.size() >= headers_end + 4 + length;
+  }
+
+  int epoll_fd_;
+  bool ok_ = true;
+  std::vector<Connection> connections_;
+};
+
+// Every connection needs a descriptor on both ends.
+void RaiseDescriptorLimit()
+{
+  rlimit limit;
+  if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+  {
+    limit.rlim_cur = limit.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+double Percentile(std::vector<double> &values, double percentile)
+{
+  size_t index = static_cast<size_t>(percentile * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+// Measures requests per second and request latency with a request in flight
+// on each of many keep-alive connections, for a number of reactor threads.
+void BM_KeepAliveRequests(benchmark::State &state)
+{
+  RaiseDescriptorLimit();
+
+  HTTP_SERVER_NS::HttpRequestCallback handler{
+      [](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        resp.headers[HTTP_SERVER_NS::CONTENT_TYPE] = HTTP_SERVER_NS::CONTENT_TYPE_TEXT;
+        resp.body                                  = "Hello, World!";
+        resp.code                                  = 200;
+        return resp.code;
+      }};
+  HTTP_SERVER_NS::HttpServer server;
+  server.setThreadCount(static_cast<size_t>(state.range(0)));
+  int port = server.addListeningPort(0);
+  server["/"] = handler;
+  server.start();
+
+  std::vector<double> latencies;
+  {
+    LoadGenerator generator(port, static_cast<size_t>(state.range(1)));
+    if (!generator.ok())
+    {
+      state.SkipWithError("cannot connect to the server");
+    }
+    for (auto _ : state)
+    {
+      if (!generator.RunRound(latencies))
+      {
+        state.SkipWithError("request failed");
+        break;
+      }
+    }
+  }
+  server.stop();
+
+  state.SetItemsProcessed(static_cast<int64_t>(latencies.size()));
+  if (!latencies.empty())
+  {
+    state.counters["p50_us"] = Percentile(latencies, 0.5);
+    state.counters["p99_us"] = Percentile(latencies, 0.99);
+  }
+}
+BENCHMARK(BM_KeepAliveRequests)
+    ->ArgNames({"threads", "connections"})
+    ->Args({1, 1000})
+    ->Args({2, 1000})
+    ->Args({4, 1000})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * A client sending requests on a single keep-alive connection.
+ */
+class Client
+{
+public:
+  explicit Client(int port) : socket_(AF_INET, SOCK_STREAM, IPPROTO_TCP)
+  {
+    socket_.setNoDelay();
+    ok_ = socket_.connect(SocketTools::SocketAddr(SocketTools::SocketAddr::Loopback, port));
+  }
+
+  ~Client() { socket_.close(); }
+
+  bool ok() const { return ok_; }
+
+  /**
+   * Sends the requests with a single write and waits for the responses.
+   * @return the number of bytes received, or 0 if a request failed
+   */
+  size_t Exchange(const std::string &requests, size_t count)
+  {
+    if (socket_.send(requests.data(), static_cast<unsigned>(requests.size())) !=
+        static_cast<int>(requests.size()))
+    {
+      return 0;
+    }
+    buffer_.clear();
+    checked_   = 0;
+    size_t pos = 0;
+    while (count > 0)
+    {
+      size_t length = ResponseLength(pos);
+      if (length > 0)
+      {
+        pos += length;
+        --count;
+        continue;
+      }
+      char chunk[65536];
+      int received = socket_.recv(chunk, sizeof(chunk));
+      if (received <= 0)
+      {
+        return 0;
+      }
+      buffer_.append(chunk, received);
+    }
+    return pos;
+  }
+
+private:
+  // The length of the response at pos if it was received completely
+  size_t ResponseLength(size_t pos)
+  {
+    // Only the bytes received since the last call are searched for the end
+    // of a chunked body
+    size_t checked = std::max(checked_, pos);
+    checked_       = buffer_.size();
+
+    size_t headers_end = buffer_.find("\r\n\r\n", pos);
+    if (headers_end == std::string::npos)
+    {
+      return 0;
+    }
+    headers_end += 4;
+    std::string headers = buffer_.substr(pos, headers_end - pos);
+    size_t length_pos   = headers.find("Content-Length: ");
+    if (length_pos == std::string::npos)
+    {
+      // The body is chunked
+      size_t from = std::max(headers_end - 2, (checked > 7) ? checked - 7 : 0);
+      size_t end  = buffer_.find("\r\n0\r\n\r\n", from);
+      return (end != std::string::npos) ? end + 7 - pos : 0;
+    }
+    size_t length = std::strtoul(headers.c_str() + length_pos + 16, nullptr, 10);
+    return (buffer_.size() >= headers_end + length) ? headers_end + length - pos : 0;
+  }
+
+  SocketTools::Socket socket_;
+  bool ok_;
+  std::string buffer_;
+  size_t checked_ = 0;
+};
+
+// Measures requests per second when a client pipelines requests on a
+// connection, for a number of requests per write.
+void BM_PipelinedRequests(benchmark::State &state)
+{
+  HTTP_SERVER_NS::HttpRequestCallback handler{
+      [](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        resp.headers[HTTP_SERVER_NS::CONTENT_TYPE] = HTTP_SERVER_NS::CONTENT_TYPE_TEXT;
+        resp.body                                  = "Hello, World!";
+        resp.code                                  = 200;
+        return resp.code;
+      }};
+  HTTP_SERVER_NS::HttpServer server;
+  int port    = server.addListeningPort(0);
+  server["/"] = handler;
+  server.start();
+
+  size_t depth = static_cast<size_t>(state.range(0));
+  std::string requests;
+  for (size_t i = 0; i < depth; ++i)
+  {
+    requests += "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  }
+  {
+    Client client(port);
+    for (auto _ : state)
+    {
+      if (!client.ok() || client.Exchange(requests, depth) == 0)
+      {
+        state.SkipWithError("request failed");
+        break;
+      }
+    }
+  }
+  server.stop();
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * depth));
+}
+BENCHMARK(BM_PipelinedRequests)->Arg(1)->Arg(16)->UseRealTime();
+
+// Measures scraping a large page that is copied into every response, shared
+// between responses, or streamed in 64 KiB chunks.
+void BM_LargePage(benchmark::State &state)
+{
+  const size_t page_size = 4 * 1024 * 1024;
+  auto page              = std::make_shared<HTTP_SERVER_NS::HttpSharedBody>();
+  page->data.assign(page_size, 'x');
+  page->size = page_size;
+
+  int mode = static_cast<int>(state.range(0));
+  HTTP_SERVER_NS::HttpRequestCallback handler{
+      [page, mode](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        if (mode == 0)
+        {
+          resp.body = page->data;
+        }
+        else if (mode == 1)
+        {
+          resp.sharedBody       = page;
+          resp.sharedBodyOffset = 0;
+          resp.sharedBodyLength = page->size;
+        }
+        else
+        {
+          auto offset     = std::make_shared<size_t>(0);
+          resp.streamBody = [page, offset](std::string &chunk) {
+            size_t size = std::min<size_t>(64 * 1024, page->size - *offset);
+            chunk.append(page->data, *offset, size);
+            *offset += size;
+            return *offset < page->size;
+          };
+        }
+        resp.code = 200;
+        return resp.code;
+      }};
+  HTTP_SERVER_NS::HttpServer server;
+  int port    = server.addListeningPort(0);
+  server["/"] = handler;
+  server.start();
+  {
+    Client client(port);
+    for (auto _ : state)
+    {
+      if (!client.ok() || client.Exchange("GET /metrics HTTP/1.1\r\n\r\n", 1) == 0)
+      {
+        state.SkipWithError("request failed");
+        break;
+      }
+    }
+  }
+  server.stop();
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * page_size));
+}
+BENCHMARK(BM_LargePage)->ArgName("copy_shared_stream")->DenseRange(0, 2)->UseRealTime();
+}  // namespace
+BENCHMARK_MAIN();
@@ -0,0 +1,292 @@
+#include "opentelemetry/ext/http/server/http_server.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+class HttpServerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    shared_body->data = "shared body";
+    shared_body->size = shared_body->data.size();
+
+    port              = server.addListeningPort(0);
+    server["/stream"] = stream_handler;
+    server["/shared"] = shared_handler;
+    server["/close"]  = close_handler;
+    server["/"]       = echo_handler;
+    server.start();
+  }
+
+  void TearDown() override { server.stop(); }
+
+  // Sends the requests with a single write and returns everything received
+  // until the server closes the connection.
+  std::string Exchange(const std::string &requests)
+  {
+    SocketTools::Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    EXPECT_TRUE(client.connect(SocketTools::SocketAddr(0x7f000001, port)));
+    EXPECT_EQ(client.send(requests.data(), static_cast<unsigned>(requests.size())),
+              static_cast<int>(requests.size()));
+
+    std::string received;
+    char buffer[4096];
+    int size;
+    while ((size = client.recv(buffer, sizeof(buffer))) > 0)
+    {
+      received.append(buffer, size);
+    }
+    client.close();
+    return received;
+  }
+
+  static size_t Count(const std::string &str, const std::string &part)
+  {
+    size_t count = 0;
+    for (size_t pos = str.find(part); pos != std::string::npos; pos = str.find(part, pos + 1))
+    {
+      count++;
+    }
+    return count;
+  }
+
+  HTTP_SERVER_NS::HttpRequestCallback echo_handler{
+      [](HTTP_SERVER_NS::HttpRequest const &req, HTTP_SERVER_NS::HttpResponse &resp) {
+        resp.headers[HTTP_SERVER_NS::CONTENT_TYPE] = HTTP_SERVER_NS::CONTENT_TYPE_TEXT;
+        resp.body                                  = "[" + req.uri + "]";
+        resp.code                                  = 200;
+        return resp.code;
+      }};
+
+  // Streams the numbers 0 to 2 as separate parts of the body
+  HTTP_SERVER_NS::HttpRequestCallback stream_handler{
+      [](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        auto next       = std::make_shared<int>(0);
+        resp.streamBody = [next](std::string &chunk) {
+          chunk += std::to_string((*next)++);
+          return *next < 3;
+        };
+        resp.code = 200;
+        return resp.code;
+      }};
+
+  // Sends a part of a body shared between responses
+  std::shared_ptr<HTTP_SERVER_NS::HttpSharedBody> shared_body{
+      new HTTP_SERVER_NS::HttpSharedBody()};
+  HTTP_SERVER_NS::HttpRequestCallback shared_handler{
+      [this](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &resp) {
+        resp.sharedBody       = shared_body;
+        resp.sharedBodyOffset = 7;
+        resp.sharedBodyLength = 4;
+        resp.code             = 200;
+        return resp.code;
+      }};
+
+  // Closes the connection without a response
+  HTTP_SERVER_NS::HttpRequestCallback close_handler{
+      [](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &) { return -1; }};
+
+  HTTP_SERVER_NS::HttpServer server;
+  int port;
+};
+
+// A server with several workers that reports how many of them listen, and
+// that can pretend SO_REUSEPORT is unsupported.
+class MultiWorkerHttpServer : public HTTP_SERVER_NS::HttpServer
+{
+public:
+  explicit MultiWorkerHttpServer(bool reusePort) : m_reusePort(reusePort) {}
+
+  size_t listeningWorkers() const
+  {
+    size_t count = 0;
+    for (auto &worker : m_workers)
+    {
+      count += worker->m_listeningSockets.empty() ? 0 : 1;
+    }
+    return count;
+  }
+
+protected:
+  bool enableReusePort(SocketTools::Socket &socket) override
+  {
+    return m_reusePort && HttpServer::enableReusePort(socket);
+  }
+
+private:
+  bool m_reusePort;
+};
+
+// Opens connections from several threads at once, sends a few pipelined
+// requests on each and checks that every response arrives on the connection
+// it belongs to.
+void ExpectConcurrentRequestsServed(MultiWorkerHttpServer &server)
+{
+  const int kThreads = 8, kConnections = 16, kRequests = 4;
+  std::atomic<int> failures{0};
+  HTTP_SERVER_NS::HttpRequestCallback echo_handler{
+      [](HTTP_SERVER_NS::HttpRequest const &req, HTTP_SERVER_NS::HttpResponse &resp) {
+        resp.body = "[" + req.uri + "]";
+        resp.code = 200;
+        return resp.code;
+      }};
+  server["/"] = echo_handler;
+  server.setThreadCount(4);
+  int port = server.addListeningPort(0);
+  server.start();
+
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kThreads; ++thread)
+  {
+    threads.emplace_back([&, thread] {
+      for (int connection = 0; connection < kConnections; ++connection)
+      {
+        std::string prefix = "/" + std::to_string(thread) + "/" + std::to_string(connection);
+        std::string requests;
+        for (int request = 0; request < kRequests; ++request)
+        {
+          requests += "GET " + prefix + "/" + std::to_string(request) + " HTTP/1.1\r\n";
+          requests += request + 1 == kRequests ? "Connection: close\r\n\r\n" : "\r\n";
+        }
+
+        SocketTools::Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (!client.connect(SocketTools::SocketAddr(0x7f000001, port)) ||
+            client.send(requests.data(), static_cast<unsigned>(requests.size())) !=
+                static_cast<int>(requests.size()))
+        {
+          failures++;
+          client.close();
+          continue;
+        }
+        std::string received;
+        char buffer[4096];
+        int size;
+        while ((size = client.recv(buffer, sizeof(buffer))) > 0)
+        {
+          received.append(buffer, size);
+        }
+        client.close();
+
+        size_t pos = 0;
+        for (int request = 0; request < kRequests; ++request)
+        {
+          pos = received.find("[" + prefix + "/" + std::to_string(request) + "]", pos);
+          if (pos == std::string::npos)
+          {
+            failures++;
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  server.stop();
+  EXPECT_EQ(failures.load(), 0);
+}
+
+}  // namespace
+
+TEST(HttpServerMultiWorkerTest, ConcurrentConnections)
+{
+  MultiWorkerHttpServer server(true);
+  ExpectConcurrentRequestsServed(server);
+#ifdef SO_REUSEPORT
+  EXPECT_EQ(server.listeningWorkers(), 4u);
+#endif
+}
+
+TEST(HttpServerMultiWorkerTest, FallbackWithoutReusePort)
+{
+  MultiWorkerHttpServer server(false);
+  ExpectConcurrentRequestsServed(server);
+  EXPECT_EQ(server.listeningWorkers(), 1u);
+}
+
+TEST_F(HttpServerTest, PipelinedRequests)
+{
+  std::string response = Exchange(
+      "GET /first HTTP/1.1\r\n\r\n"
+      "POST /second HTTP/1.1\r\nContent-Length: 4\r\n\r\nbody"
+      "GET /third HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+  EXPECT_EQ(Count(response, "HTTP/1.1 200 OK\r\n"), 3u);
+  size_t first  = response.find("\r\n\r\n[/first]");
+  size_t second = response.find("\r\n\r\n[/second]");
+  size_t third  = response.find("\r\n\r\n[/third]");
+  EXPECT_NE(first, std::string::npos);
+  EXPECT_NE(second, std::string::npos);
+  EXPECT_NE(third, std::string::npos);
+  EXPECT_LT(first, second);
+  EXPECT_LT(second, third);
+  EXPECT_EQ(response.substr(response.size() - 8), "[/third]");
+}
+
+TEST_F(HttpServerTest, ChunkedStreaming)
+{
+  std::string response = Exchange(
+      "GET /stream HTTP/1.1\r\n\r\n"
+      "GET /after HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+  EXPECT_NE(response.find("Transfer-Encoding: chunked\r\n"), std::string::npos);
+  EXPECT_NE(response.find("\r\n\r\n1\r\n0\r\n1\r\n1\r\n1\r\n2\r\n0\r\n\r\nHTTP/1.1 200 OK"),
+            std::string::npos);
+  EXPECT_EQ(Count(response, "Content-Length"), 1u);
+  EXPECT_EQ(response.substr(response.size() - 8), "[/after]");
+}
+
+TEST_F(HttpServerTest, StreamingToHttp10)
+{
+  std::string response = Exchange("GET /stream HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+
+  EXPECT_EQ(response.find("Transfer-Encoding"), std::string::npos);
+  EXPECT_EQ(response.find("Content-Length"), std::string::npos);
+  EXPECT_NE(response.find("Connection: close\r\n"), std::string::npos);
+  EXPECT_EQ(response.substr(response.size() - 7), "\r\n\r\n012");
+}
+
+TEST_F(HttpServerTest, SharedBody)
+{
+  std::string response = Exchange("GET /shared HTTP/1.0\r\n\r\n");
+  EXPECT_NE(response.find("Content-Length: 4\r\n"), std::string::npos);
+  EXPECT_EQ(response.substr(response.size() - 8), "\r\n\r\nbody");
+}
+
+TEST_F(HttpServerTest, ClosedByHandler)
+{
+  EXPECT_EQ(Exchange("GET /close HTTP/1.1\r\n\r\n"), "");
+
+  // The next connection, likely on the same socket, gets only its own response
+  std::string response = Exchange("GET /next HTTP/1.1\r\nConnection: close\r\n\r\n");
+  EXPECT_EQ(response.find("HTTP/1.1 200 OK\r\n"), 0u);
+  EXPECT_EQ(Count(response, "HTTP/1.1"), 1u);
+  EXPECT_EQ(response.substr(response.size() - 7), "[/next]");
+}
+
+TEST_F(HttpServerTest, InvalidContentLength)
+{
+  // Would wrap to 0, so that the body would be taken for the next request
+  std::string response = Exchange(
+      "POST /first HTTP/1.1\r\nContent-Length: 18446744073709551616\r\n\r\n"
+      "GET /smuggled HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(response.find("HTTP/1.1 400 Bad Request\r\n"), 0u);
+  EXPECT_EQ(response.find("[/smuggled]"), std::string::npos);
+  EXPECT_EQ(Count(response, "HTTP/1.1"), 1u);
+
+  response = Exchange("POST /first HTTP/1.1\r\nContent-Length: 4x\r\n\r\nbody");
+  EXPECT_EQ(response.find("HTTP/1.1 400 Bad Request\r\n"), 0u);
+  response = Exchange("POST /first HTTP/1.1\r\nContent-Length:\r\n\r\n");
+  EXPECT_EQ(response.find("HTTP/1.1 400 Bad Request\r\n"), 0u);
+}
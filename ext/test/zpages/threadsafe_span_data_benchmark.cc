@@ -0,0 +1,112 @@
+#include "opentelemetry/ext/zpages/threadsafe_span_data.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+using opentelemetry::ext::zpages::ThreadsafeSpanData;
+
+namespace
+{
+// Fills in span data the way a span with a few attributes would.
+void FillSpanData(ThreadsafeSpanData &data)
+{
+  data.SetName("span name");
+  data.SetStatus(opentelemetry::trace::CanonicalCode::OK, "description");
+  for (int i = 0; i < 10; ++i)
+  {
+    data.SetAttribute("attribute" + std::to_string(i), i);
+  }
+}
+
+// Measures reading every field of span data through its getters, optionally
+// while another thread keeps modifying it.
+void BM_ReadGetters(benchmark::State &state, bool with_writer)
+{
+  ThreadsafeSpanData data;
+  FillSpanData(data);
+  std::atomic<bool> stop{false};
+  std::thread writer;
+  if (with_writer)
+  {
+    writer = std::thread([&] {
+      for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+      {
+        data.SetAttribute("counter", i);
+      }
+    });
+  }
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(data.GetTraceId());
+    benchmark::DoNotOptimize(data.GetSpanId());
+    benchmark::DoNotOptimize(data.GetName());
+    benchmark::DoNotOptimize(data.GetStatus());
+    benchmark::DoNotOptimize(data.GetDescription());
+    benchmark::DoNotOptimize(data.GetStartTime());
+    benchmark::DoNotOptimize(data.GetDuration());
+    benchmark::DoNotOptimize(data.GetAttributes());
+  }
+  stop = true;
+  if (writer.joinable())
+  {
+    writer.join();
+  }
+}
+BENCHMARK_CAPTURE(BM_ReadGetters, idle, false);
+BENCHMARK_CAPTURE(BM_ReadGetters, while_writing, true);
+
+// Measures reading every field of span data through a single snapshot,
+// optionally while another thread keeps modifying it.
+void BM_ReadSnapshot(benchmark::State &state, bool with_writer)
+{
+  ThreadsafeSpanData data;
+  FillSpanData(data);
+  std::atomic<bool> stop{false};
+  std::thread writer;
+  if (with_writer)
+  {
+    writer = std::thread([&] {
+      for (int64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+      {
+        data.SetAttribute("counter", i);
+      }
+    });
+  }
+  for (auto _ : state)
+  {
+    auto snapshot = data.GetSnapshot();
+    benchmark::DoNotOptimize(snapshot->GetTraceId());
+    benchmark::DoNotOptimize(snapshot->GetSpanId());
+    benchmark::DoNotOptimize(snapshot->GetName());
+    benchmark::DoNotOptimize(snapshot->GetStatus());
+    benchmark::DoNotOptimize(snapshot->GetDescription());
+    benchmark::DoNotOptimize(snapshot->GetStartTime());
+    benchmark::DoNotOptimize(snapshot->GetDuration());
+    benchmark::DoNotOptimize(snapshot->GetAttributes().size());
+  }
+  stop = true;
+  if (writer.joinable())
+  {
+    writer.join();
+  }
+}
+BENCHMARK_CAPTURE(BM_ReadSnapshot, idle, false);
+BENCHMARK_CAPTURE(BM_ReadSnapshot, while_writing, true);
+
+// Measures the cost of a write for the span owner.
+void BM_SetAttribute(benchmark::State &state)
+{
+  ThreadsafeSpanData data;
+  FillSpanData(data);
+  int64_t i = 0;
+  for (auto _ : state)
+  {
+    data.SetAttribute("counter", ++i);
+  }
+}
+BENCHMARK(BM_SetAttribute);
+}  // namespace
+BENCHMARK_MAIN();
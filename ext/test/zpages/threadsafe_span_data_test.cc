@@ -4,6 +4,7 @@
 #include "opentelemetry/trace/trace_id.h"
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <thread>
 
 using opentelemetry::ext::zpages::ThreadsafeSpanData;
@@ -53,3 +54,88 @@ TEST(ThreadsafeSpanData, Set)
   ASSERT_EQ(data.GetDuration(), std::chrono::nanoseconds(1000000));
   ASSERT_EQ(opentelemetry::nostd::get<int64_t>(data.GetAttributes().at("attr1")), 314159);
 }
+
+TEST(ThreadsafeSpanData, SnapshotIsSharedUntilModified)
+{
+  ThreadsafeSpanData data;
+  data.SetName("span name");
+  data.SetAttribute("attr1", 1);
+
+  auto snapshot = data.GetSnapshot();
+  ASSERT_EQ(data.GetSnapshot(), snapshot);
+
+  data.SetAttribute("attr2", 2);
+  auto modified = data.GetSnapshot();
+  ASSERT_NE(modified, snapshot);
+
+  // The earlier snapshot keeps the data it was taken with
+  ASSERT_EQ(snapshot->GetAttributes().size(), 1);
+  ASSERT_EQ(modified->GetAttributes().size(), 2);
+  ASSERT_EQ(modified->GetName(), "span name");
+}
+
+TEST(ThreadsafeSpanData, CopySharesSnapshot)
+{
+  ThreadsafeSpanData data;
+  data.SetAttribute("attr1", 1);
+
+  ThreadsafeSpanData copy(data);
+  ASSERT_EQ(copy.GetSnapshot(), data.GetSnapshot());
+
+  copy.SetAttribute("attr2", 2);
+  ASSERT_EQ(copy.GetAttributes().size(), 2);
+  ASSERT_EQ(data.GetAttributes().size(), 1);
+}
+
+TEST(ThreadsafeSpanData, ConsistentSnapshotWhileWriting)
+{
+  ThreadsafeSpanData data;
+  std::thread writer([&data] {
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+      data.SetAttribute("first", i);
+      data.SetAttribute("second", i);
+      data.GetSnapshot();
+    }
+  });
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto snapshot          = data.GetSnapshot();
+    const auto &attributes = snapshot->GetAttributes();
+    auto first             = attributes.find("first");
+    auto second            = attributes.find("second");
+    if (first != attributes.end() && second != attributes.end())
+    {
+      int64_t first_value  = opentelemetry::nostd::get<int64_t>(first->second);
+      int64_t second_value = opentelemetry::nostd::get<int64_t>(second->second);
+      ASSERT_TRUE(first_value == second_value || first_value == second_value + 1);
+    }
+  }
+  writer.join();
+}
+
+TEST(ThreadsafeSpanData, ConsistentTraceIdWhileWriting)
+{
+  ThreadsafeSpanData data;
+  std::thread writer([&data] {
+    for (int i = 0; i < 1000; ++i)
+    {
+      uint8_t id[opentelemetry::trace::TraceId::kSize];
+      memset(id, i % 256, sizeof(id));
+      data.SetIds(opentelemetry::trace::TraceId(id), opentelemetry::trace::SpanId(),
+                  opentelemetry::trace::SpanId());
+    }
+  });
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto trace_id = data.GetTraceId();
+    auto bytes    = trace_id.Id();
+    for (size_t byte = 1; byte < bytes.size(); ++byte)
+    {
+      ASSERT_EQ(bytes[byte], bytes[0]);
+    }
+  }
+  writer.join();
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <numeric>
+
 #include "opentelemetry/ext/zpages/tracez_processor.h"
 #include "opentelemetry/sdk/trace/recordable.h"
 #include "opentelemetry/sdk/trace/tracer.h"
@@ -516,6 +518,42 @@ TEST_F(TracezDataAggregatorTest, AdditionToRunningSpans)
   }
 }
 
+/** This test checks to see that running span counts stay correct when many
+ * running spans of several names complete over multiple updates **/
+TEST_F(TracezDataAggregatorTest, ManyRunningSpansCompleteIncrementally)
+{
+  const int num_spans = 300;
+  std::vector<opentelemetry::nostd::unique_ptr<Span>> spans;
+  for (int i = 0; i < num_spans; i++)
+  {
+    spans.push_back(tracer->StartSpan(i % 2 == 0 ? span_name1 : span_name2));
+  }
+  std::this_thread::sleep_for(milliseconds(500));
+  auto data = tracez_data_aggregator->GetAggregatedTracezData();
+  ASSERT_EQ(data.size(), 2);
+  EXPECT_EQ(data.at(span_name1).running_span_count, num_spans / 2);
+  EXPECT_EQ(data.at(span_name2).running_span_count, num_spans / 2);
+  EXPECT_EQ(data.at(span_name1).sample_running_spans.size(), kMaxNumberOfSampleSpans);
+
+  // End all spans of the first name and a third of the spans of the second.
+  for (int i = 0; i < num_spans; i++)
+  {
+    if (i % 2 == 0 || i % 3 == 0)
+    {
+      spans[i]->End();
+    }
+  }
+  std::this_thread::sleep_for(milliseconds(500));
+  data = tracez_data_aggregator->GetAggregatedTracezData();
+  ASSERT_EQ(data.size(), 2);
+  EXPECT_EQ(data.at(span_name1).running_span_count, 0);
+  EXPECT_EQ(data.at(span_name1).sample_running_spans.size(), 0);
+  auto &completed_counts = data.at(span_name1).completed_span_count_per_latency_bucket;
+  EXPECT_EQ(std::accumulate(completed_counts.begin(), completed_counts.end(), 0), num_spans / 2);
+  EXPECT_EQ(data.at(span_name2).running_span_count, num_spans / 2 - num_spans / 6);
+  EXPECT_EQ(data.at(span_name2).sample_running_spans.size(), kMaxNumberOfSampleSpans);
+}
+
 /** This test checks to see that once a running span is completed it the
  * aggregated data is updated correctly **/
 TEST_F(TracezDataAggregatorTest, RemovalOfRunningSpanWhenCompleted)
@@ -0,0 +1,104 @@
+#include "opentelemetry/ext/zpages/tracez_http_server.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "opentelemetry/ext/zpages/tracez_processor.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+
+using namespace opentelemetry::sdk::trace;
+using namespace opentelemetry::ext::zpages;
+
+/** Test fixture for setting up the tracer and the server for each test **/
+class TracezHttpServerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::shared_ptr<TracezSpanProcessor> processor(new TracezSpanProcessor());
+    tracer     = std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(processor));
+    aggregator = new TracezDataAggregator(processor, milliseconds(10));
+    server     = std::unique_ptr<TracezHttpServer>(new TracezHttpServer(
+        std::unique_ptr<TracezDataAggregator>(aggregator), "localhost", 0));
+  }
+
+  /** Waits until the aggregated data changes from the given version **/
+  void WaitForNewVersion(uint64_t version)
+  {
+    for (int i = 0; i < 500 && aggregator->GetDataVersion() == version; ++i)
+    {
+      std::this_thread::sleep_for(milliseconds(2));
+    }
+    ASSERT_NE(aggregator->GetDataVersion(), version);
+  }
+
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer;
+  TracezDataAggregator *aggregator;
+  std::unique_ptr<TracezHttpServer> server;
+};
+
+/** Pages are rendered again only when the aggregated data changes **/
+TEST_F(TracezHttpServerTest, PagesCachedUntilDataChanges)
+{
+  auto json = server->GetAggregationsJson();
+  auto html = server->GetTracezHtml();
+  EXPECT_EQ(*json, "[]");
+  EXPECT_EQ(server->GetAggregationsJson(), json);
+  EXPECT_EQ(server->GetTracezHtml(), html);
+
+  uint64_t version = aggregator->GetDataVersion();
+  tracer->StartSpan("span")->End();
+  WaitForNewVersion(version);
+
+  auto new_json = server->GetAggregationsJson();
+  EXPECT_NE(new_json, json);
+  EXPECT_NE(new_json->find("\"name\":\"span\""), std::string::npos);
+  EXPECT_NE(server->GetTracezHtml(), html);
+  EXPECT_NE(server->GetTracezHtml()->find("<td>span</td>"), std::string::npos);
+}
+
+/** Span data is escaped and sample spans are included in the JSON **/
+TEST_F(TracezHttpServerTest, RendersSamples)
+{
+  uint64_t version = aggregator->GetDataVersion();
+  auto span        = tracer->StartSpan("quoted \"span\"");
+  span->SetAttribute("attribute", 42);
+  span->SetStatus(opentelemetry::trace::CanonicalCode::UNKNOWN, "line\nbreak");
+  span->End();
+  WaitForNewVersion(version);
+
+  auto json = server->GetAggregationsJson();
+  EXPECT_NE(json->find("\"name\":\"quoted \\\"span\\\"\""), std::string::npos);
+  EXPECT_NE(json->find("\"error\":1"), std::string::npos);
+  EXPECT_NE(json->find("\"attributes\":{\"attribute\":42}"), std::string::npos);
+  EXPECT_NE(json->find("\"description\":\"line\\nbreak\""), std::string::npos);
+  EXPECT_NE(server->GetTracezHtml()->find("quoted &quot;span&quot;"), std::string::npos);
+}
+
+/** The JSON is served over HTTP **/
+TEST_F(TracezHttpServerTest, ServesJson)
+{
+  server->start();
+
+  SocketTools::Socket client(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  ASSERT_TRUE(client.connect(SocketTools::SocketAddr(0x7f000001, server->GetPort())));
+  std::string request = "GET /tracez/get/aggregations HTTP/1.0\r\n\r\n";
+  ASSERT_EQ(client.send(request.data(), static_cast<unsigned>(request.size())),
+            static_cast<int>(request.size()));
+
+  std::string response;
+  char buffer[1024];
+  int received;
+  while ((received = client.recv(buffer, sizeof(buffer))) > 0)
+  {
+    response.append(buffer, received);
+  }
+  client.close();
+  server->stop();
+
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.0 200 OK"), 0);
+  EXPECT_NE(response.find("Content-Type: application/json"), std::string::npos);
+  EXPECT_EQ(response.substr(response.size() - 2), "[]");
+}
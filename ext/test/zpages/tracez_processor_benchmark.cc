@@ -0,0 +1,102 @@
+#include "opentelemetry/ext/zpages/tracez_processor.h"
+#include "opentelemetry/sdk/trace/simple_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+using namespace opentelemetry::sdk::trace;
+using opentelemetry::ext::zpages::TracezSpanProcessor;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+/**
+ * An exporter that discards the spans it receives.
+ */
+class DiscardingSpanExporter final : public SpanExporter
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> & /*spans*/) noexcept override
+  {
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds /*timeout*/) noexcept override {}
+};
+
+std::shared_ptr<opentelemetry::trace::Tracer> tracer;
+std::shared_ptr<TracezSpanProcessor> tracez_processor;
+std::atomic<bool> stop_snapshots{false};
+std::thread snapshot_thread;
+
+// Takes snapshots at the rate of a busy zPages aggregator, discarding them.
+void TakeSnapshots()
+{
+  while (!stop_snapshots.load())
+  {
+    tracez_processor->GetSpanSnapshot();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void SetUp(const benchmark::State &state, bool use_tracez)
+{
+  if (state.thread_index() != 0)
+  {
+    return;
+  }
+  if (use_tracez)
+  {
+    tracez_processor = std::make_shared<TracezSpanProcessor>();
+    tracer           = std::make_shared<Tracer>(tracez_processor);
+    stop_snapshots   = false;
+    snapshot_thread  = std::thread(TakeSnapshots);
+  }
+  else
+  {
+    std::unique_ptr<SpanExporter> exporter(new DiscardingSpanExporter);
+    tracer = std::make_shared<Tracer>(std::make_shared<SimpleSpanProcessor>(std::move(exporter)));
+  }
+}
+
+void TearDown(const benchmark::State &state)
+{
+  if (state.thread_index() != 0)
+  {
+    return;
+  }
+  if (snapshot_thread.joinable())
+  {
+    stop_snapshots = true;
+    snapshot_thread.join();
+  }
+  tracer.reset();
+  tracez_processor.reset();
+}
+
+// Measures starting and ending spans from several threads, while another
+// thread takes snapshots if the tracez processor is used.
+void BM_StartEndSpan(benchmark::State &state, bool use_tracez)
+{
+  SetUp(state, use_tracez);
+  for (auto _ : state)
+  {
+    tracer->StartSpan("span")->End();
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDown(state);
+}
+BENCHMARK_CAPTURE(BM_StartEndSpan, without_tracez, false)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_CAPTURE(BM_StartEndSpan, with_tracez, true)->ThreadRange(1, 8)->UseRealTime();
+}  // namespace
+BENCHMARK_MAIN();
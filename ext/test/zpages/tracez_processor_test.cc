@@ -6,6 +6,7 @@
 
 #include "opentelemetry/ext/zpages/threadsafe_span_data.h"
 #include "opentelemetry/nostd/span.h"
+#include "opentelemetry/sdk/trace/multi_span_processor.h"
 #include "opentelemetry/sdk/trace/tracer.h"
 
 using namespace opentelemetry::sdk::trace;
@@ -384,6 +385,64 @@ TEST_F(TracezProcessor, OneSpanNewOnly)
   EXPECT_EQ(completed.size(), 0);
 }
 
+/*
+ * Test if spans that start and end between two snapshots are only reported as
+ * completed, in the order they ended, and if running spans of a snapshot stay
+ * valid after they end until the next snapshot.
+ */
+TEST_F(TracezProcessor, CompletedBetweenSnapshots)
+{
+  auto running_span = tracer->StartSpan("running");
+  UpdateSpans(processor, completed, running, true);
+  ASSERT_EQ(running.size(), 1);
+  ThreadsafeSpanData *running_data = *running.begin();
+
+  auto first  = tracer->StartSpan("first");
+  auto second = tracer->StartSpan("second");
+  second->End();
+  first->End();
+  running_span->End();
+  EXPECT_EQ(running_data->GetName(), "running");
+
+  UpdateSpans(processor, completed, running, true);
+  EXPECT_EQ(running.size(), 0);
+  ASSERT_EQ(completed.size(), 3);
+  EXPECT_EQ(completed[0]->GetName(), "second");
+  EXPECT_EQ(completed[1]->GetName(), "first");
+  EXPECT_EQ(completed[2]->GetName(), "running");
+}
+
+/*
+ * Test if GetSpanChanges reports each started span once while it is running,
+ * and each completed span once.
+ */
+TEST_F(TracezProcessor, SpanChanges)
+{
+  auto first  = tracer->StartSpan("first");
+  auto second = tracer->StartSpan("second");
+  tracer->StartSpan("short")->End();
+
+  auto changes = processor->GetSpanChanges();
+  ASSERT_EQ(changes.started.size(), 2);
+  ASSERT_EQ(changes.completed.size(), 1);
+  EXPECT_EQ(changes.completed[0]->GetName(), "short");
+
+  changes = processor->GetSpanChanges();
+  EXPECT_EQ(changes.started.size(), 0);
+  EXPECT_EQ(changes.completed.size(), 0);
+
+  second->End();
+  changes = processor->GetSpanChanges();
+  EXPECT_EQ(changes.started.size(), 0);
+  ASSERT_EQ(changes.completed.size(), 1);
+  EXPECT_EQ(changes.completed[0]->GetName(), "second");
+
+  // Snapshots and changes share the running spans.
+  UpdateSpans(processor, completed, running, true);
+  EXPECT_TRUE(ContainsNames({"first"}, running, 0, 1, true));
+  EXPECT_EQ(completed.size(), 0);
+}
+
 /*
  * Test if multiple spans move from running to completed at expected times,
  * running/completed spans are split. Middle spans end first. Ensure correct
@@ -614,3 +673,32 @@ TEST_F(TracezProcessor, RunningSnapshotCompletedThreadSafety)
   snapshots.join();
   end.join();
 }
+
+/*
+ * Test that the processor tracks the spans it receives through a multi span
+ * processor, which it shares with another pipeline.
+ */
+TEST(TracezProcessorInMultiProcessor, TracksRunningAndCompletedSpans)
+{
+  auto tracez_processor = std::make_shared<TracezSpanProcessor>();
+  auto other_processor  = std::make_shared<TracezSpanProcessor>();
+  auto processor        = std::make_shared<MultiSpanProcessor>(
+      std::vector<std::shared_ptr<SpanProcessor>>{tracez_processor, other_processor});
+  std::shared_ptr<opentelemetry::trace::Tracer> tracer(new Tracer(processor));
+
+  auto span = tracer->StartSpan("span");
+  for (auto &p : {tracez_processor, other_processor})
+  {
+    auto snapshot = p->GetSpanSnapshot();
+    ASSERT_EQ(1, snapshot.running.size());
+    ASSERT_EQ("span", (*snapshot.running.begin())->GetName());
+  }
+
+  span->End();
+  for (auto &p : {tracez_processor, other_processor})
+  {
+    auto snapshot = p->GetSpanSnapshot();
+    ASSERT_EQ(0, snapshot.running.size());
+    ASSERT_EQ(1, snapshot.completed.size());
+  }
+}
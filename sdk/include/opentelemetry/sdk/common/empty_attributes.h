@@ -1,3 +1,5 @@
+#pragma once
+
 #include "opentelemetry/trace/key_value_iterable_view.h"
 
 #include <map>
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * The name and version of the library instrumented by a tracer, which tell
+ * where its spans come from.
+ */
+struct InstrumentationLibrary
+{
+  std::string name;
+  std::string version;
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * Appends a quoted JSON string, escaping quotes, backslashes and control
+ * characters. Other bytes, including UTF-8 sequences, are copied unchanged.
+ */
+inline void AppendJsonString(std::string &out, nostd::string_view value)
+{
+  static const char kHexDigits[] = "0123456789abcdef";
+  out.push_back('"');
+  for (char c : value)
+  {
+    switch (c)
+    {
+      case '"':
+        out.append("\\\"", 2);
+        break;
+      case '\\':
+        out.append("\\\\", 2);
+        break;
+      case '\n':
+        out.append("\\n", 2);
+        break;
+      case '\r':
+        out.append("\\r", 2);
+        break;
+      case '\t':
+        out.append("\\t", 2);
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char escaped[] = {'\\', 'u', '0', '0', kHexDigits[(c >> 4) & 0xf], kHexDigits[c & 0xf]};
+          out.append(escaped, sizeof(escaped));
+        }
+        else
+        {
+          out.push_back(c);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+/**
+ * Appends a floating point number as a JSON number that reads back to the
+ * same value. JSON has no representation for NaN and infinity; they are
+ * written as null.
+ */
+inline void AppendJsonDouble(std::string &out, double value)
+{
+  if (std::isnan(value) || std::isinf(value))
+  {
+    out.append("null", 4);
+    return;
+  }
+  char digits[32];
+  int size = snprintf(digits, sizeof(digits), "%.17g", value);
+  if (size > 0)
+  {
+    out.append(digits, static_cast<size_t>(size) < sizeof(digits) ? size : sizeof(digits) - 1);
+  }
+}
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -31,10 +31,10 @@ class Record
     aggregator_  = aggregator;
   }
 
-  std::string GetName() { return name_; }
-  std::string GetDescription() { return description_; }
-  std::string GetLabels() { return labels_; }
-  AggregatorVariant GetAggregator() { return aggregator_; }
+  const std::string &GetName() const { return name_; }
+  const std::string &GetDescription() const { return description_; }
+  const std::string &GetLabels() const { return labels_; }
+  const AggregatorVariant &GetAggregator() const { return aggregator_; }
 
 private:
   std::string name_;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/exporter.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+class SegmentLog;
+
+/**
+ * The disk spill exporter is a SpanExporter that sits between a span processor
+ * and another exporter, and keeps batches that the wrapped exporter fails to
+ * export instead of dropping them.
+ *
+ * Failed batches are serialized into an append-only log of memory-mapped,
+ * CRC-protected segment files in a local directory. Whenever the wrapped
+ * exporter succeeds again, spilled batches are replayed to it, oldest first.
+ * Spilled batches survive a restart of the process and are replayed by the
+ * next exporter that uses the same directory. The disk space used for spilled
+ * batches is bounded; when the bound is reached, the oldest segments are
+ * deleted.
+ *
+ * Spans are recorded into SpanData and copied into recordables of the wrapped
+ * exporter at export time, so only data that SpanData holds is forwarded.
+ *
+ * This exporter is only available on POSIX platforms.
+ */
+class DiskSpillExporter final : public SpanExporter
+{
+public:
+  /**
+   * @param exporter the exporter to forward spans to
+   * @param directory the directory to store spilled batches in. It is created
+   * if it does not exist. If it cannot be used, batches that fail to export are
+   * dropped.
+   * @param max_disk_usage the maximum number of bytes used by spill files
+   * @param segment_size the size of each spill file in bytes
+   * @param max_replay_batches the maximum number of spilled batches to replay
+   * during a single call to Export
+   */
+  DiskSpillExporter(std::unique_ptr<SpanExporter> &&exporter,
+                    const std::string &directory,
+                    const size_t max_disk_usage     = 64 * 1024 * 1024,
+                    const size_t segment_size       = 4 * 1024 * 1024,
+                    const size_t max_replay_batches = 16);
+
+  ~DiskSpillExporter() override;
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Exports a batch to the wrapped exporter. If that succeeds, spilled batches
+   * are replayed; otherwise the batch is spilled to disk.
+   * @return kSuccess if the batch was either exported or spilled.
+   */
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override;
+
+  /**
+   * Flushes spilled batches to disk and shuts down the wrapped exporter.
+   * Batches that have not been replayed yet remain on disk.
+   */
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the number of batches currently held on disk.
+   */
+  uint64_t GetSpilledBatchCount() const noexcept;
+
+  /**
+   * @return the number of batches that were lost, either because they could
+   * not be spilled or because their spill file was evicted or corrupted.
+   */
+  uint64_t GetDroppedBatchCount() const noexcept;
+
+private:
+  void Replay() noexcept;
+
+  void UpdateCounters() noexcept;
+
+  std::unique_ptr<SpanExporter> exporter_;
+  std::unique_ptr<SegmentLog> log_;
+  const size_t max_replay_batches_;
+
+  /* Reused buffer for encoding batches */
+  std::string buffer_;
+
+  /* Batches lost outside of the log, i.e. not spillable or not decodable */
+  uint64_t lost_batches_ = 0;
+
+  /* Snapshots of the counters that can be read from any thread */
+  std::atomic<uint64_t> spilled_batches_{0};
+  std::atomic<uint64_t> dropped_batches_{0};
+  bool is_shutdown_ = false;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
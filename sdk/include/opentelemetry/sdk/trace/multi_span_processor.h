@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "opentelemetry/sdk/trace/processor.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The multi span processor passes spans to several span processors, for
+ * instance to a BatchSpanProcessor exporting to a backend and to the zPages
+ * processor, with a single span and a single sampling decision.
+ *
+ * The span records into one composite recordable, which forwards every call
+ * to a recordable of each processor. The attributes of the span are thus
+ * visited once, and each processor receives the recordable it made, as it
+ * expects, in OnStart and OnEnd.
+ */
+class MultiSpanProcessor : public SpanProcessor
+{
+public:
+  /**
+   * @param processors the processors to pass the spans to, in order
+   */
+  explicit MultiSpanProcessor(std::vector<std::shared_ptr<SpanProcessor>> processors) noexcept;
+
+  /**
+   * @return a composite recordable, holding a recordable of each processor
+   */
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Passes the recordable of each processor to its OnStart.
+   */
+  void OnStart(Recordable &span) noexcept override;
+
+  /**
+   * Passes the recordable of each processor to its OnEnd.
+   */
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override;
+
+  /**
+   * Calls ForceFlush on every processor, each with the given timeout.
+   */
+  void ForceFlush(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * Calls Shutdown on every processor, each with the given timeout.
+   */
+  void Shutdown(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+private:
+  const std::vector<std::shared_ptr<SpanProcessor>> processors_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "opentelemetry/common/attribute_key.h"
 #include "opentelemetry/common/attribute_value.h"
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/string_view.h"
 #include "opentelemetry/sdk/common/empty_attributes.h"
+#include "opentelemetry/sdk/common/instrumentation_library.h"
 #include "opentelemetry/trace/canonical_code.h"
 #include "opentelemetry/trace/key_value_iterable.h"
 #include "opentelemetry/trace/span_context.h"
@@ -12,6 +14,7 @@
 #include "opentelemetry/version.h"
 
 #include <map>
+#include <memory>
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
@@ -47,6 +50,20 @@ class Recordable
   virtual void SetAttribute(nostd::string_view key,
                             const opentelemetry::common::AttributeValue &value) noexcept = 0;
 
+  /**
+   * Set an attribute of a span through a key, which may be stored by the id
+   * the SDK gave the key. Set by name by default.
+   * @param key the key of the attribute, which outlives the recordable
+   * @param key_id the id of the key, the same for all keys of the same name
+   * @param value the attribute value
+   */
+  virtual void SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                            uint32_t /*key_id*/,
+                            const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    SetAttribute(key.name(), value);
+  }
+
   /**
    * Add an event to a span.
    * @param name the name of the event
@@ -119,6 +136,27 @@ class Recordable
    * @param duration the duration to set
    */
   virtual void SetDuration(std::chrono::nanoseconds duration) noexcept = 0;
+
+  /**
+   * Set the library whose tracer started the span. The library is immutable
+   * and shared by the spans of the tracer, so a recordable may keep the
+   * pointer. Ignored by default.
+   * @param instrumentation_library the instrumentation library to set
+   */
+  virtual void SetInstrumentationLibrary(
+      const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+          & /*instrumentation_library*/) noexcept
+  {}
+
+  /**
+   * Set the number of attributes and events the span dropped to stay within
+   * its limits. Only called when some were dropped. Ignored by default.
+   * @param dropped_attributes the number of dropped attributes
+   * @param dropped_events the number of dropped events
+   */
+  virtual void SetDroppedCounts(uint32_t /*dropped_attributes*/,
+                                uint32_t /*dropped_events*/) noexcept
+  {}
 };
 }  // namespace trace
 }  // namespace sdk
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "opentelemetry/sdk/trace/samplers/probability.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace trace_api = opentelemetry::trace;
+/**
+ * The adaptive sampler adjusts the probability of a ProbabilitySampler so that
+ * about a given number of spans per second are recorded, whatever the rate at
+ * which spans are started.
+ *
+ * The sampler counts the spans it is asked about. Once per adjustment
+ * interval, the thread making a decision estimates the rate of spans from the
+ * count and stores the probability that records the target rate. When a
+ * burst makes the count exceed twice the budget of the interval, the
+ * adjustment happens early. As children follow the decision of their parent,
+ * spans are counted whether they are root spans or not.
+ *
+ * Decisions never lock: counting is an atomic increment, the clock is only
+ * read for one in 16 spans, and the probability is changed by an atomic
+ * store.
+ */
+class AdaptiveSampler : public Sampler
+{
+public:
+  /**
+   * @param spans_per_second the target rate of recorded spans
+   * @param adjustment_interval how often the probability is adjusted
+   * @param min_probability the probability never goes below this value, so
+   * that rare spans are still sampled during peaks
+   */
+  explicit AdaptiveSampler(
+      double spans_per_second,
+      std::chrono::steady_clock::duration adjustment_interval = std::chrono::seconds(1),
+      double min_probability                                  = 0.0);
+
+  /**
+   * @return Returns the decision of the ProbabilitySampler with the current
+   * probability
+   */
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  /**
+   * @return Description MUST be AdaptiveSampler{100.000000}
+   */
+  nostd::string_view GetDescription() const noexcept override;
+
+  /**
+   * @return the probability currently used for sampling decisions
+   */
+  double GetProbability() const noexcept;
+
+private:
+  /**
+   * Called by one thread once the adjustment interval has elapsed; computes
+   * and stores the probability for the next interval.
+   */
+  void Adjust(int64_t elapsed_nanos) noexcept;
+
+  /**
+   * @return the span count after which an interval sampled with the given
+   * probability has recorded twice its budget
+   */
+  uint64_t EarlyAdjustmentCount(double probability) const noexcept;
+
+  std::string description_;
+  const double spans_per_second_;
+  const int64_t interval_nanos_;
+  const double min_probability_;
+  ProbabilitySampler probability_sampler_;
+
+  // Spans since the last adjustment
+  std::atomic<uint64_t> span_count_{0};
+  // When the next adjustment is due, in nanoseconds of the steady clock
+  std::atomic<int64_t> next_adjustment_;
+  // The span count at which the adjustment happens before the interval ends
+  std::atomic<uint64_t> early_adjustment_count_;
+  std::atomic<double> probability_{1.0};
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "opentelemetry/sdk/trace/sampler.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -40,9 +42,17 @@ class ProbabilitySampler : public Sampler
    */
   nostd::string_view GetDescription() const noexcept override;
 
+  /**
+   * Changes the probability while the sampler is in use, without blocking
+   * concurrent sampling decisions. The description keeps showing the
+   * probability the sampler was constructed with.
+   * @param probability the new probability, clamped to [0.0, 1.0]
+   */
+  void SetProbability(double probability) noexcept;
+
 private:
   std::string description_;
-  const uint64_t threshold_;
+  std::atomic<uint64_t> threshold_;
 };
 }  // namespace trace
 }  // namespace sdk
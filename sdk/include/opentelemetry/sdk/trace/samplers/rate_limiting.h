@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "opentelemetry/sdk/trace/sampler.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace trace_api = opentelemetry::trace;
+/**
+ * The rate limiting sampler samples at most a given number of spans per
+ * second, whatever the rate at which spans are started. Up to one second worth
+ * of samples can be taken in a burst.
+ *
+ * Every call to ShouldSample counts, so to limit the number of traces rather
+ * than spans, wrap it in a ParentOrElseSampler: only root spans then consume
+ * the rate, and their children follow their decision.
+ *
+ * The sampler is a token bucket refilled from the steady clock. Its state is a
+ * single atomic, so concurrent calls never block each other.
+ */
+class RateLimitingSampler : public Sampler
+{
+public:
+  /**
+   * @param max_per_second the number of spans sampled per second; negative
+   * values are treated as 0
+   */
+  explicit RateLimitingSampler(double max_per_second);
+
+  /**
+   * @return Returns RECORD_AND_SAMPLE if the rate allows for another sample,
+   * and NOT_RECORD otherwise
+   */
+  SamplingResult ShouldSample(const trace_api::SpanContext * /*parent_context*/,
+                              trace_api::TraceId /*trace_id*/,
+                              nostd::string_view /*name*/,
+                              trace_api::SpanKind /*span_kind*/,
+                              const trace_api::KeyValueIterable & /*attributes*/) noexcept override;
+
+  /**
+   * @return Description MUST be RateLimitingSampler{100.000000}
+   */
+  nostd::string_view GetDescription() const noexcept override;
+
+private:
+  std::string description_;
+  // Nanoseconds it takes to earn a sample, 0 if there's no limit
+  int64_t interval_;
+  // Nanoseconds worth of samples the bucket holds, -1 if nothing is sampled
+  int64_t capacity_;
+  // The time at which the bucket is empty, in nanoseconds of the steady clock.
+  // Taking a sample moves it forward by one interval, but never further than
+  // the capacity ahead of now.
+  std::atomic<int64_t> empty_at_{INT64_MIN / 2};
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
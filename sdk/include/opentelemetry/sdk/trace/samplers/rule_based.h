@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace trace_api = opentelemetry::trace;
+
+/**
+ * A rule of the RuleBasedSampler: spans matching all of its predicates are
+ * sampled by its sampler.
+ */
+struct SamplingRule
+{
+  /**
+   * The name of the spans to match. A name ending with '*' matches the names
+   * starting with the rest of it, so that "*" matches every span.
+   */
+  std::string name = "*";
+  /** The kinds of the spans to match, or empty to match every kind. */
+  std::vector<trace_api::SpanKind> span_kinds;
+  /**
+   * Attributes the spans must be started with, with equal values. Integers
+   * compare equal whether they are signed or not. Array values never match.
+   */
+  std::vector<std::pair<std::string, SpanDataAttributeValue>> attributes;
+  /** The sampler deciding for the matching spans; must not be null. */
+  std::shared_ptr<Sampler> sampler;
+};
+
+/**
+ * The rule based sampler is a composite sampler. It delegates the decision to
+ * the sampler of the first rule matching the span, or to a default sampler if
+ * no rule matches. For instance, health checks can be sampled with an
+ * AlwaysOffSampler and "/checkout" with an AlwaysOnSampler.
+ *
+ * The name patterns of the rules are compiled into a path compressed trie at
+ * construction, so finding the rules for a span takes a walk along its name,
+ * whatever the number of rules. Only the rules found there have their span
+ * kinds and attributes checked.
+ */
+class RuleBasedSampler : public Sampler
+{
+public:
+  /**
+   * @param rules the rules, in order of precedence
+   * @param default_sampler the sampler deciding for spans matching no rule
+   */
+  RuleBasedSampler(std::vector<SamplingRule> rules, std::shared_ptr<Sampler> default_sampler);
+
+  /**
+   * @return Returns the decision of the sampler of the first matching rule,
+   * or of the default sampler
+   */
+  SamplingResult ShouldSample(const trace_api::SpanContext *parent_context,
+                              trace_api::TraceId trace_id,
+                              nostd::string_view name,
+                              trace_api::SpanKind span_kind,
+                              const trace_api::KeyValueIterable &attributes) noexcept override;
+
+  /**
+   * @return Description MUST be RuleBasedSampler{rules=N,default=<default description>}
+   */
+  nostd::string_view GetDescription() const noexcept override;
+
+private:
+  struct TrieNode
+  {
+    // The range of edges_ leading to the children, sorted by character
+    uint32_t edges_begin = 0;
+    uint32_t edges_end   = 0;
+    // The ranges of rule_indices_ of the rules whose name is the path to this
+    // node, followed by '*' for the prefix rules
+    uint32_t prefix_rules_begin = 0;
+    uint32_t prefix_rules_end   = 0;
+    uint32_t exact_rules_begin  = 0;
+    uint32_t exact_rules_end    = 0;
+  };
+
+  struct TrieEdge
+  {
+    char character;
+    // The range of labels_ holding the characters following the first one,
+    // where a chain of nodes without rules was merged into the edge
+    uint32_t label_begin;
+    uint32_t label_end;
+    uint32_t node;
+  };
+
+  // The attributes of a span, collected once for all the rules checking them
+  class SpanAttributes;
+
+  /**
+   * @return whether the span kind and attributes of a span match the rule
+   */
+  bool Matches(const SamplingRule &rule,
+               trace_api::SpanKind span_kind,
+               SpanAttributes &attributes) const noexcept;
+
+  /**
+   * Lowers best_rule to the first rule of the range matching the span, if
+   * any is before it.
+   */
+  void FindFirstMatch(uint32_t rules_begin,
+                      uint32_t rules_end,
+                      trace_api::SpanKind span_kind,
+                      SpanAttributes &attributes,
+                      uint32_t &best_rule) const noexcept;
+
+  std::vector<SamplingRule> rules_;
+  const std::shared_ptr<Sampler> default_sampler_;
+  std::string description_;
+
+  // The trie of name patterns, its root being the first node
+  std::vector<TrieNode> nodes_;
+  std::vector<TrieEdge> edges_;
+  std::string labels_;
+  // The rules of the nodes, each range in increasing order
+  std::vector<uint32_t> rule_indices_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "opentelemetry/common/attribute_value.h"
@@ -172,6 +174,16 @@ class SpanData final : public Recordable
    */
   const std::unordered_map<std::string, SpanDataAttributeValue> &GetAttributes() const noexcept
   {
+    // Attributes set through keys are only named once they are read
+    std::lock_guard<std::mutex> lock(merge_mutex_.mutex);
+    for (auto &keyed_attribute : keyed_attributes_)
+    {
+      if (keyed_attribute.key != nullptr)
+      {
+        attributes_[std::string(keyed_attribute.key->name())] = std::move(keyed_attribute.value);
+        keyed_attribute.key = nullptr;
+      }
+    }
     return attributes_;
   }
 
@@ -181,6 +193,28 @@ class SpanData final : public Recordable
    */
   const std::vector<SpanDataEvent> &GetEvents() const noexcept { return events_; }
 
+  /**
+   * Get the library whose tracer started this span
+   * @return the instrumentation library of this span, or nullptr if it wasn't set
+   */
+  const opentelemetry::sdk::common::InstrumentationLibrary *GetInstrumentationLibrary()
+      const noexcept
+  {
+    return instrumentation_library_.get();
+  }
+
+  /**
+   * Get the number of attributes the span dropped to stay within its limits
+   * @return the number of dropped attributes
+   */
+  uint32_t GetDroppedAttributesCount() const noexcept { return dropped_attributes_; }
+
+  /**
+   * Get the number of events the span dropped to stay within its limits
+   * @return the number of dropped events
+   */
+  uint32_t GetDroppedEventsCount() const noexcept { return dropped_events_; }
+
   void SetIds(opentelemetry::trace::TraceId trace_id,
               opentelemetry::trace::SpanId span_id,
               opentelemetry::trace::SpanId parent_span_id) noexcept override
@@ -193,9 +227,40 @@ class SpanData final : public Recordable
   void SetAttribute(nostd::string_view key,
                     const opentelemetry::common::AttributeValue &value) noexcept override
   {
+    // A keyed attribute of the same name set before is replaced
+    for (auto &keyed_attribute : keyed_attributes_)
+    {
+      if (keyed_attribute.key != nullptr && keyed_attribute.key->name() == key)
+      {
+        keyed_attribute.key = nullptr;
+      }
+    }
     attributes_[std::string(key)] = nostd::visit(converter_, value);
   }
 
+  void SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                    uint32_t key_id,
+                    const opentelemetry::common::AttributeValue &value) noexcept override
+  {
+    if (key_id >= kMaxKeyedAttributes)
+    {
+      SetAttribute(key.name(), value);
+      return;
+    }
+    if (keyed_slots_[key_id] == 0)
+    {
+      if (keyed_attributes_.empty())
+      {
+        keyed_attributes_.reserve(kKeyedAttributesReserved);
+      }
+      keyed_attributes_.emplace_back();
+      keyed_slots_[key_id] = static_cast<uint8_t>(keyed_attributes_.size());
+    }
+    KeyedAttribute &keyed_attribute = keyed_attributes_[keyed_slots_[key_id] - 1];
+    keyed_attribute.key             = &key;
+    keyed_attribute.value           = nostd::visit(converter_, value);
+  }
+
   void AddEvent(nostd::string_view name,
                 core::SystemTimestamp timestamp,
                 const trace_api::KeyValueIterable &attributes) noexcept override
@@ -226,7 +291,44 @@ class SpanData final : public Recordable
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override { duration_ = duration; }
 
+  void SetInstrumentationLibrary(
+      const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+          &instrumentation_library) noexcept override
+  {
+    instrumentation_library_ = instrumentation_library;
+  }
+
+  void SetDroppedCounts(uint32_t dropped_attributes, uint32_t dropped_events) noexcept override
+  {
+    dropped_attributes_ = dropped_attributes;
+    dropped_events_     = dropped_events;
+  }
+
 private:
+  /**
+   * An attribute set through a key, that isn't in attributes_ yet. The key is
+   * nullptr once the attribute was moved there or set by name.
+   */
+  struct KeyedAttribute
+  {
+    const opentelemetry::common::AttributeKeyBase *key = nullptr;
+    SpanDataAttributeValue value;
+  };
+
+  /* A mutex that copies of a span don't share */
+  struct MergeMutex
+  {
+    MergeMutex() = default;
+    MergeMutex(const MergeMutex &) {}
+    MergeMutex &operator=(const MergeMutex &) { return *this; }
+
+    std::mutex mutex;
+  };
+
+  /* Keys with larger ids are set by name, which bounds the slots of a span */
+  static const uint32_t kMaxKeyedAttributes = 64;
+  static const size_t kKeyedAttributesReserved = 8;
+
   opentelemetry::trace::TraceId trace_id_;
   opentelemetry::trace::SpanId span_id_;
   opentelemetry::trace::SpanId parent_span_id_;
@@ -235,8 +337,19 @@ class SpanData final : public Recordable
   std::string name_;
   opentelemetry::trace::CanonicalCode status_code_{opentelemetry::trace::CanonicalCode::OK};
   std::string status_desc_;
-  std::unordered_map<std::string, SpanDataAttributeValue> attributes_;
+  mutable std::unordered_map<std::string, SpanDataAttributeValue> attributes_;
+  // The attributes set through keys, in the order their keys were first used
+  mutable std::vector<KeyedAttribute> keyed_attributes_;
+  // One plus the index in keyed_attributes_ of the attribute of each key id,
+  // or 0 if the key wasn't used yet
+  uint8_t keyed_slots_[kMaxKeyedAttributes] = {};
+  // Serializes the readers moving keyed attributes into attributes_
+  mutable MergeMutex merge_mutex_;
   std::vector<SpanDataEvent> events_;
+  std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+      instrumentation_library_;
+  uint32_t dropped_attributes_{0};
+  uint32_t dropped_events_{0};
   AttributeConverter converter_;
 };
 }  // namespace trace
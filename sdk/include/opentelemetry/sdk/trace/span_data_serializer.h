@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/trace/recordable.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * Converts SpanData to and from a compact, flat binary representation.
+ *
+ * The encoding is intended for short-lived local storage (spill files, capture
+ * files, shared memory) written and read by the same build of the SDK. Integers
+ * are stored in host byte order and there is no schema evolution beyond the
+ * leading format version byte.
+ *
+ * Layout of an encoded span:
+ *   u8   format version
+ *   u8[16] trace id, u8[8] span id, u8[8] parent span id
+ *   i64  start time (ns since epoch), i64 duration (ns)
+ *   u32  status code, str description, str name
+ *   u32  attribute count, then per attribute: str key, u8 type, value
+ *   u32  event count, then per event: str name, i64 timestamp (ns since epoch)
+ *
+ * where str is a u32 length followed by the bytes.
+ */
+class SpanDataSerializer
+{
+public:
+  /**
+   * Appends the encoded form of a span to a buffer.
+   * @param span the span to encode
+   * @param buffer the buffer to append to
+   */
+  static void Serialize(const SpanData &span, std::string &buffer);
+
+  /**
+   * Decodes a span and replays it into a recordable.
+   * @param data a buffer that holds exactly one encoded span
+   * @param recordable the recordable to populate
+   * @return true if the span was decoded; false if the buffer is malformed, in
+   * which case the recordable may have been partially populated.
+   */
+  static bool Deserialize(nostd::string_view data, Recordable &recordable) noexcept;
+
+  /**
+   * Replays the contents of a span into a recordable without going through the
+   * binary encoding.
+   * @param span the span to copy from
+   * @param recordable the recordable to populate
+   */
+  static void CopyTo(const SpanData &span, Recordable &recordable) noexcept;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The limits bounding the size of a span, enforced by the span before the
+ * data reaches the recordable. What exceeds a count limit is dropped, and the
+ * number of dropped attributes and events is passed to the recordable when
+ * the span ends. Values exceeding a length limit are truncated.
+ */
+struct SpanLimits
+{
+  /** The maximum number of distinct attribute keys of a span */
+  uint32_t max_attributes = 128;
+  /** The maximum number of events of a span */
+  uint32_t max_events = 128;
+  /** The maximum number of attributes of an event */
+  uint32_t max_attributes_per_event = 128;
+  /**
+   * The maximum length of string values, in bytes. Strings are truncated at a
+   * UTF-8 character boundary, so they may end up a few bytes shorter.
+   */
+  size_t max_attribute_value_length = std::numeric_limits<size_t>::max();
+  /** The maximum number of elements of array values */
+  size_t max_attribute_array_length = std::numeric_limits<size_t>::max();
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "opentelemetry/sdk/trace/exporter.h"
+#include "opentelemetry/sdk/trace/processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The policies of a TailSamplingProcessor. A trace is kept when any of its
+ * spans matches any of the policies.
+ */
+struct TailSamplingPolicy
+{
+  /** Keeps the traces with a span lasting at least this long, unless zero */
+  std::chrono::nanoseconds latency_threshold{0};
+  /** Keeps the traces with a span whose status isn't OK */
+  bool keep_errors = true;
+  /**
+   * Keeps the traces with a span having one of these attributes, with an
+   * equal value. Integers compare equal whether they are signed or not.
+   */
+  std::vector<std::pair<std::string, SpanDataAttributeValue>> attributes;
+};
+
+/**
+ * This is an implementation of the SpanProcessor which buffers ended spans
+ * grouped by trace, and only passes the traces matching its policies to the
+ * configured SpanExporter. It keeps the slow or failed traces that a sampler,
+ * deciding when spans start, can't tell apart.
+ *
+ * A trace is decided once a window of decision_wait has passed since its
+ * first span ended, so the window should cover the duration of the traces.
+ * The decisions of the max_decided_traces most recently decided traces are
+ * remembered: spans ending after their trace was decided follow its decision,
+ * and are exported right away if it was kept. Spans of traces whose decision
+ * was forgotten open a new window.
+ *
+ * The policies are evaluated as spans are recorded, so a buffered span only
+ * costs its recordable. At most max_buffered_spans spans are buffered: when a
+ * span would exceed the limit, the oldest traces are decided early with the
+ * spans they have so far.
+ */
+class TailSamplingProcessor : public SpanProcessor
+{
+public:
+  /**
+   * Counters of the processor, for monitoring its memory and decisions.
+   */
+  struct Stats
+  {
+    size_t buffered_spans;
+    size_t buffered_traces;
+    uint64_t kept_traces;
+    uint64_t dropped_traces;
+    // Traces decided before their window closed, to bound memory
+    uint64_t evicted_traces;
+    // Spans that ended after their trace was decided
+    uint64_t late_spans;
+  };
+
+  /**
+   * @param exporter - The backend exporter to pass the kept traces to
+   * @param policy - The policies deciding which traces are kept
+   * @param decision_wait - The time between the end of the first span of a
+   * trace and its decision
+   * @param max_buffered_spans - The maximum number of spans waiting for the
+   * decision of their trace
+   * @param max_decided_traces - The number of recent decisions remembered for
+   * the spans ending late
+   */
+  explicit TailSamplingProcessor(
+      std::unique_ptr<SpanExporter> &&exporter,
+      TailSamplingPolicy policy,
+      const std::chrono::milliseconds decision_wait = std::chrono::milliseconds(5000),
+      const size_t max_buffered_spans               = 100000,
+      const size_t max_decided_traces               = 10000);
+
+  /**
+   * Requests a Recordable(Span) from the configured exporter, wrapped to
+   * evaluate the policies as the span is recorded.
+   *
+   * @return A recordable generated by the backend exporter
+   */
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Called when a span is started.
+   *
+   * NOTE: This method is a no-op.
+   *
+   * @param span - The span that just started
+   */
+  void OnStart(Recordable &span) noexcept override;
+
+  /**
+   * Called when a span ends. Buffers the span with the other spans of its
+   * trace, or applies the decision of its trace if it was already made.
+   * Recordables that weren't made by this processor are ignored.
+   *
+   * @param span - A recordable for a span that just ended
+   */
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override;
+
+  /**
+   * Decides all the buffered traces without waiting for their window to
+   * close, and exports the kept ones.
+   *
+   * NOTE: Timeout functionality not supported yet.
+   */
+  void ForceFlush(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * Decides all the buffered traces, exports the kept ones, and shuts the
+   * exporter down. Any subsequent calls to OnStart, OnEnd, ForceFlush or
+   * Shutdown will return immediately without doing anything.
+   *
+   * NOTE: Timeout functionality not supported yet.
+   */
+  void Shutdown(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the current counters of the processor
+   */
+  Stats GetStats() const noexcept;
+
+  /**
+   * Class destructor which invokes the Shutdown() method.
+   */
+  ~TailSamplingProcessor();
+
+private:
+  struct TraceIdHash
+  {
+    size_t operator()(const opentelemetry::trace::TraceId &trace_id) const noexcept;
+  };
+
+  struct BufferedTrace
+  {
+    std::vector<std::unique_ptr<Recordable>> spans;
+    bool keep = false;
+  };
+
+  struct DecisionWindow
+  {
+    opentelemetry::trace::TraceId trace_id;
+    std::chrono::steady_clock::time_point closes_at;
+  };
+
+  struct Decision
+  {
+    opentelemetry::trace::TraceId trace_id;
+    bool keep;
+  };
+
+  /**
+   * The background routine deciding the traces as their windows close.
+   */
+  void DoBackgroundWork();
+
+  /**
+   * Removes the oldest trace from the buffer and appends its spans to
+   * kept_spans if it is kept. Must be called with mutex_ held and a trace
+   * buffered.
+   */
+  void DecideOldestTrace(std::vector<std::unique_ptr<Recordable>> &kept_spans) noexcept;
+
+  /**
+   * Remembers the decision of a trace, forgetting the least recently used one
+   * when max_decided_traces are remembered. Must be called with mutex_ held.
+   */
+  void RememberDecision(const opentelemetry::trace::TraceId &trace_id, bool keep) noexcept;
+
+  /**
+   * Returns the remembered decision of a trace and marks it as recently used,
+   * or nullptr if there is none. Must be called with mutex_ held.
+   */
+  const Decision *FindDecision(const opentelemetry::trace::TraceId &trace_id) noexcept;
+
+  /**
+   * Passes the kept spans to the exporter, one caller at a time.
+   */
+  void Export(std::vector<std::unique_ptr<Recordable>> &kept_spans) noexcept;
+
+  /* The configured backend exporter */
+  std::unique_ptr<SpanExporter> exporter_;
+  std::mutex export_mutex_;
+
+  const TailSamplingPolicy policy_;
+  const std::chrono::milliseconds decision_wait_;
+  const size_t max_buffered_spans_;
+  const size_t max_decided_traces_;
+
+  /* The buffered traces, and their windows in the order they were opened */
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unordered_map<opentelemetry::trace::TraceId, BufferedTrace, TraceIdHash> traces_;
+  std::deque<DecisionWindow> windows_;
+  size_t buffered_spans_   = 0;
+  uint64_t kept_traces_    = 0;
+  uint64_t dropped_traces_ = 0;
+  uint64_t evicted_traces_ = 0;
+  uint64_t late_spans_     = 0;
+
+  /* The recent decisions, the most recently used first */
+  std::list<Decision> decisions_;
+  std::unordered_map<opentelemetry::trace::TraceId, std::list<Decision>::iterator, TraceIdHash>
+      decisions_by_trace_;
+
+  std::atomic<bool> is_shutdown_{false};
+
+  /* The background worker thread */
+  std::thread worker_thread_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
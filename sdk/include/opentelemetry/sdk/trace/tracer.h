@@ -1,13 +1,16 @@
 #pragma once
 
-#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/sdk/common/instrumentation_library.h"
 #include "opentelemetry/sdk/trace/processor.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/span_limits.h"
 #include "opentelemetry/trace/noop.h"
 #include "opentelemetry/trace/tracer.h"
 #include "opentelemetry/version.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
@@ -21,17 +24,33 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    * Initialize a new tracer.
    * @param processor The span processor for this tracer. This must not be a
    * nullptr.
+   * @param sampler The sampler for this tracer.
+   * @param instrumentation_library The library whose spans this tracer starts.
+   * @param span_limits The limits bounding the size of the spans.
    */
   explicit Tracer(std::shared_ptr<SpanProcessor> processor,
-                  std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>()) noexcept;
+                  std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+                  opentelemetry::sdk::common::InstrumentationLibrary instrumentation_library = {},
+                  SpanLimits span_limits = {}) noexcept;
+
+  ~Tracer();
 
   /**
-   * Set the span processor associated with this tracer.
+   * Set the span processor associated with this tracer. Spans started
+   * afterwards use the new processor, while started spans keep theirs.
    * @param processor The new span processor for this tracer. This must not be
    * a nullptr.
    */
   void SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept;
 
+  /**
+   * Set the sampler associated with this tracer. Spans started afterwards are
+   * sampled by the new sampler.
+   * @param sampler The new sampler for this tracer. This must not be a
+   * nullptr.
+   */
+  void SetSampler(std::shared_ptr<Sampler> sampler) noexcept;
+
   /**
    * Obtain the span processor associated with this tracer.
    * @return The span processor for this tracer.
@@ -44,6 +63,22 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    */
   std::shared_ptr<Sampler> GetSampler() const noexcept;
 
+  /**
+   * Obtain the library whose spans this tracer starts.
+   * @return The instrumentation library of this tracer, shared with its spans.
+   */
+  const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+      &GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_;
+  }
+
+  /**
+   * Obtain the limits bounding the size of the spans of this tracer.
+   * @return The span limits of this tracer.
+   */
+  const SpanLimits &GetSpanLimits() const noexcept { return span_limits_; }
+
   nostd::unique_ptr<trace_api::Span> StartSpan(
       nostd::string_view name,
       const trace_api::KeyValueIterable &attributes,
@@ -54,8 +89,30 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
   void CloseWithMicroseconds(uint64_t timeout) noexcept override;
 
 private:
-  opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
-  const std::shared_ptr<Sampler> sampler_;
+  /**
+   * The processor and sampler of the tracer. A config is never modified:
+   * setting the processor or the sampler publishes a new one, and the old one
+   * is deleted once the last span starting with it no longer reads it, or
+   * when the tracer is destroyed.
+   */
+  struct Config
+  {
+    std::shared_ptr<SpanProcessor> processor;
+    std::shared_ptr<Sampler> sampler;
+  };
+
+  /**
+   * Publish a new config. Must be called with config_mutex_ held.
+   */
+  void PublishConfig(const Config *config) noexcept;
+
+  /* Read by StartSpan with a plain load, under an epoch guard */
+  std::atomic<const Config *> config_;
+  /* Serializes the writers of the config */
+  std::mutex config_mutex_;
+  const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+      instrumentation_library_;
+  const SpanLimits span_limits_;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -1,10 +1,13 @@
 #pragma once
 
-#include <map>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
 #include "opentelemetry/sdk/trace/processor.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/sdk/trace/tracer.h"
@@ -24,17 +27,29 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    * not be a nullptr.
    * @param sampler The sampler for this tracer provider. This must
    * not be a nullptr.
+   * @param span_limits The limits bounding the size of the spans of all the
+   * tracers.
    */
   explicit TracerProvider(
       std::shared_ptr<SpanProcessor> processor,
-      std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>()) noexcept;
+      std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+      SpanLimits span_limits           = {}) noexcept;
 
+  /**
+   * Obtain the tracer of an instrumentation library, created on the first
+   * call for the library. Further calls for the same name and version return
+   * the same tracer, and only read an immutable snapshot of the tracers,
+   * without locking, so they are cheap enough to be made on every request.
+   * @param library_name The name of the instrumentation library
+   * @param library_version The version of the instrumentation library
+   */
   opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> GetTracer(
       nostd::string_view library_name,
       nostd::string_view library_version = "") noexcept override;
 
   /**
-   * Set the span processor associated with this tracer provider.
+   * Set the span processor associated with this tracer provider, and with all
+   * its tracers.
    * @param processor The new span processor for this tracer provider. This
    * must not be a nullptr.
    */
@@ -46,6 +61,14 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    */
   std::shared_ptr<SpanProcessor> GetProcessor() const noexcept;
 
+  /**
+   * Set the sampler associated with this tracer provider, and with all its
+   * tracers.
+   * @param sampler The new sampler for this tracer provider. This must not be
+   * a nullptr.
+   */
+  void SetSampler(std::shared_ptr<Sampler> sampler) noexcept;
+
   /**
    * Obtain the sampler associated with this tracer provider.
    * @return The span processor for this tracer provider.
@@ -53,9 +76,23 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
   std::shared_ptr<Sampler> GetSampler() const noexcept;
 
 private:
+  /* The tracers, sorted by library name and version */
+  using TracerMap = std::vector<std::shared_ptr<Tracer>>;
+
   opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
-  std::shared_ptr<opentelemetry::trace::Tracer> tracer_;
-  const std::shared_ptr<Sampler> sampler_;
+  opentelemetry::sdk::AtomicSharedPtr<Sampler> sampler_;
+  const SpanLimits span_limits_;
+
+  /*
+   * The current snapshot of the tracers. A new tracer is added to a copy of
+   * the snapshot, which is then published. Readers may still walk a replaced
+   * snapshot, so all of them are kept until the provider is destroyed: there
+   * are only a few instrumentation libraries, and they are registered early.
+   */
+  std::atomic<const TracerMap *> tracers_;
+  std::vector<std::unique_ptr<const TracerMap>> snapshots_;
+  /* Serializes the writers of the snapshots, the processor and the sampler */
+  std::mutex mutex_;
 };
 }  // namespace trace
 }  // namespace sdk
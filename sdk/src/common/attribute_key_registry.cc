@@ -0,0 +1,85 @@
+#include "src/common/attribute_key_registry.h"
+
+#include <new>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+constexpr uint32_t AttributeKeyRegistry::kInvalidId;
+
+AttributeKeyRegistry *AttributeKeyRegistry::GetInstance() noexcept
+#if __EXCEPTIONS
+    try
+#endif
+{
+  // Leaked, so that keys with static storage duration never point to a
+  // destroyed registry
+  static AttributeKeyRegistry *instance = new AttributeKeyRegistry;
+  return instance;
+}
+#if __EXCEPTIONS
+catch (const std::bad_alloc &)
+{
+  // Created the next time it is needed
+  return nullptr;
+}
+#endif
+
+uint32_t AttributeKeyRegistry::GetId(const opentelemetry::common::AttributeKeyBase &key) noexcept
+{
+  auto binding = static_cast<const Binding *>(key.sdk_data().load(std::memory_order_acquire));
+  if (binding == nullptr)
+  {
+    binding = Bind(key);
+  }
+  return binding != nullptr && binding->registry == this ? binding->id : kInvalidId;
+}
+
+const AttributeKeyRegistry::Binding *AttributeKeyRegistry::Bind(
+    const opentelemetry::common::AttributeKeyBase &key) noexcept
+{
+  const Binding *binding = Insert(key.name());
+  if (binding == nullptr)
+  {
+    return nullptr;
+  }
+  const void *expected = nullptr;
+  if (!key.sdk_data().compare_exchange_strong(expected, binding, std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+  {
+    // Another thread or registry was first
+    binding = static_cast<const Binding *>(expected);
+  }
+  return binding;
+}
+
+const AttributeKeyRegistry::Binding *AttributeKeyRegistry::Insert(nostd::string_view name) noexcept
+#if __EXCEPTIONS
+    try
+#endif
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key(name);
+  auto found = ids_.find(key);
+  if (found != ids_.end())
+  {
+    return &bindings_[found->second];
+  }
+  auto id = static_cast<uint32_t>(bindings_.size());
+  bindings_.push_back(Binding{this, id});
+  // If this throws, the binding is never used and only its id is lost
+  ids_.emplace(std::move(key), id);
+  return &bindings_.back();
+}
+#if __EXCEPTIONS
+catch (const std::bad_alloc &)
+{
+  // The key is given an id the next time it is used
+  return nullptr;
+}
+#endif
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
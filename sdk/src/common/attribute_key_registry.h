@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "opentelemetry/common/attribute_key.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * Gives attribute keys small ids, so that attributes set through a key can
+ * be recorded in a slot instead of a map. Keys with the same name get the
+ * same id.
+ *
+ * A key caches the id of the first registry that sees it. Another registry,
+ * such as the one of another copy of the SDK loaded in the process, doesn't
+ * give that key an id, and attributes set through it are recorded by name.
+ */
+class AttributeKeyRegistry
+{
+public:
+  static constexpr uint32_t kInvalidId = UINT32_MAX;
+
+  AttributeKeyRegistry() = default;
+
+  AttributeKeyRegistry(const AttributeKeyRegistry &) = delete;
+  AttributeKeyRegistry &operator=(const AttributeKeyRegistry &) = delete;
+
+  /**
+   * @return the registry of this SDK, which is never destroyed, or nullptr if
+   * it couldn't be created
+   */
+  static AttributeKeyRegistry *GetInstance() noexcept;
+
+  /**
+   * Gives the key an id, unless it has one already. Only takes a lock the
+   * first time a key is seen. Keys given an id must not outlive the registry.
+   * @param key the key
+   * @return the id of the key, or kInvalidId if another registry gave the key
+   * its id or the key couldn't be given one
+   */
+  uint32_t GetId(const opentelemetry::common::AttributeKeyBase &key) noexcept;
+
+private:
+  /* What a key caches of the registry that gave it its id */
+  struct Binding
+  {
+    const AttributeKeyRegistry *registry;
+    uint32_t id;
+  };
+
+  const Binding *Bind(const opentelemetry::common::AttributeKeyBase &key) noexcept;
+
+  /* Returns the binding of the name, or nullptr if out of memory */
+  const Binding *Insert(nostd::string_view name) noexcept;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  // Indexed by id; a deque, so that the bindings keys point to don't move
+  std::deque<Binding> bindings_;
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,43 @@
+#include "src/common/crc32.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+namespace
+{
+struct Crc32Table
+{
+  uint32_t entries[256];
+
+  Crc32Table() noexcept
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit)
+      {
+        value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+      }
+      entries[i] = value;
+    }
+  }
+};
+}  // namespace
+
+uint32_t Crc32(const void *data, size_t size, uint32_t crc) noexcept
+{
+  static const Crc32Table table;
+
+  auto bytes = static_cast<const uint8_t *>(data);
+  crc        = ~crc;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc = table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * Computes the CRC-32 (IEEE 802.3 polynomial) of a buffer.
+ *
+ * @param data pointer to the first byte to checksum
+ * @param size the number of bytes to checksum
+ * @param crc a previously returned checksum to continue from, or 0 to start a
+ * new one
+ * @return the checksum of the buffer
+ */
+uint32_t Crc32(const void *data, size_t size, uint32_t crc = 0) noexcept;
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,223 @@
+#include "src/common/epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+namespace
+{
+/* The epoch of a thread that holds no guard */
+const uint64_t kQuiescent = UINT64_MAX;
+
+/**
+ * The slot where a thread announces the epoch it entered its guard in. Slots
+ * are never freed: the slot of an exited thread is reused by a new thread.
+ */
+struct ThreadSlot
+{
+  std::atomic<uint64_t> epoch{kQuiescent};
+  std::atomic<bool> in_use{true};
+  ThreadSlot *next = nullptr;
+  // Only accessed by the thread owning the slot
+  unsigned nesting = 0;
+  // Keeps the slots of different threads on different cache lines
+  char padding[64];
+};
+
+struct RetiredObject
+{
+  uint64_t epoch;
+  void *object;
+  void (*deleter)(void *);
+};
+
+struct RetiredObjects
+{
+  std::mutex mutex;
+  std::vector<RetiredObject> objects;
+};
+
+std::atomic<uint64_t> global_epoch{0};
+std::atomic<ThreadSlot *> slots{nullptr};
+/* The number of retired objects, read by guards to know if they must reclaim */
+std::atomic<size_t> retired_count{0};
+
+void ReclaimRetired() noexcept;
+
+/**
+ * Deletes the objects still retired when the program exits, that no guard
+ * uses anymore.
+ */
+struct ExitReclaimer
+{
+  ~ExitReclaimer() { ReclaimRetired(); }
+};
+
+RetiredObjects &GetRetiredObjects() noexcept
+{
+  // Never destroyed, as objects may be retired during static destruction
+  static RetiredObjects *retired_objects = new RetiredObjects;
+  static ExitReclaimer exit_reclaimer;
+  return *retired_objects;
+}
+
+/**
+ * Removes the retired objects that no guard may use anymore. Must be called
+ * with the mutex of the retired objects held.
+ */
+std::vector<RetiredObject> TakeReclaimable(RetiredObjects &retired) noexcept
+{
+  // Pairs with the fence in Guard::~Guard: either the guard sees the retired
+  // objects and reclaims them, or it is seen left here
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  uint64_t oldest_epoch = kQuiescent;
+  for (auto slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+  {
+    oldest_epoch = std::min(oldest_epoch, slot->epoch.load(std::memory_order_acquire));
+  }
+  auto it = std::partition(
+      retired.objects.begin(), retired.objects.end(),
+      [&](const RetiredObject &retired_object) { return retired_object.epoch >= oldest_epoch; });
+  std::vector<RetiredObject> reclaimed(it, retired.objects.end());
+  retired.objects.erase(it, retired.objects.end());
+  retired_count.store(retired.objects.size(), std::memory_order_relaxed);
+  return reclaimed;
+}
+
+void DeleteReclaimed(const std::vector<RetiredObject> &reclaimed) noexcept
+{
+  // Deleters may release other objects, so they run without the lock
+  for (auto &retired_object : reclaimed)
+  {
+    retired_object.deleter(retired_object.object);
+  }
+}
+
+void ReclaimRetired() noexcept
+{
+  std::vector<RetiredObject> reclaimed;
+  {
+    auto &retired = GetRetiredObjects();
+    std::lock_guard<std::mutex> guard(retired.mutex);
+    reclaimed = TakeReclaimable(retired);
+  }
+  DeleteReclaimed(reclaimed);
+}
+
+ThreadSlot *AcquireSlot() noexcept
+{
+  for (auto slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+  {
+    bool in_use = false;
+    if (slot->in_use.load(std::memory_order_relaxed) == false &&
+        slot->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+    {
+      return slot;
+    }
+  }
+
+  auto slot  = new ThreadSlot;
+  slot->next = slots.load(std::memory_order_relaxed);
+  while (!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                      std::memory_order_relaxed))
+  {
+  }
+  return slot;
+}
+
+/**
+ * Gives the slot of a thread back when the thread exits.
+ */
+struct ThreadSlotOwner
+{
+  ThreadSlot *slot = AcquireSlot();
+
+  ~ThreadSlotOwner() { slot->in_use.store(false, std::memory_order_release); }
+};
+
+ThreadSlot *GetThreadSlot() noexcept
+{
+  static thread_local ThreadSlotOwner owner;
+  return owner.slot;
+}
+}  // namespace
+
+Epoch::Guard::Guard() noexcept : slot_(GetThreadSlot())
+{
+  auto slot = static_cast<ThreadSlot *>(slot_);
+  if (slot->nesting++ == 0)
+  {
+    slot->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // Pairs with the fence in Retire: either the epoch is seen by the writer,
+    // or the objects unlinked before are seen unlinked by this reader
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+Epoch::Guard::~Guard()
+{
+  auto slot = static_cast<ThreadSlot *>(slot_);
+  if (--slot->nesting == 0)
+  {
+    slot->epoch.store(kQuiescent, std::memory_order_release);
+    // Pairs with the fence in TakeReclaimable, so that objects retired while
+    // this guard was held aren't left waiting for another writer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (retired_count.load(std::memory_order_relaxed) != 0)
+    {
+      ReclaimRetired();
+    }
+  }
+}
+
+void Epoch::Retire(void *object, void (*deleter)(void *)) noexcept
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  std::vector<RetiredObject> reclaimed;
+  {
+    auto &retired = GetRetiredObjects();
+    std::lock_guard<std::mutex> guard(retired.mutex);
+    // Readers entering their guard from now on can't reach the object, so it
+    // is deleted once the readers of older epochs have left
+    retired.objects.push_back({global_epoch.fetch_add(1), object, deleter});
+    retired_count.store(retired.objects.size(), std::memory_order_relaxed);
+    reclaimed = TakeReclaimable(retired);
+  }
+  DeleteReclaimed(reclaimed);
+}
+
+void Epoch::Synchronize() noexcept
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // Guards entered from now on have a later epoch
+  uint64_t epoch = global_epoch.fetch_add(1);
+  auto own_slot  = GetThreadSlot();
+  for (auto slot = slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next)
+  {
+    while (slot != own_slot && slot->epoch.load(std::memory_order_acquire) <= epoch)
+    {
+      std::this_thread::yield();
+    }
+  }
+  ReclaimRetired();
+}
+
+size_t Epoch::GetRetiredCount() noexcept
+{
+  auto &retired = GetRetiredObjects();
+  std::lock_guard<std::mutex> guard(retired.mutex);
+  return retired.objects.size();
+}
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
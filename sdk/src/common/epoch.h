@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * Epoch based reclamation, for objects that are replaced by writers while
+ * readers use them without taking a lock or a reference.
+ *
+ * Readers hold an Epoch::Guard while they use such an object. Entering the
+ * guard only writes the current epoch to a slot of the calling thread, so
+ * readers on different threads don't contend. Writers unlink an object, so
+ * that new readers can't reach it anymore, then retire it. A retired object
+ * is deleted once every guard entered before it was retired has been left,
+ * by the thread leaving the last of these guards.
+ *
+ * Guards may be nested, also across different objects.
+ */
+class Epoch
+{
+public:
+  class Guard
+  {
+  public:
+    Guard() noexcept;
+    ~Guard();
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+  private:
+    void *slot_;
+  };
+
+  /**
+   * Deletes an object once no reader can use it anymore, which is right away
+   * unless a guard is held. Must be called after the object was unlinked.
+   * @param object the object to delete
+   */
+  template <class T>
+  static void Retire(const T *object) noexcept
+  {
+    Retire(const_cast<T *>(object), [](void *retired) { delete static_cast<T *>(retired); });
+  }
+
+  /**
+   * Waits until the guards other threads hold have been left, and deletes the
+   * retired objects no guard of the calling thread may still use. Must not be
+   * called while holding a lock that a thread holding a guard may wait for.
+   */
+  static void Synchronize() noexcept;
+
+  /**
+   * @return the number of retired objects waiting to be deleted
+   */
+  static size_t GetRetiredCount() noexcept;
+
+private:
+  static void Retire(void *object, void (*deleter)(void *)) noexcept;
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace detail
+{
+inline bool EqualsSigned(const SpanDataAttributeValue &expected, int64_t value) noexcept
+{
+  if (auto expected_value = nostd::get_if<int64_t>(&expected))
+    return *expected_value == value;
+  auto expected_value = nostd::get_if<uint64_t>(&expected);
+  return expected_value != nullptr && value >= 0 && *expected_value == static_cast<uint64_t>(value);
+}
+
+inline bool EqualsUnsigned(const SpanDataAttributeValue &expected, uint64_t value) noexcept
+{
+  if (auto expected_value = nostd::get_if<uint64_t>(&expected))
+    return *expected_value == value;
+  auto expected_value = nostd::get_if<int64_t>(&expected);
+  return expected_value != nullptr && *expected_value >= 0 &&
+         static_cast<uint64_t>(*expected_value) == value;
+}
+}  // namespace detail
+
+/**
+ * Compares the value of an attribute set on a span to a configured value.
+ * Integers compare equal whether they are signed or not, and arrays never
+ * match. The alternatives are tested one by one, which is cheaper than a
+ * visitor.
+ */
+inline bool AttributeEquals(const SpanDataAttributeValue &expected,
+                            const opentelemetry::common::AttributeValue &value) noexcept
+{
+  if (auto string_value = nostd::get_if<nostd::string_view>(&value))
+  {
+    auto expected_value = nostd::get_if<std::string>(&expected);
+    return expected_value != nullptr && nostd::string_view(*expected_value) == *string_value;
+  }
+  if (auto int_value = nostd::get_if<int>(&value))
+    return detail::EqualsSigned(expected, *int_value);
+  if (auto int64_value = nostd::get_if<int64_t>(&value))
+    return detail::EqualsSigned(expected, *int64_value);
+  if (auto uint_value = nostd::get_if<unsigned int>(&value))
+    return detail::EqualsUnsigned(expected, *uint_value);
+  if (auto uint64_value = nostd::get_if<uint64_t>(&value))
+    return detail::EqualsUnsigned(expected, *uint64_value);
+  if (auto bool_value = nostd::get_if<bool>(&value))
+  {
+    auto expected_value = nostd::get_if<bool>(&expected);
+    return expected_value != nullptr && *expected_value == *bool_value;
+  }
+  if (auto double_value = nostd::get_if<double>(&value))
+  {
+    auto expected_value = nostd::get_if<double>(&expected);
+    return expected_value != nullptr && *expected_value == *double_value;
+  }
+  return false;
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
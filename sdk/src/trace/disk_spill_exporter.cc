@@ -0,0 +1,220 @@
+#include "opentelemetry/sdk/trace/disk_spill_exporter.h"
+
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+#include "src/trace/segment_log.h"
+
+#include <cstring>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/**
+ * Encodes a batch of SpanData as a span count followed by length-prefixed
+ * encoded spans.
+ */
+void EncodeBatch(const nostd::span<std::unique_ptr<Recordable>> &spans, std::string &buffer)
+{
+  buffer.clear();
+  uint32_t count = static_cast<uint32_t>(spans.size());
+  buffer.append(reinterpret_cast<const char *>(&count), sizeof(count));
+  for (auto &recordable : spans)
+  {
+    size_t size_offset = buffer.size();
+    buffer.append(sizeof(uint32_t), '\0');
+    SpanDataSerializer::Serialize(*static_cast<const SpanData *>(recordable.get()), buffer);
+    uint32_t size = static_cast<uint32_t>(buffer.size() - size_offset - sizeof(uint32_t));
+    memcpy(&buffer[size_offset], &size, sizeof(size));
+  }
+}
+
+/**
+ * Decodes a batch produced by EncodeBatch into recordables of an exporter.
+ */
+bool DecodeBatch(nostd::string_view data,
+                 SpanExporter &exporter,
+                 std::vector<std::unique_ptr<Recordable>> &recordables) noexcept
+{
+  uint32_t count;
+  if (data.size() < sizeof(count))
+  {
+    return false;
+  }
+  memcpy(&count, data.data(), sizeof(count));
+  data = data.substr(sizeof(count));
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t size;
+    if (data.size() < sizeof(size))
+    {
+      return false;
+    }
+    memcpy(&size, data.data(), sizeof(size));
+    data = data.substr(sizeof(size));
+    if (data.size() < size)
+    {
+      return false;
+    }
+    auto recordable = exporter.MakeRecordable();
+    if (recordable == nullptr ||
+        !SpanDataSerializer::Deserialize(data.substr(0, size), *recordable))
+    {
+      return false;
+    }
+    recordables.push_back(std::move(recordable));
+    data = data.substr(size);
+  }
+  return data.empty();
+}
+}  // namespace
+
+DiskSpillExporter::DiskSpillExporter(std::unique_ptr<SpanExporter> &&exporter,
+                                     const std::string &directory,
+                                     const size_t max_disk_usage,
+                                     const size_t segment_size,
+                                     const size_t max_replay_batches)
+    : exporter_(std::move(exporter)),
+      log_(new SegmentLog(directory, segment_size, max_disk_usage)),
+      max_replay_batches_(max_replay_batches)
+{
+  if (!log_->Open())
+  {
+    log_.reset();
+    return;
+  }
+  UpdateCounters();
+}
+
+DiskSpillExporter::~DiskSpillExporter() = default;
+
+std::unique_ptr<Recordable> DiskSpillExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<Recordable>(new SpanData);
+}
+
+ExportResult DiskSpillExporter::Export(
+    const nostd::span<std::unique_ptr<Recordable>> &spans) noexcept
+{
+  if (is_shutdown_)
+  {
+    return ExportResult::kFailure;
+  }
+
+  if (spans.size() == 0)
+  {
+    // Nothing new to export, e.g. on a forced flush; just catch up on the
+    // backlog.
+    Replay();
+    return ExportResult::kSuccess;
+  }
+
+  std::vector<std::unique_ptr<Recordable>> forwarded;
+  forwarded.reserve(spans.size());
+  for (auto &recordable : spans)
+  {
+    auto forward = exporter_->MakeRecordable();
+    if (forward == nullptr)
+    {
+      continue;
+    }
+    SpanDataSerializer::CopyTo(*static_cast<const SpanData *>(recordable.get()), *forward);
+    forwarded.push_back(std::move(forward));
+  }
+
+  if (exporter_->Export(nostd::span<std::unique_ptr<Recordable>>(forwarded.data(),
+                                                                 forwarded.size())) ==
+      ExportResult::kSuccess)
+  {
+    Replay();
+    return ExportResult::kSuccess;
+  }
+
+  if (log_ == nullptr)
+  {
+    ++lost_batches_;
+    UpdateCounters();
+    return ExportResult::kFailure;
+  }
+
+  EncodeBatch(spans, buffer_);
+  bool spilled = log_->Append(buffer_);
+  if (!spilled)
+  {
+    ++lost_batches_;
+  }
+  UpdateCounters();
+  return spilled ? ExportResult::kSuccess : ExportResult::kFailure;
+}
+
+void DiskSpillExporter::Replay() noexcept
+{
+  if (log_ == nullptr)
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < max_replay_batches_; ++i)
+  {
+    nostd::string_view record;
+    if (!log_->Front(record))
+    {
+      break;
+    }
+
+    std::vector<std::unique_ptr<Recordable>> recordables;
+    if (DecodeBatch(record, *exporter_, recordables))
+    {
+      if (exporter_->Export(nostd::span<std::unique_ptr<Recordable>>(
+              recordables.data(), recordables.size())) != ExportResult::kSuccess)
+      {
+        // The wrapped exporter failed again; keep the batch for a later attempt.
+        break;
+      }
+    }
+    else
+    {
+      ++lost_batches_;
+    }
+    log_->PopFront();
+  }
+  UpdateCounters();
+}
+
+void DiskSpillExporter::UpdateCounters() noexcept
+{
+  if (log_ == nullptr)
+  {
+    dropped_batches_ = lost_batches_;
+    return;
+  }
+  spilled_batches_ = log_->record_count();
+  dropped_batches_ = lost_batches_ + log_->dropped_record_count();
+}
+
+void DiskSpillExporter::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  is_shutdown_ = true;
+  if (log_ != nullptr)
+  {
+    log_->Sync();
+  }
+  exporter_->Shutdown(timeout);
+}
+
+uint64_t DiskSpillExporter::GetSpilledBatchCount() const noexcept
+{
+  return spilled_batches_.load();
+}
+
+uint64_t DiskSpillExporter::GetDroppedBatchCount() const noexcept
+{
+  return dropped_batches_.load();
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
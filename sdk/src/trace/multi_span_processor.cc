@@ -0,0 +1,195 @@
+#include "opentelemetry/sdk/trace/multi_span_processor.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/**
+ * Forwards every call to the recordables of the processors. A processor may
+ * return a null recordable, which is skipped.
+ */
+class MultiRecordable final : public Recordable
+{
+public:
+  explicit MultiRecordable(size_t size) : recordables_(size) {}
+
+  std::unique_ptr<Recordable> &operator[](size_t index) noexcept { return recordables_[index]; }
+
+  void SetIds(opentelemetry::trace::TraceId trace_id,
+              opentelemetry::trace::SpanId span_id,
+              opentelemetry::trace::SpanId parent_span_id) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetIds(trace_id, span_id, parent_span_id);
+    }
+  }
+
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &value) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetAttribute(key, value);
+    }
+  }
+
+  void SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                    uint32_t key_id,
+                    const opentelemetry::common::AttributeValue &value) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetAttribute(key, key_id, value);
+    }
+  }
+
+  void AddEvent(nostd::string_view name,
+                core::SystemTimestamp timestamp,
+                const trace_api::KeyValueIterable &attributes) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->AddEvent(name, timestamp, attributes);
+    }
+  }
+
+  void AddLink(opentelemetry::trace::SpanContext span_context,
+               const trace_api::KeyValueIterable &attributes) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->AddLink(span_context, attributes);
+    }
+  }
+
+  void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetStatus(code, description);
+    }
+  }
+
+  void SetName(nostd::string_view name) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetName(name);
+    }
+  }
+
+  void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetStartTime(start_time);
+    }
+  }
+
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetDuration(duration);
+    }
+  }
+
+  void SetInstrumentationLibrary(
+      const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+          &instrumentation_library) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetInstrumentationLibrary(instrumentation_library);
+    }
+  }
+
+  void SetDroppedCounts(uint32_t dropped_attributes, uint32_t dropped_events) noexcept override
+  {
+    for (auto &recordable : recordables_)
+    {
+      if (recordable != nullptr)
+        recordable->SetDroppedCounts(dropped_attributes, dropped_events);
+    }
+  }
+
+private:
+  std::vector<std::unique_ptr<Recordable>> recordables_;
+};
+}  // namespace
+
+MultiSpanProcessor::MultiSpanProcessor(
+    std::vector<std::shared_ptr<SpanProcessor>> processors) noexcept
+    : processors_(std::move(processors))
+{}
+
+std::unique_ptr<Recordable> MultiSpanProcessor::MakeRecordable() noexcept
+{
+  std::unique_ptr<MultiRecordable> recordable(new MultiRecordable(processors_.size()));
+  for (size_t i = 0; i < processors_.size(); ++i)
+  {
+    (*recordable)[i] = processors_[i]->MakeRecordable();
+  }
+  return std::unique_ptr<Recordable>(recordable.release());
+}
+
+void MultiSpanProcessor::OnStart(Recordable &span) noexcept
+{
+  auto &recordable = static_cast<MultiRecordable &>(span);
+  for (size_t i = 0; i < processors_.size(); ++i)
+  {
+    if (recordable[i] != nullptr)
+    {
+      processors_[i]->OnStart(*recordable[i]);
+    }
+  }
+}
+
+void MultiSpanProcessor::OnEnd(std::unique_ptr<Recordable> &&span) noexcept
+{
+  if (span == nullptr)
+  {
+    return;
+  }
+  auto &recordable = static_cast<MultiRecordable &>(*span);
+  for (size_t i = 0; i < processors_.size(); ++i)
+  {
+    if (recordable[i] != nullptr)
+    {
+      processors_[i]->OnEnd(std::move(recordable[i]));
+    }
+  }
+}
+
+void MultiSpanProcessor::ForceFlush(std::chrono::microseconds timeout) noexcept
+{
+  for (auto &processor : processors_)
+  {
+    processor->ForceFlush(timeout);
+  }
+}
+
+void MultiSpanProcessor::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  for (auto &processor : processors_)
+  {
+    processor->Shutdown(timeout);
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
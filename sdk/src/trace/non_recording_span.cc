@@ -0,0 +1,101 @@
+#include "src/trace/non_recording_span.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/*
+ * Memory for spans freed on this thread. A span allocated on one thread may be
+ * freed on another, in which case its memory moves to the pool of that thread.
+ *
+ * The pool is kept in trivially destructible thread locals, so that it can be
+ * used safely by destructors of other thread locals while the thread exits.
+ */
+struct FreeBlock
+{
+  FreeBlock *next;
+};
+
+// Bounds the memory kept by a thread that frees more spans than it starts
+constexpr size_t kMaxPoolSize = 256;
+
+thread_local FreeBlock *pool_head = nullptr;
+thread_local size_t pool_size     = 0;
+// Set once the pool was released, spans freed afterwards bypass it
+thread_local bool pool_released = false;
+
+/**
+ * Releases the pool of a thread when the thread exits.
+ */
+struct SpanPoolReleaser
+{
+  ~SpanPoolReleaser()
+  {
+    pool_released = true;
+    while (pool_head != nullptr)
+    {
+      FreeBlock *next = pool_head->next;
+      ::operator delete(pool_head);
+      pool_head = next;
+    }
+    pool_size = 0;
+  }
+};
+
+void *TakeFromPool() noexcept
+{
+  FreeBlock *block = pool_head;
+  if (block == nullptr)
+  {
+    return nullptr;
+  }
+  pool_head = block->next;
+  --pool_size;
+  return block;
+}
+
+bool GiveToPool(void *ptr) noexcept
+{
+  if (pool_released || pool_size == kMaxPoolSize)
+  {
+    return false;
+  }
+  if (pool_head == nullptr)
+  {
+    // Makes sure the pool is released when the thread exits
+    static thread_local SpanPoolReleaser releaser;
+    (void)releaser;
+  }
+  FreeBlock *block = static_cast<FreeBlock *>(ptr);
+  block->next      = pool_head;
+  pool_head        = block;
+  ++pool_size;
+  return true;
+}
+}  // namespace
+
+void *NonRecordingSpan::operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  void *ptr = TakeFromPool();
+  return (ptr != nullptr) ? ptr : ::operator new(size, std::nothrow);
+}
+
+void *NonRecordingSpan::operator new(std::size_t size)
+{
+  void *ptr = TakeFromPool();
+  return (ptr != nullptr) ? ptr : ::operator new(size);
+}
+
+void NonRecordingSpan::operator delete(void *ptr) noexcept
+{
+  if (ptr != nullptr && !GiveToPool(ptr))
+  {
+    ::operator delete(ptr);
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
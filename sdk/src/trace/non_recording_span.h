@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "opentelemetry/trace/span.h"
+#include "opentelemetry/trace/tracer.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace trace_api = opentelemetry::trace;
+
+/**
+ * A span that the sampler decided not to record. It only carries its context
+ * to the spans started while it is active.
+ *
+ * Starting and ending these spans is meant to cost next to nothing: their
+ * memory is recycled through a per-thread pool. Like recorded spans, they keep
+ * their tracer alive.
+ */
+class NonRecordingSpan final : public trace_api::Span
+{
+public:
+  NonRecordingSpan(std::shared_ptr<trace_api::Tracer> tracer,
+                   const trace_api::SpanContext &span_context) noexcept
+      : tracer_(std::move(tracer)), span_context_(span_context)
+  {}
+
+  void SetAttribute(nostd::string_view /*key*/,
+                    const opentelemetry::common::AttributeValue & /*value*/) noexcept override
+  {}
+
+  void AddEvent(nostd::string_view /*name*/) noexcept override {}
+
+  void AddEvent(nostd::string_view /*name*/, core::SystemTimestamp /*timestamp*/) noexcept override
+  {}
+
+  void AddEvent(nostd::string_view /*name*/,
+                core::SystemTimestamp /*timestamp*/,
+                const trace_api::KeyValueIterable & /*attributes*/) noexcept override
+  {}
+
+  void SetStatus(trace_api::CanonicalCode /*code*/,
+                 nostd::string_view /*description*/) noexcept override
+  {}
+
+  void UpdateName(nostd::string_view /*name*/) noexcept override {}
+
+  void End(const trace_api::EndSpanOptions & /*options*/) noexcept override {}
+
+  bool IsRecording() const noexcept override { return false; }
+
+  trace_api::SpanContext GetContext() const noexcept override { return span_context_; }
+
+  trace_api::Tracer &tracer() const noexcept override { return *tracer_; }
+
+  /**
+   * Takes the memory for a span from the pool of the current thread, and
+   * allocates it only if the pool is empty.
+   */
+  static void *operator new(std::size_t size, const std::nothrow_t &) noexcept;
+
+  static void *operator new(std::size_t size);
+
+  /**
+   * Returns the memory of a span to the pool of the current thread.
+   */
+  static void operator delete(void *ptr) noexcept;
+
+private:
+  std::shared_ptr<trace_api::Tracer> tracer_;
+  const trace_api::SpanContext span_context_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,100 @@
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trace_api = opentelemetry::trace;
+
+namespace
+{
+// The clock is read for one in this many spans, to find out whether an
+// adjustment is due
+constexpr uint64_t kClockCheckPeriod = 16;
+
+int64_t NowNanos() noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+AdaptiveSampler::AdaptiveSampler(double spans_per_second,
+                                 std::chrono::steady_clock::duration adjustment_interval,
+                                 double min_probability)
+    : spans_per_second_(spans_per_second > 0.0 ? spans_per_second : 0.0),
+      interval_nanos_(std::max<int64_t>(
+          1,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(adjustment_interval).count())),
+      min_probability_(std::min(std::max(min_probability, 0.0), 1.0)),
+      probability_sampler_(1.0),
+      next_adjustment_(NowNanos() + interval_nanos_),
+      early_adjustment_count_(EarlyAdjustmentCount(1.0))
+{
+  description_ = "AdaptiveSampler{" + std::to_string(spans_per_second_) + "}";
+}
+
+SamplingResult AdaptiveSampler::ShouldSample(const trace_api::SpanContext *parent_context,
+                                             trace_api::TraceId trace_id,
+                                             nostd::string_view name,
+                                             trace_api::SpanKind span_kind,
+                                             const trace_api::KeyValueIterable &attributes) noexcept
+{
+  uint64_t count = span_count_.fetch_add(1, std::memory_order_relaxed);
+  if (count % kClockCheckPeriod == 0)
+  {
+    int64_t now = NowNanos();
+    int64_t due = next_adjustment_.load(std::memory_order_relaxed);
+    bool early  = count >= early_adjustment_count_.load(std::memory_order_relaxed);
+    // Only the thread that moves the next adjustment forward adjusts
+    if ((now >= due || early) &&
+        next_adjustment_.compare_exchange_strong(due, now + interval_nanos_,
+                                                 std::memory_order_relaxed))
+    {
+      Adjust(now - due + interval_nanos_);
+    }
+  }
+  return probability_sampler_.ShouldSample(parent_context, trace_id, name, span_kind, attributes);
+}
+
+void AdaptiveSampler::Adjust(int64_t elapsed_nanos) noexcept
+{
+  uint64_t count = span_count_.exchange(0, std::memory_order_relaxed);
+  double rate    = static_cast<double>(count) * 1e9 / static_cast<double>(elapsed_nanos);
+
+  double probability = (rate > spans_per_second_) ? spans_per_second_ / rate : 1.0;
+  probability        = std::max(probability, min_probability_);
+  probability_.store(probability, std::memory_order_relaxed);
+  probability_sampler_.SetProbability(probability);
+  early_adjustment_count_.store(EarlyAdjustmentCount(probability), std::memory_order_relaxed);
+}
+
+uint64_t AdaptiveSampler::EarlyAdjustmentCount(double probability) const noexcept
+{
+  // Twice the spans to record in an interval, so that noise doesn't trigger it
+  double budget = 2 * spans_per_second_ * static_cast<double>(interval_nanos_) / 1e9;
+  double count  = (probability > 0.0) ? budget / probability : HUGE_VAL;
+  if (!(count < static_cast<double>(UINT64_MAX / 2)))
+  {
+    return UINT64_MAX;
+  }
+  return std::max(kClockCheckPeriod, static_cast<uint64_t>(count));
+}
+
+nostd::string_view AdaptiveSampler::GetDescription() const noexcept
+{
+  return description_;
+}
+
+double AdaptiveSampler::GetProbability() const noexcept
+{
+  return probability_.load(std::memory_order_relaxed);
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -102,10 +102,11 @@ SamplingResult ProbabilitySampler::ShouldSample(
     }
   }
 
-  if (threshold_ == 0)
+  uint64_t threshold = threshold_.load(std::memory_order_relaxed);
+  if (threshold == 0)
     return {Decision::NOT_RECORD, nullptr};
 
-  if (CalculateThresholdFromBuffer(trace_id) <= threshold_)
+  if (CalculateThresholdFromBuffer(trace_id) <= threshold)
   {
     return {Decision::RECORD_AND_SAMPLE, nullptr};
   }
@@ -117,6 +118,11 @@ nostd::string_view ProbabilitySampler::GetDescription() const noexcept
 {
   return description_;
 }
+
+void ProbabilitySampler::SetProbability(double probability) noexcept
+{
+  threshold_.store(CalculateThreshold(probability), std::memory_order_relaxed);
+}
 }  // namespace trace
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
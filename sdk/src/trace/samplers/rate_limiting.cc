@@ -0,0 +1,76 @@
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace trace_api = opentelemetry::trace;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+RateLimitingSampler::RateLimitingSampler(double max_per_second)
+{
+  if (!(max_per_second > 0.0))
+    max_per_second = 0.0;
+  description_ = "RateLimitingSampler{" + std::to_string(max_per_second) + "}";
+
+  constexpr double kNanosPerSecond = 1e9;
+  if (max_per_second == 0.0)
+  {
+    interval_ = 0;
+    capacity_ = -1;
+  }
+  else if (max_per_second >= kNanosPerSecond)
+  {
+    interval_ = 0;
+    capacity_ = 0;
+  }
+  else
+  {
+    interval_ = static_cast<int64_t>(std::llround(kNanosPerSecond / max_per_second));
+    // The burst is a second worth of samples, but at least one sample
+    capacity_ = std::max(interval_, static_cast<int64_t>(kNanosPerSecond));
+  }
+}
+
+SamplingResult RateLimitingSampler::ShouldSample(
+    const trace_api::SpanContext * /*parent_context*/,
+    trace_api::TraceId /*trace_id*/,
+    nostd::string_view /*name*/,
+    trace_api::SpanKind /*span_kind*/,
+    const trace_api::KeyValueIterable & /*attributes*/) noexcept
+{
+  if (capacity_ < 0)
+    return {Decision::NOT_RECORD, nullptr};
+  if (interval_ == 0)
+    return {Decision::RECORD_AND_SAMPLE, nullptr};
+
+  int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+  int64_t empty_at = empty_at_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    // An empty bucket refills while it isn't used, up to its capacity
+    int64_t next_empty_at = std::max(empty_at, now - capacity_) + interval_;
+    if (next_empty_at > now)
+    {
+      return {Decision::NOT_RECORD, nullptr};
+    }
+    if (empty_at_.compare_exchange_weak(empty_at, next_empty_at, std::memory_order_relaxed))
+    {
+      return {Decision::RECORD_AND_SAMPLE, nullptr};
+    }
+  }
+}
+
+nostd::string_view RateLimitingSampler::GetDescription() const noexcept
+{
+  return description_;
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,278 @@
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
+#include "src/trace/attribute_equals.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <new>
+#include <type_traits>
+
+namespace trace_api = opentelemetry::trace;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * The attributes are collected, as views, on the first rule checking them, so
+ * that further rules don't go through the virtual iteration again. Spans with
+ * more attributes than the buffer holds are iterated for every rule.
+ */
+class RuleBasedSampler::SpanAttributes
+{
+public:
+  explicit SpanAttributes(const trace_api::KeyValueIterable &attributes) noexcept
+      : attributes_(attributes)
+  {}
+
+  /**
+   * Calls the callback for every attribute, until it returns false.
+   */
+  template <class Callback>
+  void ForEachKeyValue(Callback callback) noexcept
+  {
+    if (!collected_)
+    {
+      Collect();
+    }
+    if (overflow_)
+    {
+      attributes_.ForEachKeyValue(callback);
+      return;
+    }
+    for (size_t i = 0; i < size_; ++i)
+    {
+      const Entry &entry = *reinterpret_cast<const Entry *>(&entries_[i]);
+      if (!callback(entry.key, entry.value))
+      {
+        return;
+      }
+    }
+  }
+
+private:
+  struct Entry
+  {
+    nostd::string_view key;
+    opentelemetry::common::AttributeValue value;
+  };
+
+  void Collect() noexcept
+  {
+    collected_ = true;
+    overflow_  = !attributes_.ForEachKeyValue(
+        [this](nostd::string_view key, opentelemetry::common::AttributeValue value) noexcept {
+          if (size_ == kMaxSize)
+          {
+            return false;
+          }
+          new (&entries_[size_++]) Entry{key, value};
+          return true;
+        });
+  }
+
+  static constexpr size_t kMaxSize = 16;
+
+  const trace_api::KeyValueIterable &attributes_;
+  bool collected_ = false;
+  bool overflow_  = false;
+  size_t size_    = 0;
+  // Left uninitialized until collected, as most spans match no attribute rule
+  typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type entries_[kMaxSize];
+};
+
+RuleBasedSampler::RuleBasedSampler(std::vector<SamplingRule> rules,
+                                   std::shared_ptr<Sampler> default_sampler)
+    : rules_(std::move(rules)), default_sampler_(std::move(default_sampler))
+{
+  description_ = "RuleBasedSampler{rules=" + std::to_string(rules_.size()) +
+                 ",default=" + std::string{default_sampler_->GetDescription()} + "}";
+
+  // Build the trie with maps, then flatten it so that a lookup only walks
+  // contiguous arrays
+  struct BuildNode
+  {
+    std::map<char, uint32_t> children;
+    std::vector<uint32_t> prefix_rules;
+    std::vector<uint32_t> exact_rules;
+  };
+  std::vector<BuildNode> build_nodes(1);
+  for (uint32_t i = 0; i < rules_.size(); ++i)
+  {
+    nostd::string_view pattern = rules_[i].name;
+    bool is_prefix             = !pattern.empty() && pattern[pattern.size() - 1] == '*';
+    if (is_prefix)
+    {
+      pattern = pattern.substr(0, pattern.size() - 1);
+    }
+
+    uint32_t node = 0;
+    for (char c : pattern)
+    {
+      auto it = build_nodes[node].children.find(c);
+      if (it == build_nodes[node].children.end())
+      {
+        uint32_t child = static_cast<uint32_t>(build_nodes.size());
+        build_nodes[node].children.emplace(c, child);
+        build_nodes.emplace_back();
+        node = child;
+      }
+      else
+      {
+        node = it->second;
+      }
+    }
+    auto &node_rules = is_prefix ? build_nodes[node].prefix_rules : build_nodes[node].exact_rules;
+    node_rules.push_back(i);
+  }
+
+  std::deque<std::pair<uint32_t, uint32_t>> pending{{0, 0}};
+  nodes_.emplace_back();
+  while (!pending.empty())
+  {
+    const BuildNode &build_node = build_nodes[pending.front().first];
+    uint32_t index              = pending.front().second;
+    pending.pop_front();
+
+    TrieNode node;
+    node.edges_begin = static_cast<uint32_t>(edges_.size());
+    for (auto &child : build_node.children)
+    {
+      // Chains of nodes with a single child and no rules are merged into the
+      // edge leading to them
+      uint32_t label_begin = static_cast<uint32_t>(labels_.size());
+      uint32_t child_node  = child.second;
+      while (build_nodes[child_node].children.size() == 1 &&
+             build_nodes[child_node].prefix_rules.empty() &&
+             build_nodes[child_node].exact_rules.empty())
+      {
+        labels_ += build_nodes[child_node].children.begin()->first;
+        child_node = build_nodes[child_node].children.begin()->second;
+      }
+      uint32_t child_index = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+      edges_.push_back(
+          {child.first, label_begin, static_cast<uint32_t>(labels_.size()), child_index});
+      pending.emplace_back(child_node, child_index);
+    }
+    node.edges_end = static_cast<uint32_t>(edges_.size());
+
+    node.prefix_rules_begin = static_cast<uint32_t>(rule_indices_.size());
+    rule_indices_.insert(rule_indices_.end(), build_node.prefix_rules.begin(),
+                         build_node.prefix_rules.end());
+    node.prefix_rules_end  = static_cast<uint32_t>(rule_indices_.size());
+    node.exact_rules_begin = node.prefix_rules_end;
+    rule_indices_.insert(rule_indices_.end(), build_node.exact_rules.begin(),
+                         build_node.exact_rules.end());
+    node.exact_rules_end = static_cast<uint32_t>(rule_indices_.size());
+    nodes_[index]        = node;
+  }
+}
+
+SamplingResult RuleBasedSampler::ShouldSample(
+    const trace_api::SpanContext *parent_context,
+    trace_api::TraceId trace_id,
+    nostd::string_view name,
+    trace_api::SpanKind span_kind,
+    const trace_api::KeyValueIterable &attributes) noexcept
+{
+  SpanAttributes span_attributes(attributes);
+  uint32_t best_rule   = static_cast<uint32_t>(rules_.size());
+  const TrieNode *node = &nodes_[0];
+  FindFirstMatch(node->prefix_rules_begin, node->prefix_rules_end, span_kind, span_attributes,
+                 best_rule);
+
+  size_t position = 0;
+  while (position < name.size())
+  {
+    auto edges_begin = edges_.begin() + node->edges_begin;
+    auto edges_end   = edges_.begin() + node->edges_end;
+    auto edge        = std::lower_bound(edges_begin, edges_end, name[position],
+                                 [](const TrieEdge &edge, char c) { return edge.character < c; });
+    if (edge == edges_end || edge->character != name[position])
+    {
+      break;
+    }
+    size_t label_size = edge->label_end - edge->label_begin;
+    if (name.size() - position - 1 < label_size ||
+        std::memcmp(name.data() + position + 1, labels_.data() + edge->label_begin,
+                    label_size) != 0)
+    {
+      break;
+    }
+    position += 1 + label_size;
+
+    node = &nodes_[edge->node];
+    FindFirstMatch(node->prefix_rules_begin, node->prefix_rules_end, span_kind, span_attributes,
+                   best_rule);
+  }
+  if (position == name.size())
+  {
+    FindFirstMatch(node->exact_rules_begin, node->exact_rules_end, span_kind, span_attributes,
+                   best_rule);
+  }
+
+  Sampler &sampler =
+      (best_rule < rules_.size()) ? *rules_[best_rule].sampler : *default_sampler_;
+  return sampler.ShouldSample(parent_context, trace_id, name, span_kind, attributes);
+}
+
+void RuleBasedSampler::FindFirstMatch(uint32_t rules_begin,
+                                      uint32_t rules_end,
+                                      trace_api::SpanKind span_kind,
+                                      SpanAttributes &attributes,
+                                      uint32_t &best_rule) const noexcept
+{
+  for (uint32_t i = rules_begin; i < rules_end && rule_indices_[i] < best_rule; ++i)
+  {
+    if (Matches(rules_[rule_indices_[i]], span_kind, attributes))
+    {
+      best_rule = rule_indices_[i];
+      return;
+    }
+  }
+}
+
+bool RuleBasedSampler::Matches(const SamplingRule &rule,
+                               trace_api::SpanKind span_kind,
+                               SpanAttributes &attributes) const noexcept
+{
+  if (!rule.span_kinds.empty() &&
+      std::find(rule.span_kinds.begin(), rule.span_kinds.end(), span_kind) ==
+          rule.span_kinds.end())
+  {
+    return false;
+  }
+  if (rule.attributes.empty())
+  {
+    return true;
+  }
+
+  size_t matched = 0;
+  attributes.ForEachKeyValue(
+      [&](nostd::string_view key, const opentelemetry::common::AttributeValue &value) noexcept {
+        for (auto &attribute : rule.attributes)
+        {
+          if (key == attribute.first)
+          {
+            if (AttributeEquals(attribute.second, value))
+            {
+              ++matched;
+            }
+            break;
+          }
+        }
+        return matched < rule.attributes.size();
+      });
+  return matched == rule.attributes.size();
+}
+
+nostd::string_view RuleBasedSampler::GetDescription() const noexcept
+{
+  return description_;
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,389 @@
+#include "src/trace/segment_log.h"
+
+#include "src/common/crc32.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+constexpr char kSegmentMagic[8] = {'O', 'T', 'S', 'P', 'I', 'L', 'L', '1'};
+constexpr char kSegmentPrefix[] = "segment-";
+constexpr char kSegmentSuffix[] = ".log";
+
+/**
+ * The header at the start of every segment file. The offsets are updated in
+ * place through the mapping.
+ */
+struct SegmentHeader
+{
+  char magic[8];
+  uint64_t read_offset;
+  uint64_t write_offset;
+  uint64_t reserved;
+};
+
+/**
+ * The header in front of every record payload. Records are padded to a
+ * multiple of 8 bytes.
+ */
+struct RecordHeader
+{
+  uint32_t size;
+  uint32_t crc;
+};
+
+size_t RecordSpan(size_t payload_size) noexcept
+{
+  return (sizeof(RecordHeader) + payload_size + 7) & ~static_cast<size_t>(7);
+}
+}  // namespace
+
+struct SegmentLog::Segment
+{
+  uint64_t sequence = 0;
+  std::string path;
+  int fd           = -1;
+  char *base       = nullptr;
+  size_t size      = 0;
+  uint64_t records = 0;
+
+  ~Segment()
+  {
+    if (base != nullptr)
+    {
+      ::munmap(base, size);
+    }
+    if (fd >= 0)
+    {
+      ::close(fd);
+    }
+  }
+
+  SegmentHeader &header() noexcept { return *reinterpret_cast<SegmentHeader *>(base); }
+
+  bool HasRoomFor(size_t payload_size) const noexcept
+  {
+    auto &h = *reinterpret_cast<const SegmentHeader *>(base);
+    return h.write_offset + RecordSpan(payload_size) <= size;
+  }
+
+  /**
+   * Validates the record at the given offset.
+   * @return the payload size of the record, or -1 if the record is invalid.
+   */
+  int64_t CheckRecord(uint64_t offset) const noexcept
+  {
+    if (offset + sizeof(RecordHeader) > size)
+    {
+      return -1;
+    }
+    RecordHeader record;
+    memcpy(&record, base + offset, sizeof(record));
+    if (record.size == 0 || offset + RecordSpan(record.size) > size ||
+        common::Crc32(base + offset + sizeof(RecordHeader), record.size) != record.crc)
+    {
+      return -1;
+    }
+    return record.size;
+  }
+};
+
+SegmentLog::SegmentLog(std::string directory,
+                       size_t segment_size,
+                       size_t max_disk_usage) noexcept
+    : directory_{std::move(directory)},
+      segment_size_{std::max(segment_size, sizeof(SegmentHeader) + RecordSpan(1))},
+      max_disk_usage_{max_disk_usage}
+{}
+
+SegmentLog::~SegmentLog()
+{
+  Sync();
+}
+
+std::string SegmentLog::SegmentPath(uint64_t sequence) const
+{
+  char name[64];
+  snprintf(name, sizeof(name), "%s%020llu%s", kSegmentPrefix,
+           static_cast<unsigned long long>(sequence), kSegmentSuffix);
+  return directory_ + "/" + name;
+}
+
+bool SegmentLog::Open() noexcept
+{
+  if (::mkdir(directory_.c_str(), 0755) != 0 && errno != EEXIST)
+  {
+    return false;
+  }
+
+  DIR *dir = ::opendir(directory_.c_str());
+  if (dir == nullptr)
+  {
+    return false;
+  }
+  std::vector<uint64_t> sequences;
+  const size_t prefix_length = sizeof(kSegmentPrefix) - 1;
+  const size_t suffix_length = sizeof(kSegmentSuffix) - 1;
+  while (auto entry = ::readdir(dir))
+  {
+    size_t length = strlen(entry->d_name);
+    if (length <= prefix_length + suffix_length ||
+        strncmp(entry->d_name, kSegmentPrefix, prefix_length) != 0 ||
+        strcmp(entry->d_name + length - suffix_length, kSegmentSuffix) != 0)
+    {
+      continue;
+    }
+    sequences.push_back(strtoull(entry->d_name + prefix_length, nullptr, 10));
+  }
+  ::closedir(dir);
+  std::sort(sequences.begin(), sequences.end());
+
+  for (auto sequence : sequences)
+  {
+    auto segment = OpenSegment(sequence);
+    if (segment == nullptr)
+    {
+      ::unlink(SegmentPath(sequence).c_str());
+      continue;
+    }
+    record_count_ += segment->records;
+    disk_usage_ += segment->size;
+    next_sequence_ = sequence + 1;
+    segments_.push_back(std::move(segment));
+  }
+
+  while (disk_usage_ > max_disk_usage_ && !segments_.empty())
+  {
+    RemoveOldestSegment();
+  }
+  return true;
+}
+
+std::unique_ptr<SegmentLog::Segment> SegmentLog::OpenSegment(uint64_t sequence) noexcept
+{
+  std::unique_ptr<Segment> segment{new Segment};
+  segment->sequence = sequence;
+  segment->path     = SegmentPath(sequence);
+  segment->fd       = ::open(segment->path.c_str(), O_RDWR | O_CLOEXEC);
+  if (segment->fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat st;
+  if (::fstat(segment->fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SegmentHeader))
+  {
+    return nullptr;
+  }
+  segment->size = static_cast<size_t>(st.st_size);
+  void *base    = ::mmap(nullptr, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         segment->fd, 0);
+  if (base == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  segment->base = static_cast<char *>(base);
+
+  auto &header = segment->header();
+  if (memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+      header.read_offset < sizeof(SegmentHeader) || header.read_offset > header.write_offset ||
+      header.write_offset > segment->size)
+  {
+    return nullptr;
+  }
+
+  // Walk the unconsumed records, and cut the segment at the first one that was
+  // not completely written or has been corrupted since.
+  uint64_t offset = header.read_offset;
+  while (offset < header.write_offset)
+  {
+    auto payload_size = segment->CheckRecord(offset);
+    if (payload_size < 0)
+    {
+      break;
+    }
+    offset += RecordSpan(static_cast<size_t>(payload_size));
+    ++segment->records;
+  }
+  if (offset != header.write_offset)
+  {
+    ++dropped_record_count_;
+    header.write_offset = offset;
+  }
+  return segment;
+}
+
+std::unique_ptr<SegmentLog::Segment> SegmentLog::CreateSegment(size_t size) noexcept
+{
+  std::unique_ptr<Segment> segment{new Segment};
+  segment->sequence = next_sequence_++;
+  segment->path     = SegmentPath(segment->sequence);
+  segment->fd       = ::open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                             0644);
+  if (segment->fd < 0)
+  {
+    return nullptr;
+  }
+  // Reserve the blocks up front so a full disk is reported here instead of as
+  // a SIGBUS when writing through the mapping.
+  if (::posix_fallocate(segment->fd, 0, static_cast<off_t>(size)) != 0)
+  {
+    ::unlink(segment->path.c_str());
+    return nullptr;
+  }
+  segment->size = size;
+  void *base    = ::mmap(nullptr, segment->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         segment->fd, 0);
+  if (base == MAP_FAILED)
+  {
+    ::unlink(segment->path.c_str());
+    return nullptr;
+  }
+  segment->base = static_cast<char *>(base);
+
+  auto &header = segment->header();
+  memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+  header.read_offset  = sizeof(SegmentHeader);
+  header.write_offset = sizeof(SegmentHeader);
+  header.reserved     = 0;
+  return segment;
+}
+
+void SegmentLog::RemoveOldestSegment() noexcept
+{
+  auto &segment = segments_.front();
+  record_count_ -= segment->records;
+  dropped_record_count_ += segment->records;
+  disk_usage_ -= segment->size;
+  ::unlink(segment->path.c_str());
+  segments_.pop_front();
+}
+
+bool SegmentLog::Append(nostd::string_view record) noexcept
+{
+  if (record.empty() || record.size() > UINT32_MAX)
+  {
+    return false;
+  }
+
+  if (segments_.empty() || !segments_.back()->HasRoomFor(record.size()))
+  {
+    size_t size = std::max(segment_size_, sizeof(SegmentHeader) + RecordSpan(record.size()));
+    if (size > max_disk_usage_)
+    {
+      return false;
+    }
+    while (disk_usage_ + size > max_disk_usage_)
+    {
+      RemoveOldestSegment();
+    }
+    auto segment = CreateSegment(size);
+    if (segment == nullptr)
+    {
+      return false;
+    }
+    disk_usage_ += segment->size;
+    segments_.push_back(std::move(segment));
+  }
+
+  auto &segment = *segments_.back();
+  auto &header  = segment.header();
+  RecordHeader record_header{static_cast<uint32_t>(record.size()),
+                             common::Crc32(record.data(), record.size())};
+  char *destination = segment.base + header.write_offset;
+  memcpy(destination + sizeof(RecordHeader), record.data(), record.size());
+  memcpy(destination, &record_header, sizeof(record_header));
+  // Publish the record only after its contents are in place.
+  header.write_offset += RecordSpan(record.size());
+  ++segment.records;
+  ++record_count_;
+  return true;
+}
+
+bool SegmentLog::Front(nostd::string_view &record) noexcept
+{
+  while (!segments_.empty())
+  {
+    auto &segment = *segments_.front();
+    auto &header  = segment.header();
+    if (header.read_offset < header.write_offset)
+    {
+      auto payload_size = segment.CheckRecord(header.read_offset);
+      if (payload_size >= 0)
+      {
+        record = nostd::string_view{segment.base + header.read_offset + sizeof(RecordHeader),
+                                    static_cast<size_t>(payload_size)};
+        return true;
+      }
+    }
+
+    // The segment is either drained or the remainder of it is corrupted.
+    if (segments_.size() > 1)
+    {
+      RemoveOldestSegment();
+      continue;
+    }
+    record_count_ -= segment.records;
+    dropped_record_count_ += segment.records;
+    segment.records     = 0;
+    header.read_offset  = sizeof(SegmentHeader);
+    header.write_offset = sizeof(SegmentHeader);
+    break;
+  }
+  return false;
+}
+
+void SegmentLog::PopFront() noexcept
+{
+  nostd::string_view record;
+  if (!Front(record))
+  {
+    return;
+  }
+  auto &segment = *segments_.front();
+  auto &header  = segment.header();
+  header.read_offset += RecordSpan(record.size());
+  --segment.records;
+  --record_count_;
+
+  if (header.read_offset == header.write_offset)
+  {
+    if (segments_.size() > 1)
+    {
+      RemoveOldestSegment();
+    }
+    else
+    {
+      // The only segment is drained, so rewind it instead of allocating a new
+      // one on the next append.
+      header.read_offset  = sizeof(SegmentHeader);
+      header.write_offset = sizeof(SegmentHeader);
+    }
+  }
+}
+
+void SegmentLog::Sync() noexcept
+{
+  for (auto &segment : segments_)
+  {
+    ::msync(segment->base, segment->size, MS_SYNC);
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * An append-only, on-disk FIFO of opaque records.
+ *
+ * Records are stored in a directory of fixed-size segment files which are
+ * pre-allocated and memory-mapped, so appending a record is a memcpy into the
+ * page cache. Every record carries a CRC-32 of its payload and every segment
+ * persists its own read and write offsets, so the log survives a restart of the
+ * process: records that were appended but not yet consumed are recovered by
+ * Open(), and truncated or corrupted records are discarded.
+ *
+ * Total disk usage is bounded. When appending a record would exceed the bound,
+ * the oldest segments are deleted, together with the records they hold.
+ *
+ * This class is thread-compatible. It is only available on POSIX platforms.
+ */
+class SegmentLog
+{
+public:
+  /**
+   * @param directory the directory holding the segment files. It is created if
+   * it does not exist, but its parent must exist.
+   * @param segment_size the size in bytes of each segment file. A record that
+   * does not fit into a segment of this size gets a segment of its own.
+   * @param max_disk_usage the upper bound in bytes for the sum of the sizes of
+   * all segment files.
+   */
+  SegmentLog(std::string directory, size_t segment_size, size_t max_disk_usage) noexcept;
+
+  ~SegmentLog();
+
+  /**
+   * Creates the directory if needed and recovers the records of existing
+   * segment files.
+   * @return true if the log can be used.
+   */
+  bool Open() noexcept;
+
+  /**
+   * Appends a record to the end of the log, evicting the oldest segments if
+   * needed to stay within the disk usage bound.
+   * @param record the record to append
+   * @return true if the record was appended.
+   */
+  bool Append(nostd::string_view record) noexcept;
+
+  /**
+   * Obtains the oldest record of the log. The returned view remains valid
+   * until the next call to Append or PopFront.
+   * @param record set to the oldest record
+   * @return true if the log holds a record.
+   */
+  bool Front(nostd::string_view &record) noexcept;
+
+  /**
+   * Removes the oldest record of the log.
+   */
+  void PopFront() noexcept;
+
+  /**
+   * Writes all modified pages of the log back to disk.
+   */
+  void Sync() noexcept;
+
+  /**
+   * @return the number of records in the log.
+   */
+  uint64_t record_count() const noexcept { return record_count_; }
+
+  /**
+   * @return the number of records that were dropped because their segment was
+   * evicted or corrupted.
+   */
+  uint64_t dropped_record_count() const noexcept { return dropped_record_count_; }
+
+  /**
+   * @return the sum of the sizes of all segment files.
+   */
+  size_t disk_usage() const noexcept { return disk_usage_; }
+
+private:
+  struct Segment;
+
+  std::unique_ptr<Segment> CreateSegment(size_t size) noexcept;
+
+  std::unique_ptr<Segment> OpenSegment(uint64_t sequence) noexcept;
+
+  void RemoveOldestSegment() noexcept;
+
+  std::string SegmentPath(uint64_t sequence) const;
+
+  const std::string directory_;
+  const size_t segment_size_;
+  const size_t max_disk_usage_;
+
+  std::deque<std::unique_ptr<Segment>> segments_;
+  uint64_t next_sequence_        = 0;
+  uint64_t record_count_         = 0;
+  uint64_t dropped_record_count_ = 0;
+  size_t disk_usage_             = 0;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,6 +1,10 @@
 #include "src/trace/span.h"
 
+#include <algorithm>
+
+#include "opentelemetry/sdk/common/empty_attributes.h"
 #include "opentelemetry/version.h"
+#include "src/common/attribute_key_registry.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
@@ -8,6 +12,7 @@ namespace sdk
 namespace trace
 {
 
+using opentelemetry::common::AttributeValue;
 using opentelemetry::core::SteadyTimestamp;
 using opentelemetry::core::SystemTimestamp;
 
@@ -36,27 +41,157 @@ SteadyTimestamp NowOr(const SteadyTimestamp &steady)
     return steady;
   }
 }
+
+/**
+ * Hashes an attribute key with FNV-1a.
+ */
+uint64_t HashKey(nostd::string_view key) noexcept
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (char c : key)
+  {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * Truncates a string to at most max_length bytes, without splitting a UTF-8
+ * character.
+ */
+nostd::string_view TruncateString(nostd::string_view value, size_t max_length) noexcept
+{
+  size_t length = max_length;
+  while (length > 0 && (static_cast<unsigned char>(value.data()[length]) & 0xC0) == 0x80)
+  {
+    --length;
+  }
+  return nostd::string_view(value.data(), length);
+}
+
+template <class T>
+bool TruncateArray(const AttributeValue &value, size_t max_length, AttributeValue &truncated)
+{
+  auto values = nostd::get_if<nostd::span<const T>>(&value);
+  if (values == nullptr || values->size() <= max_length)
+  {
+    return false;
+  }
+  truncated = nostd::span<const T>(values->data(), max_length);
+  return true;
+}
+
+/**
+ * Applies the length limits to an attribute value. The values are truncated
+ * by making views of their beginning, only the elements of string arrays are
+ * copied, into strings.
+ * @return whether the value was truncated, into truncated
+ */
+bool TruncateValue(const AttributeValue &value,
+                   const SpanLimits &limits,
+                   AttributeValue &truncated,
+                   std::vector<nostd::string_view> &strings) noexcept
+{
+  if (auto string_value = nostd::get_if<nostd::string_view>(&value))
+  {
+    if (string_value->size() <= limits.max_attribute_value_length)
+    {
+      return false;
+    }
+    truncated = TruncateString(*string_value, limits.max_attribute_value_length);
+    return true;
+  }
+  if (auto string_values = nostd::get_if<nostd::span<const nostd::string_view>>(&value))
+  {
+    size_t size       = std::min(string_values->size(), limits.max_attribute_array_length);
+    bool is_truncated = size < string_values->size();
+    for (size_t i = 0; i < size && !is_truncated; ++i)
+    {
+      is_truncated = (*string_values)[i].size() > limits.max_attribute_value_length;
+    }
+    if (!is_truncated)
+    {
+      return false;
+    }
+    strings.clear();
+    for (size_t i = 0; i < size; ++i)
+    {
+      auto &string_value = (*string_values)[i];
+      strings.push_back(string_value.size() > limits.max_attribute_value_length
+                            ? TruncateString(string_value, limits.max_attribute_value_length)
+                            : string_value);
+    }
+    truncated = nostd::span<const nostd::string_view>(strings.data(), strings.size());
+    return true;
+  }
+  size_t max_length = limits.max_attribute_array_length;
+  return TruncateArray<bool>(value, max_length, truncated) ||
+         TruncateArray<int>(value, max_length, truncated) ||
+         TruncateArray<int64_t>(value, max_length, truncated) ||
+         TruncateArray<unsigned int>(value, max_length, truncated) ||
+         TruncateArray<uint64_t>(value, max_length, truncated) ||
+         TruncateArray<double>(value, max_length, truncated);
+}
+
+/**
+ * Applies the limits of a span to the attributes of one of its events.
+ */
+class EventAttributes final : public trace_api::KeyValueIterable
+{
+public:
+  EventAttributes(const trace_api::KeyValueIterable &attributes, const SpanLimits &limits) noexcept
+      : attributes_(attributes), limits_(limits)
+  {}
+
+  bool ForEachKeyValue(nostd::function_ref<bool(nostd::string_view, AttributeValue)> callback) const
+      noexcept override
+  {
+    size_t count = 0;
+    std::vector<nostd::string_view> strings;
+    AttributeValue truncated;
+    return attributes_.ForEachKeyValue([&](nostd::string_view key, AttributeValue value) noexcept {
+      if (count++ == limits_.max_attributes_per_event)
+      {
+        return false;
+      }
+      return callback(key, TruncateValue(value, limits_, truncated, strings) ? truncated : value);
+    });
+  }
+
+  size_t size() const noexcept override
+  {
+    return std::min<size_t>(attributes_.size(), limits_.max_attributes_per_event);
+  }
+
+private:
+  const trace_api::KeyValueIterable &attributes_;
+  const SpanLimits &limits_;
+};
 }  // namespace
 
 Span::Span(std::shared_ptr<Tracer> &&tracer,
            std::shared_ptr<SpanProcessor> processor,
            nostd::string_view name,
            const trace_api::KeyValueIterable &attributes,
-           const trace_api::StartSpanOptions &options) noexcept
+           const trace_api::StartSpanOptions &options,
+           const trace_api::SpanContext &span_context,
+           trace_api::SpanId parent_span_id) noexcept
     : tracer_{std::move(tracer)},
       processor_{processor},
       recordable_{processor_->MakeRecordable()},
-      start_steady_time{options.start_steady_time}
+      start_steady_time{options.start_steady_time},
+      span_context_{span_context}
 {
-  (void)options;
   if (recordable_ == nullptr)
   {
     return;
   }
+  recordable_->SetIds(span_context.trace_id(), span_context.span_id(), parent_span_id);
+  recordable_->SetInstrumentationLibrary(tracer_->GetInstrumentationLibrary());
   recordable_->SetName(name);
 
-  attributes.ForEachKeyValue([&](nostd::string_view key, common::AttributeValue value) noexcept {
-    recordable_->SetAttribute(key, value);
+  attributes.ForEachKeyValue([&](nostd::string_view key, AttributeValue value) noexcept {
+    RecordAttribute(key, value);
     return true;
   });
 
@@ -70,31 +205,104 @@ Span::~Span()
   End();
 }
 
-void Span::SetAttribute(nostd::string_view key, const common::AttributeValue &value) noexcept
+void Span::SetAttribute(nostd::string_view key, const AttributeValue &value) noexcept
 {
   std::lock_guard<std::mutex> lock_guard{mu_};
+  if (recordable_ == nullptr)
+  {
+    return;
+  }
+  RecordAttribute(key, value);
+}
 
-  recordable_->SetAttribute(key, value);
+void Span::SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                        const AttributeValue &value) noexcept
+{
+  std::lock_guard<std::mutex> lock_guard{mu_};
+  if (recordable_ == nullptr)
+  {
+    return;
+  }
+  auto registry   = common::AttributeKeyRegistry::GetInstance();
+  uint32_t key_id = registry != nullptr ? registry->GetId(key)
+                                        : common::AttributeKeyRegistry::kInvalidId;
+  if (key_id == common::AttributeKeyRegistry::kInvalidId)
+  {
+    // The key belongs to another copy of the SDK, or there was no memory to
+    // give it an id
+    RecordAttribute(key.name(), value);
+    return;
+  }
+  if (!CountAttributeKey(attribute_key_ids_, key_id))
+  {
+    return;
+  }
+
+  AttributeValue truncated;
+  std::vector<nostd::string_view> strings;
+  recordable_->SetAttribute(
+      key, key_id,
+      TruncateValue(value, tracer_->GetSpanLimits(), truncated, strings) ? truncated : value);
+}
+
+void Span::RecordAttribute(nostd::string_view key, const AttributeValue &value) noexcept
+{
+  if (!CountAttributeKey(attribute_key_hashes_, HashKey(key)))
+  {
+    return;
+  }
+
+  AttributeValue truncated;
+  std::vector<nostd::string_view> strings;
+  recordable_->SetAttribute(
+      key, TruncateValue(value, tracer_->GetSpanLimits(), truncated, strings) ? truncated : value);
+}
+
+bool Span::CountAttributeKey(std::vector<uint64_t> &recorded_keys, uint64_t key) noexcept
+{
+  if (std::find(recorded_keys.begin(), recorded_keys.end(), key) != recorded_keys.end())
+  {
+    return true;
+  }
+  // A name set both by name and through a registered key counts twice
+  if (attribute_key_hashes_.size() + attribute_key_ids_.size() >=
+      tracer_->GetSpanLimits().max_attributes)
+  {
+    ++dropped_attributes_;
+    return false;
+  }
+  recorded_keys.push_back(key);
+  return true;
 }
 
 void Span::AddEvent(nostd::string_view name) noexcept
 {
-  (void)name;
+  AddEvent(name, SystemTimestamp(std::chrono::system_clock::now()),
+           opentelemetry::sdk::GetEmptyAttributes());
 }
 
 void Span::AddEvent(nostd::string_view name, core::SystemTimestamp timestamp) noexcept
 {
-  (void)name;
-  (void)timestamp;
+  AddEvent(name, timestamp, opentelemetry::sdk::GetEmptyAttributes());
 }
 
 void Span::AddEvent(nostd::string_view name,
                     core::SystemTimestamp timestamp,
                     const trace_api::KeyValueIterable &attributes) noexcept
 {
-  (void)name;
-  (void)timestamp;
-  (void)attributes;
+  std::lock_guard<std::mutex> lock_guard{mu_};
+  if (recordable_ == nullptr)
+  {
+    return;
+  }
+  const SpanLimits &limits = tracer_->GetSpanLimits();
+  if (recorded_events_ >= limits.max_events)
+  {
+    ++dropped_events_;
+    return;
+  }
+  ++recorded_events_;
+  recordable_->AddEvent(name, timestamp, EventAttributes(attributes, limits));
 }
 
 void Span::SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept
@@ -128,6 +336,10 @@ void Span::End(const trace_api::EndSpanOptions &options) noexcept
   auto end_steady_time = NowOr(options.end_steady_time);
   recordable_->SetDuration(std::chrono::steady_clock::time_point(end_steady_time) -
                            std::chrono::steady_clock::time_point(start_steady_time));
+  if (dropped_attributes_ > 0 || dropped_events_ > 0)
+  {
+    recordable_->SetDroppedCounts(dropped_attributes_, dropped_events_);
+  }
 
   processor_->OnEnd(std::move(recordable_));
   recordable_.reset();
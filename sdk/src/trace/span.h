@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <mutex>
+#include <vector>
 
 #include "opentelemetry/sdk/trace/tracer.h"
 #include "opentelemetry/version.h"
@@ -19,12 +21,18 @@ class Span final : public trace_api::Span
                 std::shared_ptr<SpanProcessor> processor,
                 nostd::string_view name,
                 const trace_api::KeyValueIterable &attributes,
-                const trace_api::StartSpanOptions &options) noexcept;
+                const trace_api::StartSpanOptions &options,
+                const trace_api::SpanContext &span_context,
+                trace_api::SpanId parent_span_id) noexcept;
 
   ~Span() override;
 
   // trace_api::Span
-  void SetAttribute(nostd::string_view key, const common::AttributeValue &value) noexcept override;
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &value) noexcept override;
+
+  void SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                    const opentelemetry::common::AttributeValue &value) noexcept override;
 
   void AddEvent(nostd::string_view name) noexcept override;
 
@@ -42,14 +50,42 @@ class Span final : public trace_api::Span
 
   bool IsRecording() const noexcept override;
 
+  trace_api::SpanContext GetContext() const noexcept override { return span_context_; }
+
   trace_api::Tracer &tracer() const noexcept override { return *tracer_; }
 
 private:
-  std::shared_ptr<trace_api::Tracer> tracer_;
+  /**
+   * Pass an attribute to the recordable, within the limits of the span. Must
+   * be called with mu_ held, or from the constructor.
+   */
+  void RecordAttribute(nostd::string_view key,
+                       const opentelemetry::common::AttributeValue &value) noexcept;
+
+  /**
+   * Count a key among the attribute keys of the span, unless it was already
+   * recorded. Must be called with mu_ held, or from the constructor.
+   * @param recorded_keys the recorded keys of the same kind
+   * @return false if the attribute must be dropped to stay within the limits
+   */
+  bool CountAttributeKey(std::vector<uint64_t> &recorded_keys, uint64_t key) noexcept;
+
+  std::shared_ptr<Tracer> tracer_;
   std::shared_ptr<SpanProcessor> processor_;
   mutable std::mutex mu_;
   std::unique_ptr<Recordable> recordable_;
   opentelemetry::core::SteadyTimestamp start_steady_time;
+  const trace_api::SpanContext span_context_;
+
+  /*
+   * The hashes of the names and the ids of the registered keys of the
+   * recorded attributes, to tell new keys from updated ones
+   */
+  std::vector<uint64_t> attribute_key_hashes_;
+  std::vector<uint64_t> attribute_key_ids_;
+  uint32_t dropped_attributes_ = 0;
+  uint32_t recorded_events_    = 0;
+  uint32_t dropped_events_     = 0;
 };
 }  // namespace trace
 }  // namespace sdk
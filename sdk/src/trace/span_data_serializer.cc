@@ -0,0 +1,472 @@
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+constexpr uint8_t kFormatVersion = 1;
+
+// Type tags follow the alternative order of SpanDataAttributeValue.
+enum AttributeTag : uint8_t
+{
+  kTagBool,
+  kTagInt64,
+  kTagUInt64,
+  kTagDouble,
+  kTagString,
+  kTagBoolArray,
+  kTagInt64Array,
+  kTagUInt64Array,
+  kTagDoubleArray,
+  kTagStringArray
+};
+
+template <class T>
+void Write(std::string &buffer, T value)
+{
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void WriteString(std::string &buffer, nostd::string_view value)
+{
+  Write<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+  buffer.append(value.data(), value.size());
+}
+
+template <class T>
+void WriteArray(std::string &buffer, const std::vector<T> &values)
+{
+  Write<uint32_t>(buffer, static_cast<uint32_t>(values.size()));
+  buffer.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+void WriteAttribute(std::string &buffer, const SpanDataAttributeValue &value)
+{
+  auto tag = static_cast<uint8_t>(value.index());
+  Write<uint8_t>(buffer, tag);
+  switch (tag)
+  {
+    case kTagBool:
+      Write<uint8_t>(buffer, nostd::get<bool>(value) ? 1 : 0);
+      break;
+    case kTagInt64:
+      Write<int64_t>(buffer, nostd::get<int64_t>(value));
+      break;
+    case kTagUInt64:
+      Write<uint64_t>(buffer, nostd::get<uint64_t>(value));
+      break;
+    case kTagDouble:
+      Write<double>(buffer, nostd::get<double>(value));
+      break;
+    case kTagString:
+      WriteString(buffer, nostd::get<std::string>(value));
+      break;
+    case kTagBoolArray: {
+      auto &values = nostd::get<std::vector<bool>>(value);
+      Write<uint32_t>(buffer, static_cast<uint32_t>(values.size()));
+      for (bool v : values)
+      {
+        Write<uint8_t>(buffer, v ? 1 : 0);
+      }
+      break;
+    }
+    case kTagInt64Array:
+      WriteArray(buffer, nostd::get<std::vector<int64_t>>(value));
+      break;
+    case kTagUInt64Array:
+      WriteArray(buffer, nostd::get<std::vector<uint64_t>>(value));
+      break;
+    case kTagDoubleArray:
+      WriteArray(buffer, nostd::get<std::vector<double>>(value));
+      break;
+    case kTagStringArray: {
+      auto &values = nostd::get<std::vector<std::string>>(value);
+      Write<uint32_t>(buffer, static_cast<uint32_t>(values.size()));
+      for (auto &v : values)
+      {
+        WriteString(buffer, v);
+      }
+      break;
+    }
+  }
+}
+
+/**
+ * A bounds-checked cursor over an encoded span.
+ */
+class Reader
+{
+public:
+  explicit Reader(nostd::string_view data) noexcept
+      : pos_{data.data()}, end_{data.data() + data.size()}
+  {}
+
+  template <class T>
+  bool Read(T &value) noexcept
+  {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(T))
+    {
+      return false;
+    }
+    memcpy(&value, pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadBytes(size_t size, nostd::string_view &value) noexcept
+  {
+    if (static_cast<size_t>(end_ - pos_) < size)
+    {
+      return false;
+    }
+    value = nostd::string_view{pos_, size};
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadString(nostd::string_view &value) noexcept
+  {
+    uint32_t size;
+    return Read(size) && ReadBytes(size, value);
+  }
+
+  template <class T>
+  bool ReadArray(std::vector<T> &values) noexcept
+  {
+    uint32_t size;
+    nostd::string_view bytes;
+    if (!Read(size) || !ReadBytes(static_cast<size_t>(size) * sizeof(T), bytes))
+    {
+      return false;
+    }
+    values.resize(size);
+    memcpy(values.data(), bytes.data(), bytes.size());
+    return true;
+  }
+
+  size_t remaining() const noexcept { return static_cast<size_t>(end_ - pos_); }
+
+  bool AtEnd() const noexcept { return pos_ == end_; }
+
+private:
+  const char *pos_;
+  const char *end_;
+};
+
+template <class Id>
+bool ReadId(Reader &reader, Id &id) noexcept
+{
+  nostd::string_view bytes;
+  if (!reader.ReadBytes(Id::kSize, bytes))
+  {
+    return false;
+  }
+  id = Id{nostd::span<const uint8_t, Id::kSize>{reinterpret_cast<const uint8_t *>(bytes.data()),
+                                                Id::kSize}};
+  return true;
+}
+
+bool ReadAttribute(Reader &reader, nostd::string_view key, Recordable &recordable) noexcept
+{
+  uint8_t tag;
+  if (!reader.Read(tag))
+  {
+    return false;
+  }
+  switch (tag)
+  {
+    case kTagBool: {
+      uint8_t value;
+      if (!reader.Read(value))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, value != 0);
+      return true;
+    }
+    case kTagInt64: {
+      int64_t value;
+      if (!reader.Read(value))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, value);
+      return true;
+    }
+    case kTagUInt64: {
+      uint64_t value;
+      if (!reader.Read(value))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, value);
+      return true;
+    }
+    case kTagDouble: {
+      double value;
+      if (!reader.Read(value))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, value);
+      return true;
+    }
+    case kTagString: {
+      nostd::string_view value;
+      if (!reader.ReadString(value))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, value);
+      return true;
+    }
+    case kTagBoolArray: {
+      std::vector<uint8_t> raw;
+      if (!reader.ReadArray(raw))
+      {
+        return false;
+      }
+      std::unique_ptr<bool[]> values{new bool[raw.size() + 1]};
+      for (size_t i = 0; i < raw.size(); ++i)
+      {
+        values[i] = raw[i] != 0;
+      }
+      recordable.SetAttribute(key, nostd::span<const bool>{values.get(), raw.size()});
+      return true;
+    }
+    case kTagInt64Array: {
+      std::vector<int64_t> values;
+      if (!reader.ReadArray(values))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, nostd::span<const int64_t>{values.data(), values.size()});
+      return true;
+    }
+    case kTagUInt64Array: {
+      std::vector<uint64_t> values;
+      if (!reader.ReadArray(values))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, nostd::span<const uint64_t>{values.data(), values.size()});
+      return true;
+    }
+    case kTagDoubleArray: {
+      std::vector<double> values;
+      if (!reader.ReadArray(values))
+      {
+        return false;
+      }
+      recordable.SetAttribute(key, nostd::span<const double>{values.data(), values.size()});
+      return true;
+    }
+    case kTagStringArray: {
+      uint32_t size;
+      // Every element takes at least its length prefix.
+      if (!reader.Read(size) || size > reader.remaining() / sizeof(uint32_t))
+      {
+        return false;
+      }
+      std::vector<nostd::string_view> values(size);
+      for (auto &value : values)
+      {
+        if (!reader.ReadString(value))
+        {
+          return false;
+        }
+      }
+      recordable.SetAttribute(key,
+                              nostd::span<const nostd::string_view>{values.data(), values.size()});
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+/**
+ * Sets an owned attribute value on a recordable by converting it back to its
+ * non-owning AttributeValue form.
+ */
+void CopyAttribute(nostd::string_view key,
+                   const SpanDataAttributeValue &value,
+                   Recordable &recordable) noexcept
+{
+  switch (value.index())
+  {
+    case kTagBool:
+      recordable.SetAttribute(key, nostd::get<bool>(value));
+      break;
+    case kTagInt64:
+      recordable.SetAttribute(key, nostd::get<int64_t>(value));
+      break;
+    case kTagUInt64:
+      recordable.SetAttribute(key, nostd::get<uint64_t>(value));
+      break;
+    case kTagDouble:
+      recordable.SetAttribute(key, nostd::get<double>(value));
+      break;
+    case kTagString:
+      recordable.SetAttribute(key, nostd::string_view{nostd::get<std::string>(value)});
+      break;
+    case kTagBoolArray: {
+      auto &values = nostd::get<std::vector<bool>>(value);
+      std::unique_ptr<bool[]> copy{new bool[values.size() + 1]};
+      for (size_t i = 0; i < values.size(); ++i)
+      {
+        copy[i] = values[i];
+      }
+      recordable.SetAttribute(key, nostd::span<const bool>{copy.get(), values.size()});
+      break;
+    }
+    case kTagInt64Array: {
+      auto &values = nostd::get<std::vector<int64_t>>(value);
+      recordable.SetAttribute(key, nostd::span<const int64_t>{values.data(), values.size()});
+      break;
+    }
+    case kTagUInt64Array: {
+      auto &values = nostd::get<std::vector<uint64_t>>(value);
+      recordable.SetAttribute(key, nostd::span<const uint64_t>{values.data(), values.size()});
+      break;
+    }
+    case kTagDoubleArray: {
+      auto &values = nostd::get<std::vector<double>>(value);
+      recordable.SetAttribute(key, nostd::span<const double>{values.data(), values.size()});
+      break;
+    }
+    case kTagStringArray: {
+      auto &values = nostd::get<std::vector<std::string>>(value);
+      std::vector<nostd::string_view> views(values.begin(), values.end());
+      recordable.SetAttribute(key,
+                              nostd::span<const nostd::string_view>{views.data(), views.size()});
+      break;
+    }
+  }
+}
+}  // namespace
+
+void SpanDataSerializer::Serialize(const SpanData &span, std::string &buffer)
+{
+  Write<uint8_t>(buffer, kFormatVersion);
+
+  auto trace_id       = span.GetTraceId().Id();
+  auto span_id        = span.GetSpanId().Id();
+  auto parent_span_id = span.GetParentSpanId().Id();
+  buffer.append(reinterpret_cast<const char *>(trace_id.data()), trace_id.size());
+  buffer.append(reinterpret_cast<const char *>(span_id.data()), span_id.size());
+  buffer.append(reinterpret_cast<const char *>(parent_span_id.data()), parent_span_id.size());
+
+  Write<int64_t>(buffer, span.GetStartTime().time_since_epoch().count());
+  Write<int64_t>(buffer, span.GetDuration().count());
+  Write<uint32_t>(buffer, static_cast<uint32_t>(span.GetStatus()));
+  WriteString(buffer, span.GetDescription());
+  WriteString(buffer, span.GetName());
+
+  auto &attributes = span.GetAttributes();
+  Write<uint32_t>(buffer, static_cast<uint32_t>(attributes.size()));
+  for (auto &kv : attributes)
+  {
+    WriteString(buffer, kv.first);
+    WriteAttribute(buffer, kv.second);
+  }
+
+  auto &events = span.GetEvents();
+  Write<uint32_t>(buffer, static_cast<uint32_t>(events.size()));
+  for (auto &event : events)
+  {
+    WriteString(buffer, event.GetName());
+    Write<int64_t>(buffer, event.GetTimestamp().time_since_epoch().count());
+  }
+}
+
+bool SpanDataSerializer::Deserialize(nostd::string_view data, Recordable &recordable) noexcept
+{
+  Reader reader{data};
+
+  uint8_t version;
+  if (!reader.Read(version) || version != kFormatVersion)
+  {
+    return false;
+  }
+
+  opentelemetry::trace::TraceId trace_id;
+  opentelemetry::trace::SpanId span_id, parent_span_id;
+  if (!ReadId(reader, trace_id) || !ReadId(reader, span_id) || !ReadId(reader, parent_span_id))
+  {
+    return false;
+  }
+  recordable.SetIds(trace_id, span_id, parent_span_id);
+
+  int64_t start_time, duration;
+  uint32_t status;
+  nostd::string_view description, name;
+  if (!reader.Read(start_time) || !reader.Read(duration) || !reader.Read(status) ||
+      !reader.ReadString(description) || !reader.ReadString(name))
+  {
+    return false;
+  }
+  recordable.SetStartTime(core::SystemTimestamp{std::chrono::nanoseconds{start_time}});
+  recordable.SetDuration(std::chrono::nanoseconds{duration});
+  recordable.SetStatus(static_cast<opentelemetry::trace::CanonicalCode>(status), description);
+  recordable.SetName(name);
+
+  uint32_t attribute_count;
+  if (!reader.Read(attribute_count))
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < attribute_count; ++i)
+  {
+    nostd::string_view key;
+    if (!reader.ReadString(key) || !ReadAttribute(reader, key, recordable))
+    {
+      return false;
+    }
+  }
+
+  uint32_t event_count;
+  if (!reader.Read(event_count))
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < event_count; ++i)
+  {
+    nostd::string_view event_name;
+    int64_t timestamp;
+    if (!reader.ReadString(event_name) || !reader.Read(timestamp))
+    {
+      return false;
+    }
+    recordable.AddEvent(event_name, core::SystemTimestamp{std::chrono::nanoseconds{timestamp}});
+  }
+
+  return reader.AtEnd();
+}
+
+void SpanDataSerializer::CopyTo(const SpanData &span, Recordable &recordable) noexcept
+{
+  recordable.SetIds(span.GetTraceId(), span.GetSpanId(), span.GetParentSpanId());
+  recordable.SetStartTime(span.GetStartTime());
+  recordable.SetDuration(span.GetDuration());
+  recordable.SetStatus(span.GetStatus(), span.GetDescription());
+  recordable.SetName(span.GetName());
+  for (auto &kv : span.GetAttributes())
+  {
+    CopyAttribute(kv.first, kv.second, recordable);
+  }
+  for (auto &event : span.GetEvents())
+  {
+    recordable.AddEvent(event.GetName(), event.GetTimestamp());
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,377 @@
+#include "opentelemetry/sdk/trace/tail_sampling_processor.h"
+#include "src/trace/attribute_equals.h"
+
+#include <cstring>
+#include <iterator>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+namespace
+{
+/**
+ * Wraps the recordable of the exporter, to evaluate the policies while the
+ * span is recorded. Only the outcome is kept, so that the recorded data isn't
+ * copied.
+ */
+class TailSamplingRecordable final : public Recordable
+{
+public:
+  TailSamplingRecordable(std::unique_ptr<Recordable> &&recordable,
+                         const TailSamplingPolicy &policy) noexcept
+      : recordable_(std::move(recordable)), policy_(policy)
+  {}
+
+  void SetIds(opentelemetry::trace::TraceId trace_id,
+              opentelemetry::trace::SpanId span_id,
+              opentelemetry::trace::SpanId parent_span_id) noexcept override
+  {
+    trace_id_ = trace_id;
+    recordable_->SetIds(trace_id, span_id, parent_span_id);
+  }
+
+  void SetAttribute(nostd::string_view key,
+                    const opentelemetry::common::AttributeValue &value) noexcept override
+  {
+    EvaluateAttribute(key, value);
+    recordable_->SetAttribute(key, value);
+  }
+
+  void SetAttribute(const opentelemetry::common::AttributeKeyBase &key,
+                    uint32_t key_id,
+                    const opentelemetry::common::AttributeValue &value) noexcept override
+  {
+    EvaluateAttribute(key.name(), value);
+    recordable_->SetAttribute(key, key_id, value);
+  }
+
+  void AddEvent(nostd::string_view name,
+                core::SystemTimestamp timestamp,
+                const trace_api::KeyValueIterable &attributes) noexcept override
+  {
+    recordable_->AddEvent(name, timestamp, attributes);
+  }
+
+  void AddLink(opentelemetry::trace::SpanContext span_context,
+               const trace_api::KeyValueIterable &attributes) noexcept override
+  {
+    recordable_->AddLink(span_context, attributes);
+  }
+
+  void SetStatus(trace_api::CanonicalCode code, nostd::string_view description) noexcept override
+  {
+    if (policy_.keep_errors && code != trace_api::CanonicalCode::OK)
+    {
+      keep_ = true;
+    }
+    recordable_->SetStatus(code, description);
+  }
+
+  void SetName(nostd::string_view name) noexcept override { recordable_->SetName(name); }
+
+  void SetStartTime(opentelemetry::core::SystemTimestamp start_time) noexcept override
+  {
+    recordable_->SetStartTime(start_time);
+  }
+
+  void SetDuration(std::chrono::nanoseconds duration) noexcept override
+  {
+    if (policy_.latency_threshold.count() > 0 && duration >= policy_.latency_threshold)
+    {
+      keep_ = true;
+    }
+    recordable_->SetDuration(duration);
+  }
+
+  void SetInstrumentationLibrary(
+      const std::shared_ptr<const opentelemetry::sdk::common::InstrumentationLibrary>
+          &instrumentation_library) noexcept override
+  {
+    recordable_->SetInstrumentationLibrary(instrumentation_library);
+  }
+
+  void SetDroppedCounts(uint32_t dropped_attributes, uint32_t dropped_events) noexcept override
+  {
+    recordable_->SetDroppedCounts(dropped_attributes, dropped_events);
+  }
+
+  opentelemetry::trace::TraceId GetTraceId() const noexcept { return trace_id_; }
+
+  bool GetKeep() const noexcept { return keep_; }
+
+  std::unique_ptr<Recordable> Release() noexcept { return std::move(recordable_); }
+
+private:
+  void EvaluateAttribute(nostd::string_view key,
+                         const opentelemetry::common::AttributeValue &value) noexcept
+  {
+    for (auto &attribute : policy_.attributes)
+    {
+      if (key == attribute.first && AttributeEquals(attribute.second, value))
+      {
+        keep_ = true;
+      }
+    }
+  }
+
+  std::unique_ptr<Recordable> recordable_;
+  const TailSamplingPolicy &policy_;
+  opentelemetry::trace::TraceId trace_id_;
+  bool keep_ = false;
+};
+}  // namespace
+
+size_t TailSamplingProcessor::TraceIdHash::operator()(
+    const opentelemetry::trace::TraceId &trace_id) const noexcept
+{
+  // Trace ids are random, so any of their bytes make a good hash
+  size_t hash;
+  std::memcpy(&hash, trace_id.Id().data(), sizeof(hash));
+  return hash;
+}
+
+TailSamplingProcessor::TailSamplingProcessor(std::unique_ptr<SpanExporter> &&exporter,
+                                             TailSamplingPolicy policy,
+                                             const std::chrono::milliseconds decision_wait,
+                                             const size_t max_buffered_spans,
+                                             const size_t max_decided_traces)
+    : exporter_(std::move(exporter)),
+      policy_(std::move(policy)),
+      decision_wait_(decision_wait),
+      max_buffered_spans_(max_buffered_spans),
+      max_decided_traces_(max_decided_traces),
+      worker_thread_(&TailSamplingProcessor::DoBackgroundWork, this)
+{}
+
+std::unique_ptr<Recordable> TailSamplingProcessor::MakeRecordable() noexcept
+{
+  auto recordable = exporter_->MakeRecordable();
+  if (recordable == nullptr)
+  {
+    return nullptr;
+  }
+  return std::unique_ptr<Recordable>(new TailSamplingRecordable(std::move(recordable), policy_));
+}
+
+void TailSamplingProcessor::OnStart(Recordable &) noexcept
+{
+  // no-op
+}
+
+void TailSamplingProcessor::OnEnd(std::unique_ptr<Recordable> &&span) noexcept
+{
+  if (is_shutdown_.load() == true || span == nullptr)
+  {
+    return;
+  }
+
+  auto recordable = dynamic_cast<TailSamplingRecordable *>(span.get());
+  if (recordable == nullptr)
+  {
+    return;
+  }
+  opentelemetry::trace::TraceId trace_id = recordable->GetTraceId();
+  bool keep                              = recordable->GetKeep();
+
+  std::vector<std::unique_ptr<Recordable>> kept_spans;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = traces_.find(trace_id);
+    if (it == traces_.end())
+    {
+      const Decision *decision = FindDecision(trace_id);
+      if (decision != nullptr)
+      {
+        ++late_spans_;
+        if (decision->keep)
+        {
+          kept_spans.push_back(recordable->Release());
+        }
+      }
+      else
+      {
+        it = traces_.emplace(trace_id, BufferedTrace{}).first;
+        windows_.push_back({trace_id, std::chrono::steady_clock::now() + decision_wait_});
+      }
+    }
+    if (it != traces_.end())
+    {
+      it->second.spans.push_back(recordable->Release());
+      it->second.keep = it->second.keep || keep;
+      ++buffered_spans_;
+
+      while (buffered_spans_ > max_buffered_spans_)
+      {
+        ++evicted_traces_;
+        DecideOldestTrace(kept_spans);
+      }
+    }
+  }
+  Export(kept_spans);
+}
+
+void TailSamplingProcessor::ForceFlush(std::chrono::microseconds timeout) noexcept
+{
+  if (is_shutdown_.load() == true)
+  {
+    return;
+  }
+
+  std::vector<std::unique_ptr<Recordable>> kept_spans;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    while (!windows_.empty())
+    {
+      DecideOldestTrace(kept_spans);
+    }
+  }
+  Export(kept_spans);
+}
+
+void TailSamplingProcessor::DoBackgroundWork()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (is_shutdown_.load() == false)
+  {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Recordable>> kept_spans;
+    while (!windows_.empty() && windows_.front().closes_at <= now)
+    {
+      DecideOldestTrace(kept_spans);
+    }
+    if (!kept_spans.empty())
+    {
+      lock.unlock();
+      Export(kept_spans);
+      lock.lock();
+      continue;
+    }
+
+    // Windows only open after the ones already waited for, so waking up for
+    // the oldest one is enough
+    auto wake_up = windows_.empty() ? now + decision_wait_ : windows_.front().closes_at;
+    cv_.wait_until(lock, wake_up);
+  }
+}
+
+void TailSamplingProcessor::DecideOldestTrace(
+    std::vector<std::unique_ptr<Recordable>> &kept_spans) noexcept
+{
+  auto it = traces_.find(windows_.front().trace_id);
+  windows_.pop_front();
+
+  BufferedTrace &trace = it->second;
+  buffered_spans_ -= trace.spans.size();
+  if (trace.keep)
+  {
+    ++kept_traces_;
+    for (auto &span : trace.spans)
+    {
+      kept_spans.push_back(std::move(span));
+    }
+  }
+  else
+  {
+    ++dropped_traces_;
+  }
+  RememberDecision(it->first, trace.keep);
+  traces_.erase(it);
+}
+
+void TailSamplingProcessor::RememberDecision(const opentelemetry::trace::TraceId &trace_id,
+                                             bool keep) noexcept
+{
+  if (max_decided_traces_ == 0)
+  {
+    return;
+  }
+  auto it = decisions_by_trace_.find(trace_id);
+  if (it != decisions_by_trace_.end())
+  {
+    it->second->keep = keep;
+    decisions_.splice(decisions_.begin(), decisions_, it->second);
+    return;
+  }
+  if (decisions_.size() == max_decided_traces_)
+  {
+    // Reuse the node of the least recently used decision
+    decisions_by_trace_.erase(decisions_.back().trace_id);
+    decisions_.splice(decisions_.begin(), decisions_, std::prev(decisions_.end()));
+    decisions_.front() = {trace_id, keep};
+  }
+  else
+  {
+    decisions_.push_front({trace_id, keep});
+  }
+  decisions_by_trace_[trace_id] = decisions_.begin();
+}
+
+const TailSamplingProcessor::Decision *TailSamplingProcessor::FindDecision(
+    const opentelemetry::trace::TraceId &trace_id) noexcept
+{
+  auto it = decisions_by_trace_.find(trace_id);
+  if (it == decisions_by_trace_.end())
+  {
+    return nullptr;
+  }
+  decisions_.splice(decisions_.begin(), decisions_, it->second);
+  return &*it->second;
+}
+
+void TailSamplingProcessor::Export(std::vector<std::unique_ptr<Recordable>> &kept_spans) noexcept
+{
+  if (kept_spans.empty())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(export_mutex_);
+  exporter_->Export(
+      nostd::span<std::unique_ptr<Recordable>>(kept_spans.data(), kept_spans.size()));
+}
+
+TailSamplingProcessor::Stats TailSamplingProcessor::GetStats() const noexcept
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return {buffered_spans_, traces_.size(), kept_traces_, dropped_traces_, evicted_traces_,
+          late_spans_};
+}
+
+void TailSamplingProcessor::Shutdown(std::chrono::microseconds timeout) noexcept
+{
+  if (is_shutdown_.exchange(true) == true)
+  {
+    return;
+  }
+
+  {
+    // Taking the lock makes sure the worker is waiting, and sees the flag
+    std::lock_guard<std::mutex> guard(mutex_);
+    cv_.notify_one();
+  }
+  worker_thread_.join();
+
+  std::vector<std::unique_ptr<Recordable>> kept_spans;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    while (!windows_.empty())
+    {
+      DecideOldestTrace(kept_spans);
+    }
+  }
+  Export(kept_spans);
+
+  exporter_->Shutdown();
+}
+
+TailSamplingProcessor::~TailSamplingProcessor()
+{
+  if (is_shutdown_.load() == false)
+  {
+    Shutdown();
+  }
+}
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,7 +1,10 @@
 #include "opentelemetry/sdk/trace/tracer.h"
 
-#include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/context/threadlocal_context.h"
 #include "opentelemetry/version.h"
+#include "src/common/epoch.h"
+#include "src/common/random.h"
+#include "src/trace/non_recording_span.h"
 #include "src/trace/span.h"
 
 OPENTELEMETRY_BEGIN_NAMESPACE
@@ -9,23 +12,72 @@ namespace sdk
 {
 namespace trace
 {
-Tracer::Tracer(std::shared_ptr<SpanProcessor> processor, std::shared_ptr<Sampler> sampler) noexcept
-    : processor_{processor}, sampler_{sampler}
+namespace
+{
+trace_api::TraceId GenerateTraceId() noexcept
+{
+  uint8_t buffer[trace_api::TraceId::kSize];
+  common::Random::GenerateRandomBuffer(buffer);
+  return trace_api::TraceId(buffer);
+}
+
+trace_api::SpanId GenerateSpanId() noexcept
+{
+  uint8_t buffer[trace_api::SpanId::kSize];
+  common::Random::GenerateRandomBuffer(buffer);
+  return trace_api::SpanId(buffer);
+}
+}  // namespace
+
+Tracer::Tracer(std::shared_ptr<SpanProcessor> processor,
+               std::shared_ptr<Sampler> sampler,
+               opentelemetry::sdk::common::InstrumentationLibrary instrumentation_library,
+               SpanLimits span_limits) noexcept
+    : config_{new Config{std::move(processor), std::move(sampler)}},
+      instrumentation_library_{std::make_shared<const common::InstrumentationLibrary>(
+          std::move(instrumentation_library))},
+      span_limits_(span_limits)
 {}
 
+Tracer::~Tracer()
+{
+  // Spans hold a reference to the tracer, so none can read the config anymore
+  delete config_.load(std::memory_order_relaxed);
+  // Configs replaced while spans were starting may still wait to be deleted,
+  // holding on to their processors
+  common::Epoch::Synchronize();
+}
+
 void Tracer::SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept
 {
-  processor_.store(processor);
+  std::lock_guard<std::mutex> guard(config_mutex_);
+  auto config = config_.load(std::memory_order_relaxed);
+  PublishConfig(new Config{std::move(processor), config->sampler});
+}
+
+void Tracer::SetSampler(std::shared_ptr<Sampler> sampler) noexcept
+{
+  std::lock_guard<std::mutex> guard(config_mutex_);
+  auto config = config_.load(std::memory_order_relaxed);
+  PublishConfig(new Config{config->processor, std::move(sampler)});
+}
+
+void Tracer::PublishConfig(const Config *config) noexcept
+{
+  auto old_config = config_.exchange(config, std::memory_order_release);
+  common::Epoch::Retire(old_config);
 }
 
 std::shared_ptr<SpanProcessor> Tracer::GetProcessor() const noexcept
 {
-  return processor_.load();
+  common::Epoch::Guard guard;
+  return config_.load(std::memory_order_acquire)->processor;
 }
 
 std::shared_ptr<Sampler> Tracer::GetSampler() const noexcept
 {
-  return sampler_;
+  common::Epoch::Guard guard;
+  return config_.load(std::memory_order_acquire)->sampler;
 }
 
 nostd::unique_ptr<trace_api::Span> Tracer::StartSpan(
@@ -33,18 +85,32 @@ nostd::unique_ptr<trace_api::Span> Tracer::StartSpan(
     const trace_api::KeyValueIterable &attributes,
     const trace_api::StartSpanOptions &options) noexcept
 {
-  // TODO: replace nullptr with parent context in span context
-  auto sampling_result =
-      sampler_->ShouldSample(nullptr, trace_api::TraceId(), name, options.kind, attributes);
+  // Spans started while another span is active are its children.
+  trace_api::SpanContext parent_context = GetCurrentSpanContext();
+  bool has_parent             = parent_context.IsValid();
+  trace_api::TraceId trace_id = has_parent ? parent_context.trace_id() : GenerateTraceId();
+
+  // The config is read without taking a reference, so it must not be deleted
+  // until the span holds its own reference to the processor.
+  common::Epoch::Guard guard;
+  const Config *config = config_.load(std::memory_order_acquire);
+
+  auto sampling_result = config->sampler->ShouldSample(
+      has_parent ? &parent_context : nullptr, trace_id, name, options.kind, attributes);
+  bool sampled = sampling_result.decision == Decision::RECORD_AND_SAMPLE;
+  trace_api::TraceFlags trace_flags{sampled ? trace_api::TraceFlags::kIsSampled : uint8_t{0}};
+  trace_api::SpanContext span_context{trace_id, GenerateSpanId(), trace_flags, false};
+
   if (sampling_result.decision == Decision::NOT_RECORD)
   {
-    return nostd::unique_ptr<trace_api::Span>{new (std::nothrow)
-                                                  trace_api::NoopSpan{this->shared_from_this()}};
+    return nostd::unique_ptr<trace_api::Span>{
+        new (std::nothrow) NonRecordingSpan{this->shared_from_this(), span_context}};
   }
   else
   {
-    auto span = nostd::unique_ptr<trace_api::Span>{new (std::nothrow) Span{
-        this->shared_from_this(), processor_.load(), name, attributes, options}};
+    auto span = nostd::unique_ptr<trace_api::Span>{
+        new (std::nothrow) Span{this->shared_from_this(), config->processor, name, attributes,
+                                options, span_context, parent_context.span_id()}};
 
     // if the attributes is not nullptr, add attributes to the span.
     if (sampling_result.attributes)
@@ -1,28 +1,115 @@
 #include "opentelemetry/sdk/trace/tracer_provider.h"
 
+#include <algorithm>
+
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
 {
 namespace trace
 {
+namespace
+{
+using Tracers = std::vector<std::shared_ptr<Tracer>>;
+
+/**
+ * Orders the instrumentation libraries by name, then by version.
+ */
+int CompareLibrary(const opentelemetry::sdk::common::InstrumentationLibrary &library,
+                   nostd::string_view library_name,
+                   nostd::string_view library_version) noexcept
+{
+  int result = nostd::string_view(library.name).compare(library_name);
+  return result != 0 ? result : nostd::string_view(library.version).compare(library_version);
+}
+
+/**
+ * @return the first tracer whose library isn't ordered before the given one
+ */
+Tracers::const_iterator LowerBound(const Tracers &tracers,
+                                   nostd::string_view library_name,
+                                   nostd::string_view library_version) noexcept
+{
+  return std::lower_bound(tracers.begin(), tracers.end(), library_name,
+                          [&](const std::shared_ptr<Tracer> &tracer, nostd::string_view name) {
+                            return CompareLibrary(*tracer->GetInstrumentationLibrary(), name,
+                                                  library_version) < 0;
+                          });
+}
+
+/**
+ * @return the tracer of the given library, or nullptr if it has none yet
+ */
+const std::shared_ptr<Tracer> *FindTracer(const Tracers &tracers,
+                                          nostd::string_view library_name,
+                                          nostd::string_view library_version) noexcept
+{
+  auto it = LowerBound(tracers, library_name, library_version);
+  if (it != tracers.end() &&
+      CompareLibrary(*(*it)->GetInstrumentationLibrary(), library_name, library_version) == 0)
+  {
+    return &*it;
+  }
+  return nullptr;
+}
+}  // namespace
+
 TracerProvider::TracerProvider(std::shared_ptr<SpanProcessor> processor,
-                               std::shared_ptr<Sampler> sampler) noexcept
-    : processor_{processor}, tracer_(new Tracer(std::move(processor), sampler)), sampler_(sampler)
-{}
+                               std::shared_ptr<Sampler> sampler,
+                               SpanLimits span_limits) noexcept
+    : processor_{processor}, sampler_(sampler), span_limits_(span_limits)
+{
+  snapshots_.emplace_back(new TracerMap);
+  tracers_.store(snapshots_.back().get(), std::memory_order_release);
+}
 
 opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> TracerProvider::GetTracer(
     nostd::string_view library_name,
     nostd::string_view library_version) noexcept
 {
-  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer_);
+  // Pairs with the release store publishing a snapshot, so that its tracers
+  // are seen fully constructed
+  auto tracer =
+      FindTracer(*tracers_.load(std::memory_order_acquire), library_name, library_version);
+  if (tracer != nullptr)
+  {
+    return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(*tracer);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  const TracerMap &tracers = *tracers_.load(std::memory_order_relaxed);
+  auto position            = LowerBound(tracers, library_name, library_version);
+  if (position != tracers.end() && CompareLibrary(*(*position)->GetInstrumentationLibrary(),
+                                                  library_name, library_version) == 0)
+  {
+    // Another thread added the library since the snapshot was read
+    return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(*position);
+  }
+
+  std::unique_ptr<TracerMap> new_tracers(new TracerMap);
+  new_tracers->reserve(tracers.size() + 1);
+  new_tracers->insert(new_tracers->end(), tracers.begin(), position);
+  new_tracers->emplace_back(new Tracer(processor_.load(), sampler_.load(),
+                                       {std::string(library_name), std::string(library_version)},
+                                       span_limits_));
+  new_tracers->insert(new_tracers->end(), position, tracers.end());
+  std::shared_ptr<Tracer> new_tracer = (*new_tracers)[position - tracers.begin()];
+
+  tracers_.store(new_tracers.get(), std::memory_order_release);
+  snapshots_.push_back(std::move(new_tracers));
+  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(new_tracer);
 }
 
 void TracerProvider::SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept
 {
+  // Holding the lock makes sure that the tracers added concurrently get the
+  // new processor too
+  std::lock_guard<std::mutex> guard(mutex_);
   processor_.store(processor);
 
-  auto sdkTracer = static_cast<Tracer *>(tracer_.get());
-  sdkTracer->SetProcessor(processor);
+  for (auto &tracer : *tracers_.load(std::memory_order_relaxed))
+  {
+    tracer->SetProcessor(processor);
+  }
 }
 
 std::shared_ptr<SpanProcessor> TracerProvider::GetProcessor() const noexcept
@@ -30,9 +117,20 @@ std::shared_ptr<SpanProcessor> TracerProvider::GetProcessor() const noexcept
   return processor_.load();
 }
 
+void TracerProvider::SetSampler(std::shared_ptr<Sampler> sampler) noexcept
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  sampler_.store(sampler);
+
+  for (auto &tracer : *tracers_.load(std::memory_order_relaxed))
+  {
+    tracer->SetSampler(sampler);
+  }
+}
+
 std::shared_ptr<Sampler> TracerProvider::GetSampler() const noexcept
 {
-  return sampler_;
+  return sampler_.load();
 }
 }  // namespace trace
 }  // namespace sdk
@@ -0,0 +1,33 @@
+#include "src/common/attribute_key_registry.h"
+
+#include <gtest/gtest.h>
+
+using opentelemetry::common::AttributeKey;
+using opentelemetry::sdk::common::AttributeKeyRegistry;
+
+TEST(AttributeKeyRegistry, SameNameSameId)
+{
+  AttributeKeyRegistry registry;
+  AttributeKey<int64_t> key1{"same"};
+  AttributeKey<int64_t> key2{"same"};
+  AttributeKey<bool> key3{"other"};
+
+  uint32_t id = registry.GetId(key1);
+  EXPECT_NE(AttributeKeyRegistry::kInvalidId, id);
+  EXPECT_EQ(id, registry.GetId(key1));
+  EXPECT_EQ(id, registry.GetId(key2));
+  EXPECT_NE(id, registry.GetId(key3));
+}
+
+TEST(AttributeKeyRegistry, KeyOfAnotherRegistry)
+{
+  AttributeKeyRegistry registry1;
+  AttributeKeyRegistry registry2;
+  AttributeKey<int64_t> key1{"key"};
+  AttributeKey<int64_t> key2{"key"};
+
+  EXPECT_EQ(0, registry1.GetId(key1));
+  EXPECT_EQ(AttributeKeyRegistry::kInvalidId, registry2.GetId(key1));
+  EXPECT_EQ(0, registry2.GetId(key2));
+  EXPECT_EQ(AttributeKeyRegistry::kInvalidId, registry1.GetId(key2));
+}
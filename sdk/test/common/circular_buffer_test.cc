@@ -1,5 +1,6 @@
 #include "opentelemetry/sdk/common/circular_buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <random>
 #include <thread>
@@ -55,8 +56,11 @@ void RunNumberConsumer(CircularBuffer<uint32_t> &buffer,
 {
   while (true)
   {
+    // Read the exit flag first, so that numbers added before it was set are
+    // seen by the Peek.
+    bool done      = exit;
     auto allotment = buffer.Peek();
-    if (exit && allotment.empty())
+    if (done && allotment.empty())
     {
       return;
     }
@@ -0,0 +1,153 @@
+#include "src/common/epoch.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::common::Epoch;
+
+namespace
+{
+/**
+ * Counts the live instances, and checks they aren't used after deletion.
+ */
+class Counted
+{
+public:
+  explicit Counted(int value) noexcept : value_(value) { ++instances; }
+
+  ~Counted()
+  {
+    value_ = -1;
+    --instances;
+  }
+
+  int GetValue() const noexcept { return value_; }
+
+  static std::atomic<int> instances;
+
+private:
+  int value_;
+};
+
+std::atomic<int> Counted::instances{0};
+}  // namespace
+
+TEST(Epoch, RetireWithoutGuardDeletes)
+{
+  Epoch::Retire(new Counted(1));
+  EXPECT_EQ(0, Counted::instances);
+}
+
+TEST(Epoch, RetireWaitsForGuard)
+{
+  Counted *object = new Counted(1);
+  {
+    Epoch::Guard guard;
+    {
+      // Guards may be nested
+      Epoch::Guard nested_guard;
+    }
+    Epoch::Retire(object);
+    EXPECT_EQ(1, Counted::instances);
+    EXPECT_EQ(1, object->GetValue());
+  }
+
+  // Waiting objects are deleted when the last guard is left
+  EXPECT_EQ(0, Counted::instances);
+  EXPECT_EQ(0, Epoch::GetRetiredCount());
+}
+
+TEST(Epoch, RetireWaitsForGuardOfOtherThread)
+{
+  std::atomic<bool> entered{false};
+  std::atomic<bool> retired{false};
+  std::thread reader([&] {
+    Epoch::Guard guard;
+    entered = true;
+    while (!retired)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!entered)
+  {
+    std::this_thread::yield();
+  }
+
+  Epoch::Retire(new Counted(1));
+  EXPECT_EQ(1, Counted::instances);
+  retired = true;
+  reader.join();
+
+  // Deleted by the reader when it left its guard
+  EXPECT_EQ(0, Counted::instances);
+  EXPECT_EQ(0, Epoch::GetRetiredCount());
+}
+
+TEST(Epoch, SynchronizeWaitsForGuardOfOtherThread)
+{
+  std::atomic<bool> entered{false};
+  std::atomic<bool> left{false};
+  std::thread reader([&] {
+    {
+      Epoch::Guard guard;
+      entered = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      left = true;
+    }
+  });
+  while (!entered)
+  {
+    std::this_thread::yield();
+  }
+
+  Epoch::Synchronize();
+  EXPECT_TRUE(left);
+  reader.join();
+}
+
+TEST(Epoch, SynchronizeInGuard)
+{
+  {
+    Epoch::Guard guard;
+    Epoch::Retire(new Counted(1));
+    // Doesn't wait for the guard of the calling thread
+    Epoch::Synchronize();
+    EXPECT_EQ(1, Counted::instances);
+  }
+  EXPECT_EQ(0, Counted::instances);
+}
+
+TEST(Epoch, ConcurrentReadersAndWriter)
+{
+  std::atomic<const Counted *> current{new Counted(0)};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++)
+  {
+    readers.emplace_back([&] {
+      while (!done)
+      {
+        Epoch::Guard guard;
+        EXPECT_GE(current.load(std::memory_order_acquire)->GetValue(), 0);
+      }
+    });
+  }
+  for (int i = 1; i <= 10000; i++)
+  {
+    Epoch::Retire(current.exchange(new Counted(i), std::memory_order_release));
+  }
+  done = true;
+  for (auto &reader : readers)
+  {
+    reader.join();
+  }
+
+  Epoch::Retire(current.load());
+  EXPECT_EQ(0, Counted::instances);
+}
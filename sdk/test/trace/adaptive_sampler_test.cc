@@ -0,0 +1,102 @@
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
+#include "src/common/random.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+
+using opentelemetry::sdk::common::Random;
+using opentelemetry::sdk::trace::AdaptiveSampler;
+using opentelemetry::sdk::trace::Decision;
+
+namespace
+{
+/*
+ * Helper function returning whether the sampler samples a root span with a
+ * random trace id.
+ */
+bool IsSampled(AdaptiveSampler &sampler)
+{
+  using M = std::map<std::string, int>;
+  M m1    = {{}};
+  opentelemetry::trace::KeyValueIterableView<M> view{m1};
+
+  uint8_t buf[16] = {0};
+  Random::GenerateRandomBuffer(buf);
+  opentelemetry::trace::TraceId trace_id(buf);
+
+  auto result =
+      sampler.ShouldSample(nullptr, trace_id, "", opentelemetry::trace::SpanKind::kInternal, view);
+  return result.decision == Decision::RECORD_AND_SAMPLE;
+}
+
+/*
+ * Helper function returning the number of spans sampled out of spans started
+ * as fast as possible for the given duration.
+ */
+int CountSampledFor(AdaptiveSampler &sampler, std::chrono::milliseconds duration)
+{
+  int count = 0;
+  auto end  = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end)
+  {
+    count += IsSampled(sampler) ? 1 : 0;
+  }
+  return count;
+}
+}  // namespace
+
+TEST(AdaptiveSampler, SamplesEverythingAtFirst)
+{
+  AdaptiveSampler sampler(100);
+
+  ASSERT_EQ(1.0, sampler.GetProbability());
+  ASSERT_GT(CountSampledFor(sampler, std::chrono::milliseconds(10)), 100);
+}
+
+TEST(AdaptiveSampler, LowersProbabilityUnderLoad)
+{
+  AdaptiveSampler sampler(1000, std::chrono::milliseconds(10));
+
+  CountSampledFor(sampler, std::chrono::milliseconds(100));
+  double probability = sampler.GetProbability();
+  ASSERT_LT(probability, 0.5);
+  ASSERT_GT(probability, 0.0);
+
+  // Once adjusted, about the target rate is sampled
+  int sampled = CountSampledFor(sampler, std::chrono::milliseconds(200));
+  ASSERT_GT(sampled, 50);
+  ASSERT_LT(sampled, 1000);
+}
+
+TEST(AdaptiveSampler, KeepsProbabilityUnderLowTraffic)
+{
+  AdaptiveSampler sampler(100000, std::chrono::milliseconds(10));
+
+  for (int i = 0; i < 50; ++i)
+  {
+    ASSERT_TRUE(IsSampled(sampler));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1.0, sampler.GetProbability());
+}
+
+TEST(AdaptiveSampler, RespectsMinProbability)
+{
+  AdaptiveSampler sampler(1, std::chrono::milliseconds(10), 0.25);
+
+  CountSampledFor(sampler, std::chrono::milliseconds(50));
+  ASSERT_EQ(0.25, sampler.GetProbability());
+}
+
+TEST(AdaptiveSampler, GetDescription)
+{
+  AdaptiveSampler s1(100);
+  ASSERT_EQ("AdaptiveSampler{100.000000}", s1.GetDescription());
+
+  AdaptiveSampler s2(-3);
+  ASSERT_EQ("AdaptiveSampler{0.000000}", s2.GetDescription());
+}
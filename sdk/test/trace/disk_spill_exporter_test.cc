@@ -0,0 +1,236 @@
+#include "opentelemetry/sdk/trace/disk_spill_exporter.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+namespace nostd = opentelemetry::nostd;
+
+/**
+ * A stand-in for a remote exporter whose collector can be taken down. While
+ * down, every export fails.
+ */
+class FlakySpanExporter final : public SpanExporter
+{
+public:
+  FlakySpanExporter(std::shared_ptr<std::vector<std::string>> received,
+                    std::shared_ptr<std::atomic<bool>> is_down) noexcept
+      : received_(received), is_down_(is_down)
+  {}
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override
+  {
+    if (*is_down_)
+    {
+      return ExportResult::kFailure;
+    }
+    for (auto &recordable : spans)
+    {
+      auto span = static_cast<SpanData *>(recordable.get());
+      received_->push_back(std::string(span->GetName()));
+    }
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {}
+
+private:
+  std::shared_ptr<std::vector<std::string>> received_;
+  std::shared_ptr<std::atomic<bool>> is_down_;
+};
+
+class DiskSpillExporterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    char path[] = "/tmp/disk_spill_exporter_test.XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    directory_ = path;
+  }
+
+  void TearDown() override
+  {
+    for (auto &file : ListFiles())
+    {
+      unlink(file.c_str());
+    }
+    rmdir(directory_.c_str());
+  }
+
+  std::unique_ptr<DiskSpillExporter> MakeExporter(size_t max_disk_usage = 1024 * 1024,
+                                                  size_t segment_size   = 64 * 1024)
+  {
+    return std::unique_ptr<DiskSpillExporter>(new DiskSpillExporter(
+        std::unique_ptr<SpanExporter>(new FlakySpanExporter(received_, is_down_)), directory_,
+        max_disk_usage, segment_size));
+  }
+
+  ExportResult ExportBatch(SpanExporter &exporter, const std::string &prefix, int num_spans)
+  {
+    std::vector<std::unique_ptr<Recordable>> batch;
+    for (int i = 0; i < num_spans; ++i)
+    {
+      batch.push_back(exporter.MakeRecordable());
+      batch.back()->SetName(prefix + std::to_string(i));
+      batch.back()->SetAttribute("index", i);
+    }
+    return exporter.Export(nostd::span<std::unique_ptr<Recordable>>(batch.data(), batch.size()));
+  }
+
+  std::vector<std::string> ListFiles()
+  {
+    std::vector<std::string> files;
+    DIR *dir = opendir(directory_.c_str());
+    if (dir == nullptr)
+    {
+      return files;
+    }
+    while (auto entry = readdir(dir))
+    {
+      if (entry->d_name[0] != '.')
+      {
+        files.push_back(directory_ + "/" + entry->d_name);
+      }
+    }
+    closedir(dir);
+    return files;
+  }
+
+  std::string directory_;
+  std::shared_ptr<std::vector<std::string>> received_{new std::vector<std::string>};
+  std::shared_ptr<std::atomic<bool>> is_down_{new std::atomic<bool>(false)};
+};
+
+TEST_F(DiskSpillExporterTest, ForwardsWhileCollectorIsUp)
+{
+  auto exporter = MakeExporter();
+
+  EXPECT_EQ(ExportBatch(*exporter, "span", 3), ExportResult::kSuccess);
+
+  EXPECT_EQ(*received_, (std::vector<std::string>{"span0", "span1", "span2"}));
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 0);
+  EXPECT_EQ(exporter->GetDroppedBatchCount(), 0);
+}
+
+TEST_F(DiskSpillExporterTest, ReplaysAfterOutage)
+{
+  auto exporter = MakeExporter();
+
+  *is_down_ = true;
+  EXPECT_EQ(ExportBatch(*exporter, "a", 2), ExportResult::kSuccess);
+  EXPECT_EQ(ExportBatch(*exporter, "b", 2), ExportResult::kSuccess);
+  EXPECT_TRUE(received_->empty());
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 2);
+
+  *is_down_ = false;
+  EXPECT_EQ(ExportBatch(*exporter, "c", 1), ExportResult::kSuccess);
+
+  EXPECT_EQ(*received_, (std::vector<std::string>{"c0", "a0", "a1", "b0", "b1"}));
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 0);
+  EXPECT_EQ(exporter->GetDroppedBatchCount(), 0);
+}
+
+TEST_F(DiskSpillExporterTest, ReplaysOnEmptyExport)
+{
+  auto exporter = MakeExporter();
+
+  *is_down_ = true;
+  ExportBatch(*exporter, "a", 1);
+  *is_down_ = false;
+
+  // This is what a forced flush of an empty batch span processor does.
+  EXPECT_EQ(ExportBatch(*exporter, "unused", 0), ExportResult::kSuccess);
+  EXPECT_EQ(*received_, (std::vector<std::string>{"a0"}));
+}
+
+TEST_F(DiskSpillExporterTest, SurvivesRestart)
+{
+  {
+    auto exporter = MakeExporter();
+    *is_down_     = true;
+    ExportBatch(*exporter, "a", 3);
+    exporter->Shutdown();
+  }
+
+  *is_down_     = false;
+  auto exporter = MakeExporter();
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 1);
+  ExportBatch(*exporter, "b", 1);
+  EXPECT_EQ(*received_, (std::vector<std::string>{"b0", "a0", "a1", "a2"}));
+}
+
+TEST_F(DiskSpillExporterTest, EvictsOldestSegments)
+{
+  // Every batch gets a segment of its own, and only two segments fit.
+  auto exporter = MakeExporter(8 * 1024, 4 * 1024);
+
+  *is_down_ = true;
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(ExportBatch(*exporter, "batch" + std::to_string(i) + "-", 30),
+              ExportResult::kSuccess);
+  }
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 2);
+  EXPECT_EQ(exporter->GetDroppedBatchCount(), 3);
+  EXPECT_LE(ListFiles().size(), 2);
+
+  *is_down_ = false;
+  ExportBatch(*exporter, "unused", 0);
+  ASSERT_EQ(received_->size(), 60);
+  EXPECT_EQ(received_->front(), "batch3-0");
+  EXPECT_EQ(received_->back(), "batch4-29");
+}
+
+TEST_F(DiskSpillExporterTest, DiscardsCorruptedRecords)
+{
+  {
+    auto exporter = MakeExporter();
+    *is_down_     = true;
+    ExportBatch(*exporter, "a", 1);
+    exporter->Shutdown();
+  }
+
+  auto files = ListFiles();
+  ASSERT_EQ(files.size(), 1);
+  int fd = open(files[0].c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  // Flip a byte in the payload of the first record.
+  char byte;
+  ASSERT_EQ(pread(fd, &byte, 1, 64), 1);
+  byte = static_cast<char>(~byte);
+  ASSERT_EQ(pwrite(fd, &byte, 1, 64), 1);
+  close(fd);
+
+  *is_down_     = false;
+  auto exporter = MakeExporter();
+  EXPECT_EQ(exporter->GetSpilledBatchCount(), 0);
+  EXPECT_EQ(exporter->GetDroppedBatchCount(), 1);
+  ExportBatch(*exporter, "unused", 0);
+  EXPECT_TRUE(received_->empty());
+}
+
+TEST_F(DiskSpillExporterTest, DropsWhenDirectoryIsUnusable)
+{
+  directory_    = "/nonexistent/disk_spill_exporter_test";
+  auto exporter = MakeExporter();
+
+  *is_down_ = true;
+  EXPECT_EQ(ExportBatch(*exporter, "a", 1), ExportResult::kFailure);
+  EXPECT_EQ(exporter->GetDroppedBatchCount(), 1);
+}
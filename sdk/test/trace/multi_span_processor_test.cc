@@ -0,0 +1,149 @@
+#include "opentelemetry/sdk/trace/multi_span_processor.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/simple_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+using opentelemetry::trace::CanonicalCode;
+
+/**
+ * A mock exporter that keeps the spans it receives.
+ */
+class MockSpanExporter final : public SpanExporter
+{
+public:
+  MockSpanExporter(std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received,
+                   std::shared_ptr<bool> shutdown_called) noexcept
+      : spans_received_(spans_received), shutdown_called_(shutdown_called)
+  {}
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(
+      const opentelemetry::nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override
+  {
+    for (auto &span : spans)
+    {
+      spans_received_->emplace_back(static_cast<SpanData *>(span.release()));
+    }
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {
+    *shutdown_called_ = true;
+  }
+
+private:
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received_;
+  std::shared_ptr<bool> shutdown_called_;
+};
+
+/**
+ * A mock processor that checks it receives the recordables it made.
+ */
+class MockSpanProcessor final : public SpanProcessor
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    if (!make_recordables)
+      return nullptr;
+    auto recordable = std::unique_ptr<Recordable>(new SpanData);
+    made.push_back(recordable.get());
+    return recordable;
+  }
+
+  void OnStart(Recordable &span) noexcept override { started.push_back(&span); }
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    ended.push_back(span.get());
+  }
+
+  void ForceFlush(std::chrono::microseconds timeout) noexcept override { ++force_flush_calls; }
+
+  void Shutdown(std::chrono::microseconds timeout) noexcept override { ++shutdown_calls; }
+
+  bool make_recordables = true;
+  std::vector<Recordable *> made, started, ended;
+  int force_flush_calls = 0;
+  int shutdown_calls    = 0;
+};
+
+TEST(MultiSpanProcessor, ExportsToEveryProcessor)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans1(
+      new std::vector<std::unique_ptr<SpanData>>),
+      spans2(new std::vector<std::unique_ptr<SpanData>>);
+  std::shared_ptr<bool> shutdown1(new bool(false)), shutdown2(new bool(false));
+  auto processor = std::make_shared<MultiSpanProcessor>(std::vector<std::shared_ptr<SpanProcessor>>{
+      std::make_shared<SimpleSpanProcessor>(
+          std::unique_ptr<SpanExporter>(new MockSpanExporter(spans1, shutdown1))),
+      std::make_shared<SimpleSpanProcessor>(
+          std::unique_ptr<SpanExporter>(new MockSpanExporter(spans2, shutdown2)))});
+  auto tracer = std::shared_ptr<opentelemetry::trace::Tracer>(
+      new Tracer(processor, std::make_shared<AlwaysOnSampler>()));
+
+  auto span = tracer->StartSpan("span", {{"attr1", 314159}});
+  span->SetAttribute("attr2", "value");
+  span->SetStatus(CanonicalCode::UNAVAILABLE, "description");
+  span->End();
+
+  for (auto spans : {spans1, spans2})
+  {
+    ASSERT_EQ(1, spans->size());
+    auto &span_data = spans->at(0);
+    ASSERT_EQ("span", span_data->GetName());
+    ASSERT_EQ(314159, opentelemetry::nostd::get<int64_t>(span_data->GetAttributes().at("attr1")));
+    ASSERT_EQ("value",
+              opentelemetry::nostd::get<std::string>(span_data->GetAttributes().at("attr2")));
+    ASSERT_EQ(CanonicalCode::UNAVAILABLE, span_data->GetStatus());
+    ASSERT_TRUE(span_data->GetTraceId().IsValid());
+  }
+  ASSERT_EQ(spans1->at(0)->GetSpanId(), spans2->at(0)->GetSpanId());
+
+  processor->Shutdown();
+  ASSERT_TRUE(*shutdown1);
+  ASSERT_TRUE(*shutdown2);
+}
+
+TEST(MultiSpanProcessor, PassesOwnRecordables)
+{
+  auto processor1 = std::make_shared<MockSpanProcessor>();
+  auto processor2 = std::make_shared<MockSpanProcessor>();
+  auto processor3 = std::make_shared<MockSpanProcessor>();
+  processor2->make_recordables = false;
+  MultiSpanProcessor processor({processor1, processor2, processor3});
+
+  auto recordable = processor.MakeRecordable();
+  processor.OnStart(*recordable);
+  processor.OnEnd(std::move(recordable));
+
+  for (auto &mock : {processor1, processor3})
+  {
+    ASSERT_EQ(1, mock->made.size());
+    ASSERT_EQ(mock->made, mock->started);
+    ASSERT_EQ(mock->made, mock->ended);
+  }
+  ASSERT_NE(processor1->made, processor3->made);
+  // A processor returning no recordable doesn't see the span
+  ASSERT_TRUE(processor2->started.empty());
+  ASSERT_TRUE(processor2->ended.empty());
+
+  processor.ForceFlush();
+  processor.Shutdown();
+  for (auto &mock : {processor1, processor2, processor3})
+  {
+    ASSERT_EQ(1, mock->force_flush_calls);
+    ASSERT_EQ(1, mock->shutdown_calls);
+  }
+}
@@ -218,3 +218,25 @@ TEST(ProbabilitySampler, GetDescription)
   ProbabilitySampler s9(0.50);
   ASSERT_EQ("ProbabilitySampler{0.500000}", s9.GetDescription());
 }
+
+TEST(ProbabilitySampler, SetProbability)
+{
+  int iterations = 100000, variance = iterations * 0.01;
+
+  SpanContext c(true, true);
+  ProbabilitySampler s(1.0);
+
+  s.SetProbability(0.0);
+  ASSERT_EQ(0, RunShouldSampleCountDecision(c, s, iterations));
+
+  s.SetProbability(0.5);
+  int actual_count = RunShouldSampleCountDecision(c, s, iterations);
+  ASSERT_TRUE(actual_count < (iterations / 2 + variance));
+  ASSERT_TRUE(actual_count > (iterations / 2 - variance));
+
+  s.SetProbability(3.0);
+  ASSERT_EQ(iterations, RunShouldSampleCountDecision(c, s, iterations));
+
+  // The description keeps the probability the sampler was constructed with
+  ASSERT_EQ("ProbabilitySampler{1.000000}", s.GetDescription());
+}
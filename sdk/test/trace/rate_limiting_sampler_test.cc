@@ -0,0 +1,109 @@
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+#include "opentelemetry/sdk/trace/samplers/parent_or_else.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using opentelemetry::sdk::trace::Decision;
+using opentelemetry::sdk::trace::ParentOrElseSampler;
+using opentelemetry::sdk::trace::RateLimitingSampler;
+using opentelemetry::sdk::trace::Sampler;
+using opentelemetry::trace::SpanContext;
+
+namespace
+{
+/*
+ * Helper function returning the number of RECORD_AND_SAMPLE decisions of the
+ * sampler for a number of root spans.
+ */
+int CountSampled(Sampler &sampler, int iterations, const SpanContext *parent_context = nullptr)
+{
+  using M = std::map<std::string, int>;
+  M m1    = {{}};
+  opentelemetry::trace::KeyValueIterableView<M> view{m1};
+
+  int count = 0;
+  for (int i = 0; i < iterations; ++i)
+  {
+    auto result = sampler.ShouldSample(parent_context, opentelemetry::trace::TraceId(), "",
+                                       opentelemetry::trace::SpanKind::kInternal, view);
+    if (result.decision == Decision::RECORD_AND_SAMPLE)
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+}  // namespace
+
+TEST(RateLimitingSampler, SamplesBurstThenRate)
+{
+  RateLimitingSampler sampler(10);
+
+  // A second worth of samples is available right away
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(10, CountSampled(sampler, 1000));
+  ASSERT_EQ(0, CountSampled(sampler, 1000));
+
+  // Samples become available again at the given rate
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  int sampled = CountSampled(sampler, 1000);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  ASSERT_GE(sampled, 2);
+  ASSERT_LE(sampled, 1 + static_cast<int>(elapsed.count() / 100));
+}
+
+TEST(RateLimitingSampler, ZeroAndUnlimitedRates)
+{
+  RateLimitingSampler none(0);
+  RateLimitingSampler negative(-5);
+  RateLimitingSampler unlimited(1e12);
+
+  ASSERT_EQ(0, CountSampled(none, 100));
+  ASSERT_EQ(0, CountSampled(negative, 100));
+  ASSERT_EQ(100, CountSampled(unlimited, 100));
+}
+
+TEST(RateLimitingSampler, LimitsAcrossThreads)
+{
+  RateLimitingSampler sampler(100);
+  std::atomic<int> sampled{0};
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&] { sampled += CountSampled(sampler, 20000); });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  ASSERT_GE(sampled.load(), 100);
+  ASSERT_LE(sampled.load(), 100 + 1 + static_cast<int>(elapsed.count() / 10));
+}
+
+TEST(RateLimitingSampler, ComposesWithParentOrElse)
+{
+  ParentOrElseSampler sampler(std::make_shared<RateLimitingSampler>(1));
+
+  // Children follow their sampled parent without using up the rate
+  SpanContext sampled_parent(true, false);
+  ASSERT_EQ(100, CountSampled(sampler, 100, &sampled_parent));
+  ASSERT_EQ(1, CountSampled(sampler, 100));
+}
+
+TEST(RateLimitingSampler, GetDescription)
+{
+  RateLimitingSampler sampler(100);
+  ASSERT_EQ("RateLimitingSampler{100.000000}", sampler.GetDescription());
+}
@@ -0,0 +1,161 @@
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
+#include "opentelemetry/sdk/trace/samplers/always_off.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using opentelemetry::sdk::trace::AlwaysOffSampler;
+using opentelemetry::sdk::trace::AlwaysOnSampler;
+using opentelemetry::sdk::trace::Decision;
+using opentelemetry::sdk::trace::RuleBasedSampler;
+using opentelemetry::sdk::trace::SamplingRule;
+using opentelemetry::trace::SpanKind;
+using Attributes = std::map<std::string, opentelemetry::common::AttributeValue>;
+
+namespace
+{
+SamplingRule MakeRule(std::string name, bool sampled)
+{
+  SamplingRule rule;
+  rule.name = std::move(name);
+  if (sampled)
+    rule.sampler = std::make_shared<AlwaysOnSampler>();
+  else
+    rule.sampler = std::make_shared<AlwaysOffSampler>();
+  return rule;
+}
+
+/*
+ * Helper function returning whether the sampler samples a root span.
+ */
+bool IsSampled(RuleBasedSampler &sampler,
+               opentelemetry::nostd::string_view name,
+               SpanKind span_kind           = SpanKind::kInternal,
+               const Attributes &attributes = {})
+{
+  opentelemetry::trace::KeyValueIterableView<Attributes> view{attributes};
+  auto result =
+      sampler.ShouldSample(nullptr, opentelemetry::trace::TraceId(), name, span_kind, view);
+  return result.decision == Decision::RECORD_AND_SAMPLE;
+}
+}  // namespace
+
+TEST(RuleBasedSampler, MatchesExactAndPrefixNames)
+{
+  RuleBasedSampler sampler({MakeRule("/health", false), MakeRule("/checkout*", true)},
+                           std::make_shared<AlwaysOffSampler>());
+
+  ASSERT_TRUE(IsSampled(sampler, "/checkout"));
+  ASSERT_TRUE(IsSampled(sampler, "/checkout/confirm"));
+  ASSERT_FALSE(IsSampled(sampler, "/check"));
+  ASSERT_FALSE(IsSampled(sampler, "/health"));
+  ASSERT_FALSE(IsSampled(sampler, ""));
+
+  RuleBasedSampler health_sampler({MakeRule("/health", false)},
+                                  std::make_shared<AlwaysOnSampler>());
+  ASSERT_FALSE(IsSampled(health_sampler, "/health"));
+  ASSERT_TRUE(IsSampled(health_sampler, "/healthz"));
+  ASSERT_TRUE(IsSampled(health_sampler, "/heal"));
+}
+
+TEST(RuleBasedSampler, FirstMatchingRuleWins)
+{
+  RuleBasedSampler prefix_first({MakeRule("/api/*", false), MakeRule("/api/checkout", true)},
+                                std::make_shared<AlwaysOnSampler>());
+  ASSERT_FALSE(IsSampled(prefix_first, "/api/checkout"));
+
+  RuleBasedSampler exact_first({MakeRule("/api/checkout", true), MakeRule("/api/*", false)},
+                               std::make_shared<AlwaysOnSampler>());
+  ASSERT_TRUE(IsSampled(exact_first, "/api/checkout"));
+  ASSERT_FALSE(IsSampled(exact_first, "/api/cart"));
+
+  RuleBasedSampler catch_all({MakeRule("*", false), MakeRule("/api/checkout", true)},
+                             std::make_shared<AlwaysOnSampler>());
+  ASSERT_FALSE(IsSampled(catch_all, "/api/checkout"));
+  ASSERT_FALSE(IsSampled(catch_all, ""));
+}
+
+TEST(RuleBasedSampler, MatchesSpanKinds)
+{
+  SamplingRule rule = MakeRule("*", true);
+  rule.span_kinds   = {SpanKind::kServer, SpanKind::kConsumer};
+  RuleBasedSampler sampler({rule}, std::make_shared<AlwaysOffSampler>());
+
+  ASSERT_TRUE(IsSampled(sampler, "span", SpanKind::kServer));
+  ASSERT_TRUE(IsSampled(sampler, "span", SpanKind::kConsumer));
+  ASSERT_FALSE(IsSampled(sampler, "span", SpanKind::kClient));
+}
+
+TEST(RuleBasedSampler, MatchesAttributes)
+{
+  SamplingRule rule = MakeRule("GET*", true);
+  rule.attributes   = {{"http.route", std::string("/checkout")}, {"http.status", int64_t{200}}};
+  RuleBasedSampler sampler({rule}, std::make_shared<AlwaysOffSampler>());
+
+  ASSERT_TRUE(IsSampled(sampler, "GET /checkout", SpanKind::kServer,
+                        {{"http.route", "/checkout"}, {"http.status", 200}, {"other", true}}));
+  // Integers compare equal whatever their type
+  ASSERT_TRUE(IsSampled(sampler, "GET", SpanKind::kServer,
+                        {{"http.route", "/checkout"}, {"http.status", uint64_t{200}}}));
+  ASSERT_FALSE(IsSampled(sampler, "GET", SpanKind::kServer,
+                         {{"http.route", "/checkout"}, {"http.status", 404}}));
+  ASSERT_FALSE(IsSampled(sampler, "GET", SpanKind::kServer,
+                         {{"http.route", "/checkout"}, {"http.status", "200"}}));
+  ASSERT_FALSE(IsSampled(sampler, "GET", SpanKind::kServer, {{"http.route", "/checkout"}}));
+  ASSERT_FALSE(IsSampled(sampler, "POST", SpanKind::kServer,
+                         {{"http.route", "/checkout"}, {"http.status", 200}}));
+}
+
+TEST(RuleBasedSampler, MatchesManyRules)
+{
+  // Names sharing long prefixes, which the trie merges into single edges
+  std::vector<SamplingRule> rules;
+  for (int i = 0; i < 100; ++i)
+  {
+    rules.push_back(MakeRule("/api/v1/resource" + std::to_string(i), i % 2 == 0));
+  }
+  rules.push_back(MakeRule("/api/v1/res*", true));
+  RuleBasedSampler sampler(rules, std::make_shared<AlwaysOffSampler>());
+
+  for (int i = 0; i < 100; ++i)
+  {
+    ASSERT_EQ(i % 2 == 0, IsSampled(sampler, "/api/v1/resource" + std::to_string(i)));
+  }
+  ASSERT_TRUE(IsSampled(sampler, "/api/v1/resource100"));
+  ASSERT_TRUE(IsSampled(sampler, "/api/v1/res"));
+  ASSERT_FALSE(IsSampled(sampler, "/api/v1/re"));
+  ASSERT_FALSE(IsSampled(sampler, "/api/v1/rex"));
+}
+
+TEST(RuleBasedSampler, MatchesAmongManyAttributes)
+{
+  SamplingRule rule = MakeRule("*", true);
+  rule.attributes   = {{"key19", std::string("value19")}};
+  RuleBasedSampler sampler({rule}, std::make_shared<AlwaysOffSampler>());
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < 20; ++i)
+  {
+    keys.push_back("key" + std::to_string(i));
+  }
+  Attributes attributes;
+  for (int i = 0; i < 20; ++i)
+  {
+    attributes[keys[i]] = "value";
+  }
+  ASSERT_FALSE(IsSampled(sampler, "span", SpanKind::kInternal, attributes));
+  attributes[keys[19]] = "value19";
+  ASSERT_TRUE(IsSampled(sampler, "span", SpanKind::kInternal, attributes));
+}
+
+TEST(RuleBasedSampler, GetDescription)
+{
+  RuleBasedSampler sampler({MakeRule("/health", false), MakeRule("/checkout*", true)},
+                           std::make_shared<AlwaysOnSampler>());
+  ASSERT_EQ("RuleBasedSampler{rules=2,default=AlwaysOnSampler}", sampler.GetDescription());
+}
@@ -1,13 +1,18 @@
 #include "opentelemetry/sdk/trace/sampler.h"
+#include "opentelemetry/sdk/trace/samplers/adaptive.h"
 #include "opentelemetry/sdk/trace/samplers/always_off.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/sdk/trace/samplers/parent_or_else.h"
 #include "opentelemetry/sdk/trace/samplers/probability.h"
+#include "opentelemetry/sdk/trace/samplers/rate_limiting.h"
+#include "opentelemetry/sdk/trace/samplers/rule_based.h"
 #include "opentelemetry/sdk/trace/simple_processor.h"
 #include "opentelemetry/sdk/trace/span_data.h"
 #include "opentelemetry/sdk/trace/tracer.h"
 
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 
 #include <benchmark/benchmark.h>
 
@@ -142,6 +147,172 @@ void BM_ProbabilitySamplerShouldSample(benchmark::State &state)
 }
 BENCHMARK(BM_ProbabilitySamplerShouldSample);
 
+// Test to measure performance for rate limiting sampler. The rate is exceeded
+// right away, as it is under heavy traffic.
+void BM_RateLimitingSamplerShouldSample(benchmark::State &state)
+{
+  RateLimitingSampler sampler(100);
+
+  BenchmarkShouldSampler(sampler, state);
+}
+BENCHMARK(BM_RateLimitingSamplerShouldSample);
+
+// Test to measure performance for rate limiting sampler shared by threads,
+// with a rate that keeps them competing for samples
+void BM_RateLimitingSamplerShouldSampleContended(benchmark::State &state)
+{
+  static RateLimitingSampler sampler(1e7);
+
+  BenchmarkShouldSampler(sampler, state);
+}
+BENCHMARK(BM_RateLimitingSamplerShouldSampleContended)->ThreadRange(1, 8);
+
+// Helper to measure the decision latency of a rule based sampler with 200
+// rules: 120 exact names, 60 name prefixes, and 20 rules also matching span
+// kinds and attributes, deciding for a span with the given name
+void BenchmarkRuleBasedSampler(nostd::string_view name, benchmark::State &state)
+{
+  auto sampler = std::make_shared<ProbabilitySampler>(0.5);
+  std::vector<SamplingRule> rules;
+  for (int i = 0; i < 120; ++i)
+  {
+    SamplingRule rule;
+    rule.name    = "/api/v1/resource" + std::to_string(i);
+    rule.sampler = sampler;
+    rules.push_back(rule);
+  }
+  for (int i = 0; i < 60; ++i)
+  {
+    SamplingRule rule;
+    rule.name    = "/static/bundle" + std::to_string(i) + "/*";
+    rule.sampler = sampler;
+    rules.push_back(rule);
+  }
+  for (int i = 0; i < 20; ++i)
+  {
+    SamplingRule rule;
+    rule.name       = "GET *";
+    rule.span_kinds = {opentelemetry::trace::SpanKind::kServer};
+    rule.attributes = {{"http.route", "/route" + std::to_string(i)}};
+    rule.sampler    = sampler;
+    rules.push_back(rule);
+  }
+  RuleBasedSampler rule_based_sampler(rules, std::make_shared<AlwaysOffSampler>());
+
+  opentelemetry::trace::TraceId trace_id;
+  using M = std::map<std::string, opentelemetry::common::AttributeValue>;
+  M m1    = {{"http.method", "GET"}, {"http.route", "/route19"}};
+  opentelemetry::trace::KeyValueIterableView<M> view{m1};
+
+  while (state.KeepRunning())
+  {
+    benchmark::DoNotOptimize(rule_based_sampler.ShouldSample(
+        nullptr, trace_id, name, opentelemetry::trace::SpanKind::kServer, view));
+  }
+}
+
+void BM_RuleBasedSamplerExactName(benchmark::State &state)
+{
+  BenchmarkRuleBasedSampler("/api/v1/resource119", state);
+}
+BENCHMARK(BM_RuleBasedSamplerExactName);
+
+void BM_RuleBasedSamplerNamePrefix(benchmark::State &state)
+{
+  BenchmarkRuleBasedSampler("/static/bundle59/app.js", state);
+}
+BENCHMARK(BM_RuleBasedSamplerNamePrefix);
+
+// The span matches the last rule, after its name matched the 19 rules before
+void BM_RuleBasedSamplerAttributes(benchmark::State &state)
+{
+  BenchmarkRuleBasedSampler("GET /route19", state);
+}
+BENCHMARK(BM_RuleBasedSamplerAttributes);
+
+void BM_RuleBasedSamplerNoMatch(benchmark::State &state)
+{
+  BenchmarkRuleBasedSampler("/api/v2/resource1", state);
+}
+BENCHMARK(BM_RuleBasedSamplerNoMatch);
+
+// Test to measure performance for adaptive sampler, which mostly costs an
+// atomic increment on top of the probability sampler
+void BM_AdaptiveSamplerShouldSample(benchmark::State &state)
+{
+  AdaptiveSampler sampler(100);
+
+  BenchmarkShouldSampler(sampler, state);
+}
+BENCHMARK(BM_AdaptiveSamplerShouldSample);
+
+// Simulation of the adaptive sampler under bursty traffic. Every iteration
+// replays a burst, where spans are started as fast as possible, followed by a
+// quiet phase of 10000 spans/s. The sampler targets 100000 spans/s and adjusts
+// every 10ms; the counters report the rate of recorded spans in each phase.
+void BM_AdaptiveSamplerBurstyTraffic(benchmark::State &state)
+{
+  using clock = std::chrono::steady_clock;
+  const auto phase_duration = std::chrono::milliseconds(50);
+  const auto quiet_interval = std::chrono::microseconds(100);
+
+  AdaptiveSampler sampler(100000, std::chrono::milliseconds(10));
+  opentelemetry::trace::SpanKind span_kind = opentelemetry::trace::SpanKind::kInternal;
+  using M = std::map<std::string, int>;
+  M m1    = {{}};
+  opentelemetry::trace::KeyValueIterableView<M> view{m1};
+
+  // Cheap pseudo random trace ids, so that the probability applies
+  uint64_t seed = 88172645463325252ull;
+  auto sample   = [&]() {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    uint8_t buf[opentelemetry::trace::TraceId::kSize] = {0};
+    std::memcpy(buf, &seed, sizeof(seed));
+    opentelemetry::trace::TraceId trace_id(buf);
+    return sampler.ShouldSample(nullptr, trace_id, "", span_kind, view).decision ==
+           Decision::RECORD_AND_SAMPLE;
+  };
+
+  int64_t arrivals = 0, burst_recorded = 0, quiet_recorded = 0;
+  clock::duration burst_time{}, quiet_time{};
+  while (state.KeepRunning())
+  {
+    auto start = clock::now();
+    auto end   = start + phase_duration;
+    for (auto now = start; now < end; now = clock::now())
+    {
+      for (int i = 0; i < 64; ++i, ++arrivals)
+      {
+        burst_recorded += sample() ? 1 : 0;
+      }
+    }
+    burst_time += clock::now() - start;
+
+    start = clock::now();
+    end   = start + phase_duration;
+    for (auto next = start; next < end; next += quiet_interval, ++arrivals)
+    {
+      while (clock::now() < next)
+      {
+      }
+      quiet_recorded += sample() ? 1 : 0;
+    }
+    quiet_time += clock::now() - start;
+  }
+
+  using seconds = std::chrono::duration<double>;
+  double total  = std::chrono::duration_cast<seconds>(burst_time + quiet_time).count();
+  state.counters["arrivals_per_s"] = arrivals / total;
+  state.counters["recorded_per_s"] = (burst_recorded + quiet_recorded) / total;
+  state.counters["burst_recorded_per_s"] =
+      burst_recorded / std::chrono::duration_cast<seconds>(burst_time).count();
+  state.counters["quiet_recorded_per_s"] =
+      quiet_recorded / std::chrono::duration_cast<seconds>(quiet_time).count();
+}
+BENCHMARK(BM_AdaptiveSamplerBurstyTraffic)->Unit(benchmark::kMillisecond)->UseRealTime();
+
 // Sampler Helper Function
 void BenchmarkSpanCreation(std::shared_ptr<Sampler> sampler, benchmark::State &state)
 {
@@ -176,5 +347,62 @@ void BM_NoopSpanCreation(benchmark::State &state)
 }
 BENCHMARK(BM_NoopSpanCreation);
 
+// Helper to measure the end-to-end cost of spans that the sampler drops, as
+// instrumented code creates them
+void BenchmarkUnsampledSpans(std::shared_ptr<Sampler> sampler,
+                             bool check_recording,
+                             benchmark::State &state)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(spans_received));
+  auto processor = std::make_shared<SimpleSpanProcessor>(std::move(exporter));
+  auto tracer    = std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(processor, sampler));
+
+  std::string url = "https://example.com/api/v1/items?page=2";
+  while (state.KeepRunning())
+  {
+    auto parent = tracer->StartSpan("request", {{"http.method", "GET"}, {"http.url", url}});
+    auto scope  = tracer->WithActiveSpan(*parent);
+    auto child  = tracer->StartSpan("query");
+    // Attributes that are expensive to compute are skipped when the span isn't
+    // recorded
+    if (!check_recording || child->IsRecording())
+    {
+      child->SetAttribute("db.statement", "SELECT * FROM items WHERE page = " + url.substr(36));
+      child->SetAttribute("db.rows", 20);
+    }
+    child->End();
+    parent->End();
+  }
+  spans_received->clear();
+}
+
+// The cost of an unsampled request with a child span
+void BM_UnsampledSpans(benchmark::State &state)
+{
+  BenchmarkUnsampledSpans(std::make_shared<AlwaysOffSampler>(), false, state);
+}
+BENCHMARK(BM_UnsampledSpans);
+
+// The cost of an unsampled request with a child span, when instrumentation
+// checks IsRecording() before computing attributes
+void BM_UnsampledSpansCheckingIsRecording(benchmark::State &state)
+{
+  BenchmarkUnsampledSpans(std::make_shared<AlwaysOffSampler>(), true, state);
+}
+BENCHMARK(BM_UnsampledSpansCheckingIsRecording);
+
+// The average cost of a request with a child span when 1% of the traces are
+// sampled
+void BM_SampledOnePercentSpans(benchmark::State &state)
+{
+  BenchmarkUnsampledSpans(
+      std::make_shared<ParentOrElseSampler>(std::make_shared<ProbabilitySampler>(0.01)), true,
+      state);
+}
+BENCHMARK(BM_SampledOnePercentSpans);
+
 }  // namespace
 BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+#include "opentelemetry/sdk/trace/span_data_serializer.h"
+#include "opentelemetry/nostd/variant.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+
+#include <gtest/gtest.h>
+
+using opentelemetry::sdk::trace::Recordable;
+using opentelemetry::sdk::trace::SpanData;
+using opentelemetry::sdk::trace::SpanDataSerializer;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+void PopulateSpan(SpanData &span)
+{
+  constexpr uint8_t trace_id_buf[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  constexpr uint8_t span_id_buf[]  = {1, 2, 3, 4, 5, 6, 7, 8};
+  constexpr uint8_t parent_buf[]   = {8, 7, 6, 5, 4, 3, 2, 1};
+  span.SetIds(opentelemetry::trace::TraceId{trace_id_buf},
+              opentelemetry::trace::SpanId{span_id_buf},
+              opentelemetry::trace::SpanId{parent_buf});
+  span.SetName("span name");
+  span.SetStatus(opentelemetry::trace::CanonicalCode::UNAVAILABLE, "collector down");
+  span.SetStartTime(opentelemetry::core::SystemTimestamp(std::chrono::nanoseconds(123456789)));
+  span.SetDuration(std::chrono::nanoseconds(1000));
+
+  bool bools[]                 = {true, false, true};
+  int64_t ints[]               = {-1, 0, 1};
+  double doubles[]             = {0.5, 1.5};
+  nostd::string_view strings[] = {"a", "bc"};
+  span.SetAttribute("bool", true);
+  span.SetAttribute("int", 42);
+  span.SetAttribute("uint", static_cast<uint64_t>(7));
+  span.SetAttribute("double", 3.25);
+  span.SetAttribute("string", "value");
+  span.SetAttribute("bools", nostd::span<const bool>{bools});
+  span.SetAttribute("ints", nostd::span<const int64_t>{ints});
+  span.SetAttribute("doubles", nostd::span<const double>{doubles});
+  span.SetAttribute("strings", nostd::span<const nostd::string_view>{strings});
+  static_cast<Recordable &>(span).AddEvent(
+      "event", opentelemetry::core::SystemTimestamp(std::chrono::nanoseconds(5)));
+}
+}  // namespace
+
+TEST(SpanDataSerializer, RoundTrip)
+{
+  SpanData original;
+  PopulateSpan(original);
+
+  std::string buffer;
+  SpanDataSerializer::Serialize(original, buffer);
+
+  SpanData decoded;
+  ASSERT_TRUE(SpanDataSerializer::Deserialize(buffer, decoded));
+
+  EXPECT_EQ(decoded.GetTraceId(), original.GetTraceId());
+  EXPECT_EQ(decoded.GetSpanId(), original.GetSpanId());
+  EXPECT_EQ(decoded.GetParentSpanId(), original.GetParentSpanId());
+  EXPECT_EQ(decoded.GetName(), "span name");
+  EXPECT_EQ(decoded.GetStatus(), opentelemetry::trace::CanonicalCode::UNAVAILABLE);
+  EXPECT_EQ(decoded.GetDescription(), "collector down");
+  EXPECT_EQ(decoded.GetStartTime(), original.GetStartTime());
+  EXPECT_EQ(decoded.GetDuration(), original.GetDuration());
+  EXPECT_EQ(decoded.GetAttributes().size(), original.GetAttributes().size());
+  for (auto &kv : original.GetAttributes())
+  {
+    auto it = decoded.GetAttributes().find(kv.first);
+    ASSERT_NE(it, decoded.GetAttributes().end()) << kv.first;
+    EXPECT_EQ(it->second, kv.second) << kv.first;
+  }
+  ASSERT_EQ(decoded.GetEvents().size(), 1);
+  EXPECT_EQ(decoded.GetEvents()[0].GetName(), "event");
+  EXPECT_EQ(decoded.GetEvents()[0].GetTimestamp().time_since_epoch().count(), 5);
+}
+
+TEST(SpanDataSerializer, CopyTo)
+{
+  SpanData original;
+  PopulateSpan(original);
+
+  SpanData copy;
+  SpanDataSerializer::CopyTo(original, copy);
+
+  EXPECT_EQ(copy.GetTraceId(), original.GetTraceId());
+  EXPECT_EQ(copy.GetName(), original.GetName());
+  EXPECT_EQ(copy.GetAttributes(), original.GetAttributes());
+  EXPECT_EQ(copy.GetEvents().size(), original.GetEvents().size());
+}
+
+TEST(SpanDataSerializer, RejectsTruncatedInput)
+{
+  SpanData original;
+  PopulateSpan(original);
+
+  std::string buffer;
+  SpanDataSerializer::Serialize(original, buffer);
+
+  for (size_t size = 0; size < buffer.size(); ++size)
+  {
+    SpanData decoded;
+    EXPECT_FALSE(SpanDataSerializer::Deserialize(nostd::string_view{buffer.data(), size}, decoded));
+  }
+}
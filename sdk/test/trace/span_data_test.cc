@@ -53,3 +53,44 @@ TEST(SpanData, Set)
   ASSERT_EQ(data.GetEvents().at(0).GetName(), "event1");
   ASSERT_EQ(data.GetEvents().at(0).GetTimestamp(), now);
 }
+
+TEST(SpanData, SetAttributeWithKey)
+{
+  static const opentelemetry::common::AttributeKey<int64_t> kCount{"span_data.count"};
+  static const opentelemetry::common::AttributeKey<opentelemetry::nostd::string_view> kName{
+      "span_data.name"};
+
+  SpanData data;
+  opentelemetry::sdk::trace::Recordable &recordable = data;
+  recordable.SetAttribute("span_data.count", 1);
+  recordable.SetAttribute(kCount, 0, static_cast<int64_t>(2));
+  recordable.SetAttribute(kName, 1, opentelemetry::nostd::string_view("first"));
+  ASSERT_EQ(opentelemetry::nostd::get<std::string>(data.GetAttributes().at("span_data.name")),
+            "first");
+  recordable.SetAttribute("span_data.name", opentelemetry::nostd::string_view("second"));
+  recordable.SetAttribute(kName, 1, opentelemetry::nostd::string_view("third"));
+  recordable.SetAttribute("other", true);
+  recordable.SetAttribute(kCount, 1000, static_cast<int64_t>(3));
+
+  // Attributes set through a key are listed by name, and the last write wins
+  ASSERT_EQ(data.GetAttributes().size(), 3);
+  ASSERT_EQ(opentelemetry::nostd::get<int64_t>(data.GetAttributes().at("span_data.count")), 3);
+  ASSERT_EQ(opentelemetry::nostd::get<std::string>(data.GetAttributes().at("span_data.name")),
+            "third");
+  ASSERT_EQ(opentelemetry::nostd::get<bool>(data.GetAttributes().at("other")), true);
+}
+
+TEST(SpanData, CopyWithKeyedAttributes)
+{
+  static const opentelemetry::common::AttributeKey<int64_t> kCount{"span_data.count"};
+
+  SpanData data;
+  data.SetAttribute(kCount, 0, static_cast<int64_t>(1));
+  SpanData copy(data);
+  copy.SetAttribute(kCount, 0, static_cast<int64_t>(2));
+  data = copy;
+  copy.SetAttribute(kCount, 0, static_cast<int64_t>(3));
+
+  ASSERT_EQ(opentelemetry::nostd::get<int64_t>(data.GetAttributes().at("span_data.count")), 2);
+  ASSERT_EQ(opentelemetry::nostd::get<int64_t>(copy.GetAttributes().at("span_data.count")), 3);
+}
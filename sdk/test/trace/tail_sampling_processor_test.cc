@@ -0,0 +1,284 @@
+#include "opentelemetry/sdk/trace/tail_sampling_processor.h"
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+using opentelemetry::trace::CanonicalCode;
+using opentelemetry::trace::SpanId;
+using opentelemetry::trace::TraceId;
+
+/**
+ * An exporter keeping the spans it receives in memory.
+ */
+class InMemorySpanExporter final : public SpanExporter
+{
+public:
+  struct Data
+  {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<SpanData>> spans;
+    bool is_shutdown = false;
+
+    size_t Size()
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      return spans.size();
+    }
+  };
+
+  explicit InMemorySpanExporter(std::shared_ptr<Data> data) noexcept : data_(data) {}
+
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(
+      const opentelemetry::nostd::span<std::unique_ptr<Recordable>> &spans) noexcept override
+  {
+    std::lock_guard<std::mutex> guard(data_->mutex);
+    for (auto &span : spans)
+    {
+      data_->spans.emplace_back(static_cast<SpanData *>(span.release()));
+    }
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override
+  {
+    std::lock_guard<std::mutex> guard(data_->mutex);
+    data_->is_shutdown = true;
+  }
+
+private:
+  std::shared_ptr<Data> data_;
+};
+
+namespace
+{
+TraceId MakeTraceId(uint8_t n)
+{
+  uint8_t buf[TraceId::kSize] = {n, n, n, n, n, n, n, n, n, n, n, n, n, n, n, n};
+  return TraceId(buf);
+}
+
+/*
+ * Helper function ending a span of the trace, recorded as the Tracer would.
+ */
+void EndSpan(TailSamplingProcessor &processor,
+             uint8_t trace,
+             CanonicalCode status               = CanonicalCode::OK,
+             std::chrono::milliseconds duration = std::chrono::milliseconds(1))
+{
+  auto recordable = processor.MakeRecordable();
+  recordable->SetIds(MakeTraceId(trace), SpanId(), SpanId());
+  recordable->SetName("span");
+  recordable->SetAttribute("trace", static_cast<int>(trace));
+  recordable->SetStatus(status, "");
+  recordable->SetDuration(duration);
+  processor.OnEnd(std::move(recordable));
+}
+}  // namespace
+
+TEST(TailSamplingProcessor, KeepsTracesWithErrors)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(
+      std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)), TailSamplingPolicy{});
+
+  EndSpan(processor, 1);
+  EndSpan(processor, 2);
+  EndSpan(processor, 1, CanonicalCode::INTERNAL);
+  EndSpan(processor, 2);
+
+  auto stats = processor.GetStats();
+  ASSERT_EQ(4, stats.buffered_spans);
+  ASSERT_EQ(2, stats.buffered_traces);
+  ASSERT_EQ(0, data->Size());
+
+  processor.ForceFlush();
+  ASSERT_EQ(2, data->Size());
+  for (auto &span : data->spans)
+  {
+    ASSERT_EQ(MakeTraceId(1), span->GetTraceId());
+  }
+  stats = processor.GetStats();
+  ASSERT_EQ(0, stats.buffered_spans);
+  ASSERT_EQ(1, stats.kept_traces);
+  ASSERT_EQ(1, stats.dropped_traces);
+}
+
+TEST(TailSamplingProcessor, KeepsSlowTraces)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingPolicy policy;
+  policy.latency_threshold = std::chrono::milliseconds(100);
+  policy.keep_errors       = false;
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  policy);
+
+  EndSpan(processor, 1, CanonicalCode::INTERNAL, std::chrono::milliseconds(10));
+  EndSpan(processor, 2, CanonicalCode::OK, std::chrono::milliseconds(10));
+  EndSpan(processor, 2, CanonicalCode::OK, std::chrono::milliseconds(100));
+
+  processor.ForceFlush();
+  ASSERT_EQ(2, data->Size());
+  for (auto &span : data->spans)
+  {
+    ASSERT_EQ(MakeTraceId(2), span->GetTraceId());
+  }
+}
+
+TEST(TailSamplingProcessor, KeepsTracesWithAttribute)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingPolicy policy;
+  policy.attributes = {{"trace", int64_t{3}}};
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  policy);
+
+  EndSpan(processor, 2);
+  EndSpan(processor, 3);
+
+  processor.ForceFlush();
+  ASSERT_EQ(1, data->Size());
+  ASSERT_EQ(MakeTraceId(3), data->spans[0]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, DecidesWhenWindowCloses)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  TailSamplingPolicy{}, std::chrono::milliseconds(50));
+
+  EndSpan(processor, 1, CanonicalCode::INTERNAL);
+  EndSpan(processor, 2);
+  ASSERT_EQ(0, data->Size());
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (processor.GetStats().buffered_traces > 0 && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(1, data->Size());
+  ASSERT_EQ(1, processor.GetStats().dropped_traces);
+
+  // Spans of decided traces follow their decision
+  EndSpan(processor, 1);
+  EndSpan(processor, 2, CanonicalCode::INTERNAL);
+  auto stats = processor.GetStats();
+  ASSERT_EQ(0, stats.buffered_traces);
+  ASSERT_EQ(2, stats.late_spans);
+  ASSERT_EQ(2, data->Size());
+  ASSERT_EQ(MakeTraceId(1), data->spans[1]->GetTraceId());
+}
+
+TEST(TailSamplingProcessor, ForgetsLeastRecentlyUsedDecisions)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  TailSamplingPolicy{}, std::chrono::milliseconds(5000), 100, 2);
+
+  EndSpan(processor, 1, CanonicalCode::INTERNAL);
+  EndSpan(processor, 2);
+  processor.ForceFlush();
+  ASSERT_EQ(1, data->Size());
+
+  // Using the decision of trace 1 makes the decision of trace 2 the one to
+  // forget when trace 3 is decided.
+  EndSpan(processor, 1);
+  ASSERT_EQ(2, data->Size());
+  EndSpan(processor, 3);
+  processor.ForceFlush();
+
+  EndSpan(processor, 1);
+  EndSpan(processor, 2);
+  auto stats = processor.GetStats();
+  ASSERT_EQ(3, data->Size());
+  ASSERT_EQ(2, stats.late_spans);
+  ASSERT_EQ(1, stats.buffered_traces);
+}
+
+TEST(TailSamplingProcessor, IgnoresOtherRecordables)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  TailSamplingPolicy{});
+
+  processor.OnEnd(std::unique_ptr<Recordable>(new SpanData));
+  processor.ForceFlush();
+  ASSERT_EQ(0, processor.GetStats().buffered_spans);
+  ASSERT_EQ(0, data->Size());
+}
+
+TEST(TailSamplingProcessor, EvictsOldestTraces)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  TailSamplingPolicy{}, std::chrono::milliseconds(5000), 4);
+
+  EndSpan(processor, 1, CanonicalCode::INTERNAL);
+  EndSpan(processor, 1);
+  EndSpan(processor, 2);
+  EndSpan(processor, 2);
+  ASSERT_EQ(0, data->Size());
+
+  // The oldest trace is decided with the spans it has
+  EndSpan(processor, 3);
+  auto stats = processor.GetStats();
+  ASSERT_EQ(3, stats.buffered_spans);
+  ASSERT_EQ(2, stats.buffered_traces);
+  ASSERT_EQ(1, stats.evicted_traces);
+  ASSERT_EQ(2, data->Size());
+
+  EndSpan(processor, 3);
+  EndSpan(processor, 4);
+  stats = processor.GetStats();
+  ASSERT_EQ(3, stats.buffered_spans);
+  ASSERT_EQ(2, stats.evicted_traces);
+  ASSERT_EQ(1, stats.dropped_traces);
+}
+
+TEST(TailSamplingProcessor, ShutdownExportsBufferedTraces)
+{
+  auto data = std::make_shared<InMemorySpanExporter::Data>();
+  TailSamplingProcessor processor(std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)),
+                                  TailSamplingPolicy{});
+
+  EndSpan(processor, 1, CanonicalCode::INTERNAL);
+  processor.Shutdown();
+  ASSERT_EQ(1, data->Size());
+  ASSERT_TRUE(data->is_shutdown);
+
+  // Spans ending after shutdown are ignored
+  EndSpan(processor, 2, CanonicalCode::INTERNAL);
+  processor.ForceFlush();
+  ASSERT_EQ(1, data->Size());
+}
+
+TEST(TailSamplingProcessor, RecordsSpansOfTracer)
+{
+  auto data      = std::make_shared<InMemorySpanExporter::Data>();
+  auto processor = std::make_shared<TailSamplingProcessor>(
+      std::unique_ptr<SpanExporter>(new InMemorySpanExporter(data)), TailSamplingPolicy{});
+  auto tracer = std::shared_ptr<opentelemetry::trace::Tracer>(
+      new Tracer(processor, std::make_shared<AlwaysOnSampler>()));
+
+  auto failed = tracer->StartSpan("failed");
+  failed->SetStatus(CanonicalCode::UNAVAILABLE, "");
+  failed->End();
+  tracer->StartSpan("ok")->End();
+
+  processor->ForceFlush();
+  ASSERT_EQ(1, data->Size());
+  ASSERT_EQ("failed", data->spans[0]->GetName());
+  ASSERT_EQ(CanonicalCode::UNAVAILABLE, data->spans[0]->GetStatus());
+}
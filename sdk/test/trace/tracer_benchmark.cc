@@ -0,0 +1,184 @@
+#include "opentelemetry/sdk/trace/samplers/always_on.h"
+#include "opentelemetry/sdk/trace/simple_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
+#include "opentelemetry/sdk/trace/tracer.h"
+#include "opentelemetry/sdk/trace/tracer_provider.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+using namespace opentelemetry::sdk::trace;
+namespace nostd = opentelemetry::nostd;
+
+namespace
+{
+/**
+ * An exporter that discards the spans it receives.
+ */
+class DiscardingSpanExporter final : public SpanExporter
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  ExportResult Export(const nostd::span<std::unique_ptr<Recordable>> & /*spans*/) noexcept override
+  {
+    return ExportResult::kSuccess;
+  }
+
+  void Shutdown(std::chrono::microseconds /*timeout*/) noexcept override {}
+};
+
+std::shared_ptr<opentelemetry::trace::Tracer> MakeTracer()
+{
+  std::unique_ptr<SpanExporter> exporter(new DiscardingSpanExporter);
+  auto processor = std::make_shared<SimpleSpanProcessor>(std::move(exporter));
+  return std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(processor));
+}
+
+// Starts a span, makes it active and recurses until the given depth is reached.
+void StartNestedSpans(opentelemetry::trace::Tracer &tracer, int64_t depth)
+{
+  auto span  = tracer.StartSpan("span");
+  auto scope = tracer.WithActiveSpan(*span);
+  if (depth > 1)
+  {
+    StartNestedSpans(tracer, depth - 1);
+  }
+  span->End();
+}
+
+// Measures starting, activating and ending chains of nested spans, where each
+// span is a child of the previous one.
+void BM_NestedSpanChain(benchmark::State &state)
+{
+  auto tracer = MakeTracer();
+  for (auto _ : state)
+  {
+    StartNestedSpans(*tracer, state.range(0));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NestedSpanChain)->RangeMultiplier(4)->Range(1, 64);
+
+// Measures looking up the context of the active span.
+void BM_GetCurrentSpanContext(benchmark::State &state)
+{
+  auto tracer = MakeTracer();
+  auto span   = tracer->StartSpan("span");
+  auto scope  = tracer->WithActiveSpan(*span);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(tracer->GetCurrentSpanContext());
+  }
+}
+BENCHMARK(BM_GetCurrentSpanContext);
+
+// Measures recording a span with four attributes set by name.
+void BM_SetAttributesByName(benchmark::State &state)
+{
+  auto tracer = MakeTracer();
+  for (auto _ : state)
+  {
+    auto span = tracer->StartSpan("span");
+    span->SetAttribute("http.method", "GET");
+    span->SetAttribute("http.status_code", 200);
+    span->SetAttribute("http.request_content_length", 512);
+    span->SetAttribute("http.response_content_length", 2048);
+    span->End();
+  }
+}
+BENCHMARK(BM_SetAttributesByName);
+
+// Measures recording a span with the same attributes set through registered
+// keys.
+void BM_SetAttributesWithKeys(benchmark::State &state)
+{
+  static const opentelemetry::common::AttributeKey<nostd::string_view> kMethod{"http.method"};
+  static const opentelemetry::common::AttributeKey<int64_t> kStatusCode{"http.status_code"};
+  static const opentelemetry::common::AttributeKey<int64_t> kRequestLength{
+      "http.request_content_length"};
+  static const opentelemetry::common::AttributeKey<int64_t> kResponseLength{
+      "http.response_content_length"};
+
+  auto tracer = MakeTracer();
+  for (auto _ : state)
+  {
+    auto span = tracer->StartSpan("span");
+    span->SetAttribute(kMethod, "GET");
+    span->SetAttribute(kStatusCode, 200);
+    span->SetAttribute(kRequestLength, 512);
+    span->SetAttribute(kResponseLength, 2048);
+    span->End();
+  }
+}
+BENCHMARK(BM_SetAttributesWithKeys);
+
+// Measures starting and ending spans from concurrent threads, while the first
+// thread replaces the sampler every range(0) spans, or never if it is zero.
+void BM_StartSpanWithConfigSwaps(benchmark::State &state)
+{
+  static auto tracer = MakeTracer();
+  auto sdk_tracer    = static_cast<Tracer *>(tracer.get());
+  auto swap_interval = state.range(0);
+  bool swaps         = state.thread_index() == 0 && swap_interval > 0;
+  int64_t until_swap = swap_interval;
+  for (auto _ : state)
+  {
+    tracer->StartSpan("span")->End();
+    if (swaps && --until_swap == 0)
+    {
+      sdk_tracer->SetSampler(std::make_shared<AlwaysOnSampler>());
+      until_swap = swap_interval;
+    }
+  }
+}
+BENCHMARK(BM_StartSpanWithConfigSwaps)->Arg(0)->Arg(16)->Arg(1024)->ThreadRange(1, 8);
+
+const int kLibraryCount = 20;
+
+std::vector<std::string> MakeLibraryNames()
+{
+  std::vector<std::string> names;
+  for (int i = 0; i < kLibraryCount; ++i)
+  {
+    names.push_back("io.opentelemetry.contrib.library" + std::to_string(i));
+  }
+  return names;
+}
+
+// Returns a provider shared by the benchmark threads, with a tracer for each
+// library already registered.
+TracerProvider &GetTracerProvider()
+{
+  static TracerProvider *provider = [] {
+    std::unique_ptr<SpanExporter> exporter(new DiscardingSpanExporter);
+    auto provider = new TracerProvider(std::make_shared<SimpleSpanProcessor>(std::move(exporter)));
+    for (auto &name : MakeLibraryNames())
+    {
+      provider->GetTracer(name, "1.0.0");
+    }
+    return provider;
+  }();
+  return *provider;
+}
+
+// Measures looking up the tracer of a library, as instrumentation does on
+// every request, from concurrent threads.
+void BM_GetTracer(benchmark::State &state)
+{
+  auto &provider = GetTracerProvider();
+  auto names     = MakeLibraryNames();
+  size_t i       = state.thread_index();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(provider.GetTracer(names[i++ % names.size()], "1.0.0"));
+  }
+}
+BENCHMARK(BM_GetTracer)->ThreadRange(1, 8);
+}  // namespace
+BENCHMARK_MAIN();
@@ -2,12 +2,38 @@
 #include "opentelemetry/sdk/trace/samplers/always_off.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/sdk/trace/simple_processor.h"
+#include "opentelemetry/sdk/trace/span_data.h"
 #include "opentelemetry/sdk/trace/tracer.h"
 
 #include <gtest/gtest.h>
 
 using namespace opentelemetry::sdk::trace;
 
+/**
+ * A processor keeping the spans that ended.
+ */
+class RecordingSpanProcessor final : public SpanProcessor
+{
+public:
+  std::unique_ptr<Recordable> MakeRecordable() noexcept override
+  {
+    return std::unique_ptr<Recordable>(new SpanData);
+  }
+
+  void OnStart(Recordable & /*span*/) noexcept override {}
+
+  void OnEnd(std::unique_ptr<Recordable> &&span) noexcept override
+  {
+    spans.emplace_back(static_cast<SpanData *>(span.release()));
+  }
+
+  void ForceFlush(std::chrono::microseconds /*timeout*/) noexcept override {}
+
+  void Shutdown(std::chrono::microseconds /*timeout*/) noexcept override {}
+
+  std::vector<std::unique_ptr<SpanData>> spans;
+};
+
 TEST(TracerProvider, GetTracer)
 {
   std::shared_ptr<SpanProcessor> processor(new SimpleSpanProcessor(nullptr));
@@ -16,19 +42,32 @@ TEST(TracerProvider, GetTracer)
   auto t1 = tp1.GetTracer("test");
   auto t2 = tp1.GetTracer("test");
   auto t3 = tp1.GetTracer("different", "1.0.0");
+  auto t4 = tp1.GetTracer("different", "2.0.0");
+  auto t5 = tp1.GetTracer("different", "1.0.0");
   ASSERT_NE(nullptr, t1);
   ASSERT_NE(nullptr, t2);
   ASSERT_NE(nullptr, t3);
+  ASSERT_NE(nullptr, t4);
 
-  // Should return the same instance each time.
+  // Should return the same instance for the same library.
   ASSERT_EQ(t1, t2);
-  ASSERT_EQ(t1, t3);
+  ASSERT_EQ(t3, t5);
+
+  // Should return a different instance for each library and version.
+  ASSERT_NE(t1, t3);
+  ASSERT_NE(t3, t4);
 
   // Should be an sdk::trace::Tracer with the processor attached.
   auto sdkTracer1 = dynamic_cast<Tracer *>(t1.get());
   ASSERT_NE(nullptr, sdkTracer1);
   ASSERT_EQ(processor, sdkTracer1->GetProcessor());
   ASSERT_EQ("AlwaysOnSampler", sdkTracer1->GetSampler()->GetDescription());
+  ASSERT_EQ("test", sdkTracer1->GetInstrumentationLibrary()->name);
+  ASSERT_EQ("", sdkTracer1->GetInstrumentationLibrary()->version);
+
+  auto sdkTracer4 = dynamic_cast<Tracer *>(t4.get());
+  ASSERT_EQ("different", sdkTracer4->GetInstrumentationLibrary()->name);
+  ASSERT_EQ("2.0.0", sdkTracer4->GetInstrumentationLibrary()->version);
 
   TracerProvider tp2(processor, std::make_shared<AlwaysOffSampler>());
   auto sdkTracer2 = dynamic_cast<Tracer *>(tp2.GetTracer("test").get());
@@ -59,3 +98,39 @@ TEST(TracerProvider, GetSampler)
 
   ASSERT_EQ("AlwaysOffSampler", t3->GetDescription());
 }
+
+TEST(TracerProvider, SetProcessor)
+{
+  std::shared_ptr<SpanProcessor> processor1(new SimpleSpanProcessor(nullptr));
+  TracerProvider tp(processor1);
+  auto t1 = tp.GetTracer("first");
+  auto t2 = tp.GetTracer("second");
+
+  // Should pass the new processor to the existing and the new tracers.
+  std::shared_ptr<SpanProcessor> processor2(new SimpleSpanProcessor(nullptr));
+  tp.SetProcessor(processor2);
+  auto t3 = tp.GetTracer("third");
+
+  ASSERT_EQ(processor2, tp.GetProcessor());
+  ASSERT_EQ(processor2, dynamic_cast<Tracer *>(t1.get())->GetProcessor());
+  ASSERT_EQ(processor2, dynamic_cast<Tracer *>(t2.get())->GetProcessor());
+  ASSERT_EQ(processor2, dynamic_cast<Tracer *>(t3.get())->GetProcessor());
+}
+
+TEST(TracerProvider, RecordsInstrumentationLibrary)
+{
+  std::shared_ptr<RecordingSpanProcessor> processor(new RecordingSpanProcessor);
+  {
+    TracerProvider tp(processor);
+    tp.GetTracer("first", "1.0.0")->StartSpan("span1")->End();
+    tp.GetTracer("second")->StartSpan("span2")->End();
+  }
+
+  // Should tell which library started each exported span, after the provider
+  // and its tracers are gone.
+  ASSERT_EQ(2, processor->spans.size());
+  ASSERT_EQ("first", processor->spans[0]->GetInstrumentationLibrary()->name);
+  ASSERT_EQ("1.0.0", processor->spans[0]->GetInstrumentationLibrary()->version);
+  ASSERT_EQ("second", processor->spans[1]->GetInstrumentationLibrary()->name);
+  ASSERT_EQ("", processor->spans[1]->GetInstrumentationLibrary()->version);
+}
@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace opentelemetry::sdk::trace;
 using opentelemetry::core::SteadyTimestamp;
 using opentelemetry::core::SystemTimestamp;
@@ -90,6 +93,16 @@ std::shared_ptr<opentelemetry::trace::Tracer> initTracer(
   auto processor = std::make_shared<SimpleSpanProcessor>(std::move(exporter));
   return std::shared_ptr<opentelemetry::trace::Tracer>(new Tracer(processor, sampler));
 }
+
+std::shared_ptr<opentelemetry::trace::Tracer> initTracer(
+    std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> &received,
+    SpanLimits span_limits)
+{
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(received));
+  auto processor = std::make_shared<SimpleSpanProcessor>(std::move(exporter));
+  return std::shared_ptr<opentelemetry::trace::Tracer>(
+      new Tracer(processor, std::make_shared<AlwaysOnSampler>(), {}, span_limits));
+}
 }  // namespace
 
 TEST(Tracer, ToMockSpanExporter)
@@ -379,3 +392,379 @@ TEST(Tracer, TestParentOrElseSampler)
   span_parent_off_2->End();
   ASSERT_EQ(0, spans_received_parent_off->size());
 }
+
+TEST(Tracer, StartSpanWithActiveParent)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received);
+
+  auto root = tracer->StartSpan("root");
+  {
+    auto root_scope = tracer->WithActiveSpan(*root);
+    auto child      = tracer->StartSpan("child");
+    {
+      auto child_scope = tracer->WithActiveSpan(*child);
+      tracer->StartSpan("grandchild")->End();
+    }
+    child->End();
+  }
+  root->End();
+  tracer->StartSpan("other root")->End();
+
+  ASSERT_EQ(4, spans_received->size());
+  auto &grandchild = spans_received->at(0);
+  auto &child      = spans_received->at(1);
+  auto &root_data  = spans_received->at(2);
+  auto &other_root = spans_received->at(3);
+
+  EXPECT_TRUE(root_data->GetTraceId().IsValid());
+  EXPECT_FALSE(root_data->GetParentSpanId().IsValid());
+  EXPECT_EQ(child->GetTraceId(), root_data->GetTraceId());
+  EXPECT_EQ(child->GetParentSpanId(), root_data->GetSpanId());
+  EXPECT_EQ(grandchild->GetTraceId(), root_data->GetTraceId());
+  EXPECT_EQ(grandchild->GetParentSpanId(), child->GetSpanId());
+  EXPECT_NE(other_root->GetTraceId(), root_data->GetTraceId());
+  EXPECT_FALSE(other_root->GetParentSpanId().IsValid());
+}
+
+TEST(Tracer, StartSpanInContextOfDestroyedParent)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer = initTracer(spans_received);
+
+  // A context copied while the parent was active is used after the parent
+  // ended and was destroyed, e.g. by work handed to another thread.
+  opentelemetry::context::Context copied;
+  {
+    auto root  = tracer->StartSpan("root");
+    auto scope = tracer->WithActiveSpan(*root);
+    copied     = opentelemetry::context::RuntimeContext::GetCurrent();
+    root->End();
+  }
+  {
+    auto token = opentelemetry::context::RuntimeContext::Attach(copied);
+    tracer->StartSpan("child")->End();
+  }
+
+  ASSERT_EQ(2, spans_received->size());
+  auto &root_data = spans_received->at(0);
+  auto &child     = spans_received->at(1);
+  EXPECT_EQ(child->GetTraceId(), root_data->GetTraceId());
+  EXPECT_EQ(child->GetParentSpanId(), root_data->GetSpanId());
+}
+
+TEST(Tracer, StartSpanWithUnsampledParent)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer_off = initTracer(spans_received, std::make_shared<AlwaysOffSampler>());
+  auto tracer_parent_or_else =
+      initTracer(spans_received,
+                 std::make_shared<ParentOrElseSampler>(std::make_shared<AlwaysOnSampler>()));
+
+  // The children of a span that isn't recorded follow its sampling decision.
+  auto root = tracer_off->StartSpan("root");
+  EXPECT_TRUE(root->GetContext().IsValid());
+  {
+    auto scope = tracer_off->WithActiveSpan(*root);
+    tracer_parent_or_else->StartSpan("child")->End();
+  }
+  root->End();
+
+  ASSERT_EQ(0, spans_received->size());
+}
+
+TEST(Tracer, UnsampledSpansFreedOnOtherThread)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer_off = initTracer(spans_received, std::make_shared<AlwaysOffSampler>());
+
+  // Unsampled spans may be started on one thread and destroyed on another.
+  std::vector<nostd::unique_ptr<opentelemetry::trace::Span>> spans;
+  for (int i = 0; i < 100; i++)
+  {
+    spans.push_back(tracer_off->StartSpan("span"));
+    EXPECT_FALSE(spans.back()->IsRecording());
+    EXPECT_EQ(&spans.back()->tracer(), tracer_off.get());
+  }
+  EXPECT_NE(spans[0]->GetContext().span_id(), spans[1]->GetContext().span_id());
+  std::thread([&spans] { spans.clear(); }).join();
+
+  for (int i = 0; i < 100; i++)
+  {
+    auto span = tracer_off->StartSpan("span");
+    EXPECT_TRUE(span->GetContext().IsValid());
+  }
+  ASSERT_EQ(0, spans_received->size());
+}
+
+TEST(Tracer, UnsampledSpansFreedWhileThreadExits)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer_off = initTracer(spans_received, std::make_shared<AlwaysOffSampler>());
+
+  // The thread local holding the spans is created before the pool of the
+  // thread, so it frees them after the pool was released.
+  std::thread([&tracer_off] {
+    static thread_local std::vector<nostd::unique_ptr<opentelemetry::trace::Span>> spans;
+    for (int i = 0; i < 10; i++)
+    {
+      spans.push_back(tracer_off->StartSpan("span"));
+    }
+    tracer_off->StartSpan("span").reset();
+  }).join();
+  ASSERT_EQ(0, spans_received->size());
+}
+
+TEST(Tracer, UnsampledSpanKeepsTracerAlive)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer_off = initTracer(spans_received, std::make_shared<AlwaysOffSampler>());
+  std::weak_ptr<opentelemetry::trace::Tracer> weak_tracer = tracer_off;
+
+  auto span = tracer_off->StartSpan("span");
+  tracer_off.reset();
+  EXPECT_FALSE(weak_tracer.expired());
+  EXPECT_FALSE(span->tracer().StartSpan("child")->IsRecording());
+
+  span.reset();
+  EXPECT_TRUE(weak_tracer.expired());
+}
+
+TEST(Tracer, SetSampler)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer    = initTracer(spans_received);
+  auto sdkTracer = static_cast<Tracer *>(tracer.get());
+
+  // Spans started after the sampler is set are sampled by it.
+  tracer->StartSpan("span 1")->End();
+  sdkTracer->SetSampler(std::make_shared<AlwaysOffSampler>());
+  ASSERT_EQ("AlwaysOffSampler", sdkTracer->GetSampler()->GetDescription());
+  tracer->StartSpan("span 2")->End();
+  sdkTracer->SetSampler(std::make_shared<AlwaysOnSampler>());
+  tracer->StartSpan("span 3")->End();
+
+  ASSERT_EQ(2, spans_received->size());
+  ASSERT_EQ("span 1", spans_received->at(0)->GetName());
+  ASSERT_EQ("span 3", spans_received->at(1)->GetName());
+}
+
+TEST(Tracer, SetProcessorKeepsProcessorOfStartedSpans)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received_1(
+      new std::vector<std::unique_ptr<SpanData>>);
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received_2(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer    = initTracer(spans_received_1);
+  auto sdkTracer = static_cast<Tracer *>(tracer.get());
+
+  auto span_1 = tracer->StartSpan("span 1");
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(spans_received_2));
+  sdkTracer->SetProcessor(std::make_shared<SimpleSpanProcessor>(std::move(exporter)));
+  auto span_2 = tracer->StartSpan("span 2");
+  span_1->End();
+  span_2->End();
+
+  ASSERT_EQ(1, spans_received_1->size());
+  ASSERT_EQ("span 1", spans_received_1->at(0)->GetName());
+  ASSERT_EQ(1, spans_received_2->size());
+  ASSERT_EQ("span 2", spans_received_2->at(0)->GetName());
+}
+
+TEST(Tracer, SetSamplerWhileStartingSpans)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto tracer    = initTracer(spans_received, std::make_shared<AlwaysOffSampler>());
+  auto sdkTracer = static_cast<Tracer *>(tracer.get());
+
+  // Starts spans on several threads while the sampler keeps being replaced,
+  // none of them being recorded.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++)
+  {
+    threads.emplace_back([&tracer] {
+      for (int j = 0; j < 10000; j++)
+      {
+        EXPECT_FALSE(tracer->StartSpan("span")->IsRecording());
+      }
+    });
+  }
+  for (int i = 0; i < 1000; i++)
+  {
+    sdkTracer->SetSampler(std::make_shared<AlwaysOffSampler>());
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  ASSERT_EQ(0, spans_received->size());
+}
+
+namespace
+{
+/**
+ * A sampler that waits in ShouldSample until it is released.
+ */
+class BlockingSampler final : public Sampler
+{
+public:
+  SamplingResult ShouldSample(const trace_api::SpanContext * /*parent_context*/,
+                              trace_api::TraceId /*trace_id*/,
+                              nostd::string_view /*name*/,
+                              trace_api::SpanKind /*span_kind*/,
+                              const trace_api::KeyValueIterable & /*attributes*/) noexcept override
+  {
+    sampling = true;
+    while (!released)
+    {
+      std::this_thread::yield();
+    }
+    return {Decision::NOT_RECORD, nullptr};
+  }
+
+  nostd::string_view GetDescription() const noexcept override { return "BlockingSampler"; }
+
+  std::atomic<bool> sampling{false};
+  std::atomic<bool> released{false};
+};
+}  // namespace
+
+TEST(Tracer, SetSamplerWhileSamplingDeletesOldConfig)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  auto sampler   = std::make_shared<BlockingSampler>();
+  auto tracer    = initTracer(spans_received, sampler);
+  auto sdkTracer = static_cast<Tracer *>(tracer.get());
+
+  std::thread thread([&tracer] { tracer->StartSpan("span"); });
+  while (!sampler->sampling)
+  {
+    std::this_thread::yield();
+  }
+  sdkTracer->SetSampler(std::make_shared<AlwaysOffSampler>());
+  std::weak_ptr<Sampler> replaced = sampler;
+  sampler->released               = true;
+  sampler.reset();
+  thread.join();
+
+  // The old config, and the sampler it held, are deleted once the span that
+  // started with them no longer reads them
+  ASSERT_TRUE(replaced.expired());
+}
+
+TEST(Tracer, SpanLimitsDropAttributes)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  SpanLimits limits;
+  limits.max_attributes = 2;
+  auto tracer = initTracer(spans_received, limits);
+
+  std::map<std::string, int> attributes = {{"attr1", 1}};
+  auto span                             = tracer->StartSpan("span", attributes);
+  span->SetAttribute("attr2", 2);
+  span->SetAttribute("attr3", 3);
+  // Updating a recorded attribute doesn't count against the limit.
+  span->SetAttribute("attr1", 4);
+  span->SetAttribute("attr4", 5);
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_EQ(2, span_data->GetAttributes().size());
+  ASSERT_EQ(4, nostd::get<int64_t>(span_data->GetAttributes().at("attr1")));
+  ASSERT_EQ(2, nostd::get<int64_t>(span_data->GetAttributes().at("attr2")));
+  ASSERT_EQ(2, span_data->GetDroppedAttributesCount());
+  ASSERT_EQ(0, span_data->GetDroppedEventsCount());
+}
+
+TEST(Tracer, SpanLimitsTruncateValues)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  SpanLimits limits;
+  limits.max_attribute_value_length = 4;
+  limits.max_attribute_array_length = 2;
+  auto tracer = initTracer(spans_received, limits);
+
+  int64_t numbers[]            = {1, 2, 3};
+  nostd::string_view strings[] = {"a", "bcdefg", "h"};
+  auto span                    = tracer->StartSpan("span");
+  span->SetAttribute("short", "abcd");
+  span->SetAttribute("long", "abcdefg");
+  // "\xc3\xa9" is a 2 byte character, which isn't split.
+  span->SetAttribute("utf8", "abc\xc3\xa9");
+  span->SetAttribute("numbers", nostd::span<const int64_t>(numbers));
+  span->SetAttribute("strings", nostd::span<const nostd::string_view>(strings));
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &attributes = spans_received->at(0)->GetAttributes();
+  ASSERT_EQ("abcd", nostd::get<std::string>(attributes.at("short")));
+  ASSERT_EQ("abcd", nostd::get<std::string>(attributes.at("long")));
+  ASSERT_EQ("abc", nostd::get<std::string>(attributes.at("utf8")));
+  ASSERT_EQ(std::vector<int64_t>({1, 2}),
+            nostd::get<std::vector<int64_t>>(attributes.at("numbers")));
+  ASSERT_EQ(std::vector<std::string>({"a", "bcde"}),
+            nostd::get<std::vector<std::string>>(attributes.at("strings")));
+  ASSERT_EQ(0, spans_received->at(0)->GetDroppedAttributesCount());
+}
+
+TEST(Tracer, SpanLimitsDropEvents)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  SpanLimits limits;
+  limits.max_events = 2;
+  auto tracer = initTracer(spans_received, limits);
+
+  auto span = tracer->StartSpan("span");
+  span->AddEvent("event 1");
+  span->AddEvent("event 2");
+  span->AddEvent("event 3");
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_EQ(2, span_data->GetEvents().size());
+  ASSERT_EQ("event 1", span_data->GetEvents().at(0).GetName());
+  ASSERT_EQ("event 2", span_data->GetEvents().at(1).GetName());
+  ASSERT_EQ(1, span_data->GetDroppedEventsCount());
+  ASSERT_EQ(0, span_data->GetDroppedAttributesCount());
+}
+
+TEST(Tracer, SpanSetAttributeWithKey)
+{
+  static const opentelemetry::common::AttributeKey<int64_t> kStatusCode{"http.status_code"};
+  static const opentelemetry::common::AttributeKey<nostd::string_view> kMethod{"http.method"};
+
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  SpanLimits limits;
+  limits.max_attributes             = 2;
+  limits.max_attribute_value_length = 3;
+  auto tracer                       = initTracer(spans_received, limits);
+
+  auto span = tracer->StartSpan("span 1");
+  span->SetAttribute(kStatusCode, 200);
+  span->SetAttribute(kMethod, "POST");
+  span->SetAttribute(kStatusCode, 404);
+  span->SetAttribute("dropped", 1);
+  span->End();
+
+  ASSERT_EQ(1, spans_received->size());
+  auto &span_data = spans_received->at(0);
+  ASSERT_EQ(2, span_data->GetAttributes().size());
+  ASSERT_EQ(404, nostd::get<int64_t>(span_data->GetAttributes().at("http.status_code")));
+  ASSERT_EQ("POS", nostd::get<std::string>(span_data->GetAttributes().at("http.method")));
+  ASSERT_EQ(1, span_data->GetDroppedAttributesCount());
+}